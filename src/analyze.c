@@ -3,6 +3,14 @@
 #include <string.h>
 
 #include "analyze.h"
+#include "fold.h"
+#include "simd.h"
+#include "arena.h"
+#include "pool.h"
+#include "atomic.h"
+#include "layout.h"
+#include "generic.h"
+#include "interface.h"
 #include "err.h"
 
 static void analyzeExpr(Analyzer *analyzer, AstExpr *expr);
@@ -38,11 +46,13 @@ void freeAnalyzer(Analyzer *analyzer) {
     free(analyzer->table.scopes);
 }
 
-Analyzer newAnalyzer(Parser *parser) {
+Analyzer newAnalyzer(Parser *parser, bool isLibrary, bool isNoAlias) {
     Analyzer analyzer;
 
     analyzer.parser = parser;
     analyzer.hadErr = false;
+    analyzer.isLibrary = isLibrary;
+    analyzer.isNoAlias = isNoAlias;
 
     analyzer.table.scopes = malloc(sizeof(Scope));
     analyzer.table.depth = 0;
@@ -73,6 +83,48 @@ static void raiseEntryPointCannotBeInline(Analyzer *analyzer) {
     );
 }
 
+static void raiseConflictingTags(Analyzer *analyzer, char *name, char *first, char *second) {
+    compileErrFromAnalyzer(analyzer, 
+        "function '%s' cannot be tagged both '@%s' and '@%s'\n", name, first, second
+    );
+}
+
+static void raiseVoidFunctionCannotBePure(Analyzer *analyzer, char *name, char *tag) {
+    compileErrFromAnalyzer(analyzer, 
+        "function '%s' is tagged '@%s' but does not return a value\n", name, tag
+    );
+}
+
+static void raiseImpureFunction(Analyzer *analyzer, char *name, char *tag, char *reason) {
+    compileErrFromAnalyzer(analyzer, 
+        "function '%s' is tagged '@%s' but %s\n", name, tag, reason
+    );
+}
+
+static void raiseNoAliasNotPointer(Analyzer *analyzer, char *function, char *parameter) {
+    compileErrFromAnalyzer(analyzer, 
+        "parameter '%s' of '%s' is tagged '@noalias' but is not a pointer\n", parameter, function
+    );
+}
+
+static void raiseAliasedArguments(Analyzer *analyzer, char *function, char *first, char *second) {
+    compileErrFromAnalyzer(analyzer, 
+        "the same memory is passed to '%s' and '%s' of '%s', but one of them is '@noalias'\n", first, second, function
+    );
+}
+
+static void raiseRecursiveInline(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "function '%s' is tagged '@inline' but is recursive and cannot be inlined\n", name
+    );
+}
+
+static void warnAddressTakenInline(Analyzer *analyzer, char *name) {
+    compileWarningFromAnalyzer(analyzer, 
+        "function '%s' is tagged '@inline' but its address is taken, an out-of-line copy will be emitted\n", name
+    );
+}
+
 static void raiseDuplicateSymbol(Analyzer *analyzer, char *name) {
     compileErrFromAnalyzer(analyzer, 
         "symbol '%s' already defined in this scope\n", name
@@ -97,6 +149,223 @@ static void raiseInvalidLoopContextualKeyword(Analyzer *analyzer, char *keyword)
     );
 }
 
+static void raiseInvalidDispatchLoop(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "the body of a '@dispatch' loop must be a single match statement\n"
+    );
+}
+
+static void raiseInvalidForIterator(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "for loops can currently only iterate over a range such as '0..n'\n"
+    );
+}
+
+static void raiseZeroRangeStep(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "range step cannot be zero\n"
+    );
+}
+
+static void raiseAssignedLoopVariable(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is the variable of a for loop and cannot be assigned\n", name
+    );
+}
+
+static void raiseLoopCarriedWrite(Analyzer *analyzer, char *name, char *tag) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is carried between iterations of a '@%s' loop, only reductions such as 'x = x + ...' can be carried\n", name, tag
+    );
+}
+
+static void raiseConflictingReduction(Analyzer *analyzer, char *name, char *tag) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is reduced with more than one operator in a '@%s' loop\n", name, tag
+    );
+}
+
+static void raiseWorksharedLoopExit(Analyzer *analyzer, char *tag) {
+    compileErrFromAnalyzer(analyzer, 
+        "a '@%s' loop cannot be left with 'stop' or 'return'\n", tag
+    );
+}
+
+static void raiseSoaArrayField(Analyzer *analyzer, char *structName, char *field) {
+    compileErrFromAnalyzer(analyzer, 
+        "field '%s' of '@soa' struct '%s' cannot be a fixed array\n", field, structName
+    );
+}
+
+static void raiseSoaArrayParameter(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "parameter '%s' is a fixed array of an '@soa' struct, pass a slice of it instead\n", name
+    );
+}
+
+static void raiseSoaLiteralElement(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "the elements of '@soa' array '%s' must be struct literals or variables\n", name
+    );
+}
+
+static void raiseSoaElementAddress(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "cannot take the address of an element of '%s', the fields of '@soa' structs are stored apart\n", name
+    );
+}
+
+static void raiseNotIndexable(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is not an array or slice and cannot be indexed\n", name
+    );
+}
+
+static void raiseUnnamedIndex(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "only named arrays and slices can be indexed\n"
+    );
+}
+
+static void raiseIndexOutOfBounds(Analyzer *analyzer, long long index, char *name, int length) {
+    compileErrFromAnalyzer(analyzer, 
+        "index %lld is out of bounds for '%s' of length %d\n", index, name, length
+    );
+}
+
+static void raiseSliceStep(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "a slice cannot have a step\n"
+    );
+}
+
+static void raiseArrayReturn(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "function '%s' cannot return a fixed array unless it is a 'const fn'\n", name
+    );
+}
+
+static void raiseUnsupportedVector(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is not a supported vector type, a vector must have at least two lanes and be 8, 16, 32 or 64 bytes\n", name
+    );
+}
+
+static void raiseBuiltinArguments(Analyzer *analyzer, char *name, int expected, int given) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' takes %d arguments but %d were given\n", name, expected, given
+    );
+}
+
+static void raiseNotAtomicElement(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'atomic<%s>' is not supported, an atomic holds an integer, a bool or a pointer\n", name
+    );
+}
+
+static void raiseNotMemoryOrder(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' expects a memory ordering, one of 'relaxed', 'acquire', 'release', 'acq_rel' or 'seq_cst'\n", name
+    );
+}
+
+static void raiseMemoryOrderNotAllowed(Analyzer *analyzer, char *name, char *order) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' cannot be given the '%s' ordering here\n", name, order
+    );
+}
+
+static void raiseNonAtomicAccess(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is atomic and can only be used through the atomic builtins, as in 'atomicLoad(&%s, seq_cst)'\n", name, name
+    );
+}
+
+static void raiseNonAtomicDereference(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' points to an atomic, which can only be used through the atomic builtins, as in 'atomicLoad(%s, seq_cst)'\n", name, name
+    );
+}
+
+static void raisePoolSlotType(Analyzer *analyzer, char *name, char *element) {
+    compileErrFromAnalyzer(analyzer, 
+        "a 'Pool<%s>' hands out '*%s', so '%s' must be a '*%s'\n", element, element, name, element
+    );
+}
+
+static void raisePoolFreeType(Analyzer *analyzer, char *name, char *element) {
+    compileErrFromAnalyzer(analyzer, 
+        "a 'Pool<%s>' only takes back '*%s', so '%s' cannot be freed to it\n", element, element, name
+    );
+}
+
+static void raisePoolSlotSize(Analyzer *analyzer, char *name, char *element) {
+    compileErrFromAnalyzer(analyzer, 
+        "'%s' is a 'Pool<%s>' and must be made with 'poolNew(sizeof %s, slabSlots)'\n", name, element, element
+    );
+}
+
+static void raiseMisplacedSpawn(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "'spawn %s(..)' must be a statement or the value given to a variable, as in 'let x: i64 = spawn %s(..)'\n", name, name
+    );
+}
+
+static void raiseVectorLiteralTooLong(Analyzer *analyzer, char *name, int count, int lanes) {
+    compileErrFromAnalyzer(analyzer, 
+        "vector literal for '%s' has %d elements but it only has %d lanes\n", name, count, lanes
+    );
+}
+
+static void raiseVectorSlice(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "the lanes of vector '%s' cannot be sliced\n", name
+    );
+}
+
+static void raiseArrayInitializer(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "fixed array '%s' must be initialised with an array literal\n", name
+    );
+}
+
+static void raiseArrayCallNotConstant(Analyzer *analyzer, char *name, char *function) {
+    compileErrFromAnalyzer(analyzer, 
+        "fixed array '%s' must be 'const' to be initialised by '%s' at compile time\n", name, function
+    );
+}
+
+static void raiseArrayCallType(Analyzer *analyzer, char *name, TypeExpr type, char *function, TypeExpr returnType) {
+    compileErrFromAnalyzer(analyzer, 
+        "fixed array '%s' is a '[%d]%s' but '%s' returns a '[%d]%s'\n",
+        name, type.arrayLength, type.name, function, returnType.arrayLength, returnType.name
+    );
+}
+
+static void raiseArrayLiteralType(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer, 
+        "an array literal can only initialise a fixed array, '%s' is not one\n", name
+    );
+}
+
+static void raiseUntypedArrayLiteral(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "an array literal can only initialise a 'let' or be passed as an array, slice, pointer or vector parameter\n"
+    );
+}
+
+static void raiseArrayArgumentTooLong(Analyzer *analyzer, char *function, int index, int count, int length) {
+    compileErrFromAnalyzer(analyzer, 
+        "array literal passed as argument %d of '%s' has %d elements but the parameter only holds %d\n", index + 1, function, count, length
+    );
+}
+
+static void raiseArrayLiteralTooLong(Analyzer *analyzer, char *name, int count, int length) {
+    compileErrFromAnalyzer(analyzer, 
+        "array literal for '%s' has %d elements but its length is %d\n", name, count, length
+    );
+}
+
 static void raiseIntOverflow(Analyzer *analyzer, uint64_t value, char *name, char *type) {
     compileErrFromAnalyzer(analyzer, 
         "compile constant value %llu overflows type %s on symbol '%s'", value, type, name
@@ -109,6 +378,12 @@ static void raiseIntUnderflow(Analyzer *analyzer, uint64_t value, char *name, ch
     );
 }
 
+static void raiseDivisionByZero(Analyzer *analyzer) {
+    compileErrFromAnalyzer(analyzer, 
+        "division by a constant zero\n"
+    );
+}
+
 static void raiseConstantCannotBeReassigned(Analyzer *analyzer, char *name) {
     compileErrFromAnalyzer(analyzer, 
         "constant symbol '%s' cannot be reassigned", name
@@ -136,111 +411,57 @@ static bool declareSymbol(SymbolTable *table, char *name, AstExpr *declaration)
     return true;
 }
 
-static ConstEvalResult newConstant(uint64_t value) {
-    return (ConstEvalResult){ .isConstant = true, .value = value };
-}
-
-static ConstEvalResult newNonConstant() {
-    return (ConstEvalResult){ .isConstant = false };
-}
-
-static ConstEvalResult evaluateConstExpr(AstExpr *expr) {
-    switch (expr->type) {
-        case AST_INTEGER_LITERAL: {
-            return newConstant(expr->asInteger.value);
-        }
-        case AST_BINARY: {
-            ConstEvalResult leftValue = evaluateConstExpr(expr->asBinary.left);
-            ConstEvalResult rightValue = evaluateConstExpr(expr->asBinary.right);
-            
-            if (!leftValue.isConstant || !rightValue.isConstant) {
-                return newNonConstant();
-            }
-
-            switch (expr->asBinary.operator) {
-                case OP_PLUS: {
-                    return newConstant(leftValue.value + rightValue.value);
-                }
-                case OP_MINUS: {
-                    return newConstant(leftValue.value - rightValue.value);
-                }
-                case OP_DEREF: {
-                    return newConstant(leftValue.value * rightValue.value);
-                }
-                case OP_DIVIDE: {
-                    return newConstant(leftValue.value / rightValue.value);
-                }
-                default: {
-                    return newNonConstant();
-                }
-            }
-        }
-        case AST_UNARY: {
-            ConstEvalResult rightValue = evaluateConstExpr(expr->asUnary.right);
+static void checkBitOverflows(Analyzer *analyzer, TypeExpr type, ConstValue constant, char *name) {
+    if (!constant.isConstant || constant.isBoolean) return;
 
-            switch (expr->asUnary.operator) {
-                case OP_MINUS: {
-                    return newConstant(-rightValue.value);
-                }
-                default: {
-                    return newNonConstant();
-                }
-            }
-        }
-        default: {
-            return newNonConstant();
-        }
-    }
-}
+    // an unsigned 64 bit value above INT64_MAX only fits in u64
+    bool isHuge = !constant.kind.isSigned && constant.kind.width == 64 && constant.bits > INT64_MAX;
+    long long value = constantAsSigned(constant);
 
-static void checkBitOverflows(Analyzer *analyzer, TypeExpr type, long long value, char *name) {
     if (strcmp(type.name, "i8") == 0) {
-        if (value > INT8_MAX) {
+        if (isHuge || value > INT8_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < INT8_MIN) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "u8") == 0) {
-        if (value > UINT8_MAX) {
+        if (isHuge || value > UINT8_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < 0) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "i16") == 0) {
-        if (value > INT16_MAX) {
+        if (isHuge || value > INT16_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < INT16_MIN) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "u16") == 0) {
-        if (value > UINT16_MAX) {
+        if (isHuge || value > UINT16_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < 0) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "i32") == 0) {
-        if (value > INT32_MAX) {
+        if (isHuge || value > INT32_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < INT32_MIN) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "u32") == 0) {
-        if (value > UINT32_MAX) {
+        if (isHuge || value > UINT32_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < 0) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "i64") == 0) {
-        if (value > INT64_MAX) {
+        if (isHuge || value > INT64_MAX) {
             raiseIntOverflow(analyzer, value, name, type.name);
         } else if (value < INT64_MIN) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     } else if (strcmp(type.name, "u64") == 0) {
-        // TODO! don't even know how to fix this warning
-        if (value > UINT64_MAX) {
-            raiseIntOverflow(analyzer, value, name, type.name);
-        } else if (value < 0) {
+        if (!isHuge && value < 0) {
             raiseIntUnderflow(analyzer, value, name, type.name);
         }
     }
@@ -257,6 +478,11 @@ static void analyzeFunctionDeclaration(Analyzer *analyzer, AstExpr *functionExpr
         raiseVoidFunctionCannotBeLambda(analyzer, function.name);
     }
 
+    // C arrays cannot be returned by value, a compile time function's array becomes a literal instead
+    if (function.returnType.arrayLength && !hasTag(function.tags, TAG_COMPTIME)) {
+        raiseArrayReturn(analyzer, function.name);
+    }
+
     pushScope(&analyzer->table);
 
     for (int i = 0; i < function.paramCount; i++) {
@@ -300,13 +526,40 @@ static void analyzeAssignExpr(Analyzer *analyzer, AssignmentExpr assign) {
         return;
     }
 
-    if (symbol->declaration->type == AST_LET) {
+    // parameters are declared without a declaration expression
+    if (symbol->declaration && symbol->declaration->type == AST_LET) {
         if (symbol->declaration->asLet.isConstant) {
             raiseConstantCannotBeReassigned(analyzer, symbol->declaration->asLet.name);
         }
     }
 }
 
+static void checkVectorType(Analyzer *analyzer, TypeExpr type) {
+    if (type.name && looksLikeVectorType(type.name)) {
+        VectorType vector;
+        if (!lookupVectorType(type.name, &vector)) raiseUnsupportedVector(analyzer, type.name);
+    }
+}
+
+// only a compile time function can return a fixed array, and only into a 'const' of the same type
+static void analyzeArrayCallLet(Analyzer *analyzer, LetDeclaration let) {
+    CallExpr call = let.value->asCallExpr;
+
+    AstExpr *callee = findFunction(analyzer->parser->ast, call.name);
+    if (!callee || !hasTag(callee->asFunction.tags, TAG_COMPTIME) || !callee->asFunction.returnType.arrayLength) {
+        raiseArrayInitializer(analyzer, let.name);
+        return;
+    }
+
+    TypeExpr returnType = callee->asFunction.returnType;
+    if (returnType.arrayLength != let.type.arrayLength || returnType.ptrDepth != let.type.ptrDepth || strcmp(returnType.name, let.type.name) != 0) {
+        raiseArrayCallType(analyzer, let.name, let.type, call.name, returnType);
+        return;
+    }
+
+    if (!let.isConstant) raiseArrayCallNotConstant(analyzer, let.name, call.name);
+}
+
 static void analyzeLet(Analyzer *analyzer, AstExpr *letExpr) {
     LetDeclaration let = letExpr->asLet;
     
@@ -316,10 +569,60 @@ static void analyzeLet(Analyzer *analyzer, AstExpr *letExpr) {
     }
 
     analyzeExpr(analyzer, let.value);
+    checkVectorType(analyzer, let.type);
+
+    if (let.type.arrayLength) {
+        if (let.value->type == AST_CALL_EXPR) {
+            analyzeArrayCallLet(analyzer, let);
+            return;
+        }
+
+        if (let.value->type != AST_ARRAY_LITERAL) {
+            raiseArrayInitializer(analyzer, let.name);
+            return;
+        }
+
+        ArrayLiteral array = let.value->asArray;
+        if (array.elementCount > let.type.arrayLength) {
+            raiseArrayLiteralTooLong(analyzer, let.name, array.elementCount, let.type.arrayLength);
+        }
+
+        // each element is split into its fields, so it has to be something that can be read more than once
+        if (isSoaType(analyzer->parser->ast, let.type)) {
+            for (int i = 0; i < array.elementCount; i++) {
+                AstType type = array.elements[i]->type;
 
-    ConstEvalResult result = evaluateConstExpr(let.value);
+                if (type != AST_STRUCT_INITIALIZER && type != AST_IDENTIFIER) {
+                    raiseSoaLiteralElement(analyzer, let.name);
+                    return;
+                }
+            }
+            return;
+        }
+
+        for (int i = 0; i < array.elementCount; i++) {
+            checkBitOverflows(analyzer, let.type, evaluateConstant(array.elements[i]), let.name);
+        }
+        return;
+    }
+
+    // a vector can be initialised lane by lane
+    VectorType vector;
+    if (let.value->type == AST_ARRAY_LITERAL && !let.type.ptrDepth && lookupVectorType(let.type.name, &vector)) {
+        if (let.value->asArray.elementCount > vector.lanes) {
+            raiseVectorLiteralTooLong(analyzer, let.name, let.value->asArray.elementCount, vector.lanes);
+        }
+        return;
+    }
+
+    if (let.value->type == AST_ARRAY_LITERAL) {
+        raiseArrayLiteralType(analyzer, let.name);
+        return;
+    }
+
+    ConstValue result = evaluateConstant(let.value);
     
-    checkBitOverflows(analyzer, let.type, result.value, let.name);
+    checkBitOverflows(analyzer, let.type, result, let.name);
 }
 
 static void analyzeReturnStatement(Analyzer *analyzer, ReturnStatement returnStatement) {
@@ -345,22 +648,308 @@ static void analyzeNext(Analyzer *analyzer, NextStatement next) {
     if (next.dummy == ' ') return;
 }
 
-static void analyzeWhile(Analyzer *analyzer, WhileStatement whileStatement) {
-    analyzer->insideLoop = true;
+typedef struct {
+    Analyzer      *analyzer;
+    char          *tag;
 
-    analyzeExpr(analyzer, whileStatement.condition);
+    // null for while loops, whose variables are stepped in the alteration
+    char          *variable;
 
-    for (int i = 0; i < whileStatement.block.count; i++) {
-        analyzeExpr(analyzer, whileStatement.block.body[i]);
+    // for loops run by OpenMP must not be left early
+    bool           canExit;
+    int            nestedLoops;
+
+    // variables declared in the body belong to one iteration
+    char         **locals;
+    int            localCount;
+    int            localCapacity;
+
+    LoopReduction *reductions;
+    int           *updateCounts;
+    int            reductionCount;
+    int            reductionCapacity;
+} IterationCheck;
+
+static bool iterationLocalsVisitor(AstExpr *expr, void *context) {
+    IterationCheck *check = context;
+
+    char *name = NULL;
+    if (expr->type == AST_LET) name = expr->asLet.name;
+    if (expr->type == AST_FOR) name = expr->asFor.variable;
+    if (!name) return true;
+
+    if (check->localCount >= check->localCapacity) {
+        check->localCapacity *= 2;
+        check->locals = realloc(check->locals, sizeof(char *) * check->localCapacity);
     }
+    check->locals[check->localCount++] = name;
 
-    analyzer->insideLoop = false;
+    return true;
 }
 
-static void analyzeCallExpr(Analyzer *analyzer, CallExpr call) {
-    if (!retrieveSymbol(&analyzer->table, call.name)) {
-        // fix to search outer scopes not just current
-        // raiseUndefinedSymbol(analyzer, call.name);
+static bool isIterationLocal(IterationCheck *check, char *name) {
+    for (int i = 0; i < check->localCount; i++) {
+        if (strcmp(check->locals[i], name) == 0) return true;
+    }
+
+    return false;
+}
+
+static bool countReferencesVisitor(AstExpr *expr, void *context) {
+    struct { char *name; int count; } *search = context;
+
+    if (expr->type == AST_IDENTIFIER && strcmp(expr->asIdentifier.name, search->name) == 0) {
+        search->count++;
+    }
+
+    return true;
+}
+
+static int countReferences(AstExpr *expr, char *name) {
+    struct { char *name; int count; } search = { name, 0 };
+    walkExpr(expr, countReferencesVisitor, &search);
+
+    return search.count;
+}
+
+// whether 'expr' is 'name' combined with values that do not read it, using only 'operator'
+// subtraction takes part in a sum as long as 'name' is on the left
+static bool isReductionOperand(AstExpr *expr, char *name, OperatorType operator) {
+    if (expr->type == AST_GROUPING) return isReductionOperand(expr->asGrouping.expression, name, operator);
+    if (expr->type == AST_IDENTIFIER) return strcmp(expr->asIdentifier.name, name) == 0;
+    if (expr->type != AST_BINARY) return false;
+
+    BinaryExpr binary = expr->asBinary;
+
+    bool isSameOperator = binary.operator == operator || (operator == OP_PLUS && binary.operator == OP_MINUS);
+    if (!isSameOperator) return false;
+
+    if (isReductionOperand(binary.left, name, operator) && countReferences(binary.right, name) == 0) return true;
+    if (binary.operator == OP_MINUS) return false;
+
+    return isReductionOperand(binary.right, name, operator) && countReferences(binary.left, name) == 0;
+}
+
+// the operator 'name = value' reduces with, if it is a reduction
+static bool findReduction(AstExpr *value, char *name, OperatorType *operator) {
+    if (value->type != AST_BINARY) return false;
+
+    switch (value->asBinary.operator) {
+        case OP_PLUS:
+        case OP_MINUS: {
+            *operator = OP_PLUS;
+            break;
+        }
+        case OP_DEREF:
+        case OP_BITWISE_AND:
+        case OP_BITWISE_OR:
+        case OP_BITWISE_XOR:
+        case OP_AND:
+        case OP_OR: {
+            *operator = value->asBinary.operator;
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+
+    return isReductionOperand(value, name, *operator);
+}
+
+static void addLoopReduction(IterationCheck *check, char *name, OperatorType operator) {
+    for (int i = 0; i < check->reductionCount; i++) {
+        if (strcmp(check->reductions[i].name, name) != 0) continue;
+
+        if (check->reductions[i].operator != operator) {
+            raiseConflictingReduction(check->analyzer, name, check->tag);
+        }
+
+        check->updateCounts[i]++;
+        return;
+    }
+
+    if (check->reductionCount >= check->reductionCapacity) {
+        check->reductionCapacity *= 2;
+        check->reductions = realloc(check->reductions, sizeof(LoopReduction) * check->reductionCapacity);
+        check->updateCounts = realloc(check->updateCounts, sizeof(int) * check->reductionCapacity);
+    }
+
+    check->reductions[check->reductionCount] = (LoopReduction){ name, operator };
+    check->updateCounts[check->reductionCount++] = 1;
+}
+
+static bool iterationWritesVisitor(AstExpr *expr, void *context);
+
+static void checkNestedLoopBody(IterationCheck *check, BlockExpr block) {
+    check->nestedLoops++;
+    for (int i = 0; i < block.count; i++) {
+        walkExpr(block.body[i], iterationWritesVisitor, check);
+    }
+    check->nestedLoops--;
+}
+
+static bool iterationWritesVisitor(AstExpr *expr, void *context) {
+    IterationCheck *check = context;
+
+    switch (expr->type) {
+        case AST_FOR: {
+            walkExpr(expr->asFor.iterator, iterationWritesVisitor, check);
+            checkNestedLoopBody(check, expr->asFor.block);
+            return false;
+        }
+        case AST_WHILE: {
+            walkExpr(expr->asWhile.condition, iterationWritesVisitor, check);
+            if (expr->asWhile.alteration) walkExpr(expr->asWhile.alteration, iterationWritesVisitor, check);
+
+            checkNestedLoopBody(check, expr->asWhile.block);
+            return false;
+        }
+        case AST_STOP: {
+            if (!check->canExit && !check->nestedLoops) raiseWorksharedLoopExit(check->analyzer, check->tag);
+            return true;
+        }
+        case AST_RETURN: {
+            if (!check->canExit) raiseWorksharedLoopExit(check->analyzer, check->tag);
+            return true;
+        }
+        case AST_ASSIGN_EXPR: {
+            AssignmentExpr assign = expr->asAssign;
+
+            // element writes are left to the programmer, as they are for '@noalias' pointers in C
+            if (assign.target || isIterationLocal(check, assign.name)) return true;
+
+            // reported for every for loop by 'analyzeFor'
+            if (check->variable && strcmp(assign.name, check->variable) == 0) return true;
+
+            OperatorType operator;
+            if (findReduction(assign.value, assign.name, &operator)) {
+                addLoopReduction(check, assign.name, operator);
+            } else {
+                raiseLoopCarriedWrite(check->analyzer, assign.name, check->tag);
+            }
+            return true;
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+// rejects writes which make one iteration of a '@simd' or '@parallel' loop depend on another
+// returns the reductions the loop combines, which the caller owns
+static LoopReduction *checkIndependentIterations(Analyzer *analyzer, BlockExpr block, char *variable, uint32_t tags, int *reductionCount) {
+    IterationCheck check = {
+        .analyzer = analyzer,
+        .tag = hasTag(tags, TAG_PARALLEL) ? "parallel" : "simd",
+        .variable = variable,
+        .canExit = !variable,
+        .nestedLoops = 0,
+        .locals = malloc(sizeof(char *)),
+        .localCount = 0,
+        .localCapacity = 1,
+        .reductions = malloc(sizeof(LoopReduction)),
+        .updateCounts = malloc(sizeof(int)),
+        .reductionCount = 0,
+        .reductionCapacity = 1,
+    };
+
+    for (int i = 0; i < block.count; i++) {
+        walkExpr(block.body[i], iterationLocalsVisitor, &check);
+    }
+
+    for (int i = 0; i < block.count; i++) {
+        walkExpr(block.body[i], iterationWritesVisitor, &check);
+    }
+
+    // a reduction read anywhere but its own update would see other iterations' partial values
+    for (int i = 0; i < check.reductionCount; i++) {
+        int references = 0;
+        for (int j = 0; j < block.count; j++) {
+            references += countReferences(block.body[j], check.reductions[i].name);
+        }
+
+        if (references > check.updateCounts[i]) {
+            raiseLoopCarriedWrite(analyzer, check.reductions[i].name, check.tag);
+        }
+
+        check.reductions[i].name = strdup(check.reductions[i].name);
+    }
+
+    free(check.locals);
+    free(check.updateCounts);
+
+    *reductionCount = check.reductionCount;
+    return check.reductions;
+}
+
+static void analyzeWhile(Analyzer *analyzer, WhileStatement whileStatement) {
+    // each case of the match ends by dispatching the next iteration itself
+    if (hasTag(whileStatement.tags, TAG_DISPATCH)) {
+        if (whileStatement.block.count != 1 || whileStatement.block.body[0]->type != AST_MATCH) {
+            raiseInvalidDispatchLoop(analyzer);
+        }
+    }
+
+    // the loop is only hinted, so reductions are left for the C compiler to find
+    if (hasTag(whileStatement.tags, TAG_SIMD)) {
+        int reductionCount;
+        LoopReduction *reductions = checkIndependentIterations(analyzer, whileStatement.block, NULL, whileStatement.tags, &reductionCount);
+
+        for (int i = 0; i < reductionCount; i++) free(reductions[i].name);
+        free(reductions);
+    }
+
+    analyzer->insideLoop = true;
+
+    analyzeExpr(analyzer, whileStatement.condition);
+
+    for (int i = 0; i < whileStatement.block.count; i++) {
+        analyzeExpr(analyzer, whileStatement.block.body[i]);
+    }
+
+    analyzer->insideLoop = false;
+}
+
+static bool isAssignedIn(BlockExpr block, char *name);
+
+static void analyzeFor(Analyzer *analyzer, ForStatement *forStatement) {
+    if (forStatement->iterator->type != AST_RANGE) {
+        raiseInvalidForIterator(analyzer);
+        return;
+    }
+
+    AstExpr *step = forStatement->iterator->asRange.step;
+    if (step) {
+        ConstValue value = evaluateConstant(step);
+        if (value.isConstant && value.bits == 0) raiseZeroRangeStep(analyzer);
+    }
+
+    // the number of iterations is worked out before the loop starts
+    if (isAssignedIn(forStatement->block, forStatement->variable)) {
+        raiseAssignedLoopVariable(analyzer, forStatement->variable);
+    }
+
+    bool wasInsideLoop = analyzer->insideLoop;
+    analyzer->insideLoop = true;
+
+    for (int i = 0; i < forStatement->block.count; i++) {
+        analyzeExpr(analyzer, forStatement->block.body[i]);
+    }
+
+    analyzer->insideLoop = wasInsideLoop;
+
+    if (hasTag(forStatement->tags, TAG_SIMD | TAG_PARALLEL)) {
+        forStatement->reductions = checkIndependentIterations(
+            analyzer, forStatement->block, forStatement->variable, forStatement->tags, &forStatement->reductionCount
+        );
+    }
+}
+
+static void analyzeCallExpr(Analyzer *analyzer, CallExpr call) {
+    if (!retrieveSymbol(&analyzer->table, call.name)) {
+        // fix to search outer scopes not just current
+        // raiseUndefinedSymbol(analyzer, call.name);
     }
 }
 
@@ -375,6 +964,7 @@ static void analyzeExpr(Analyzer *analyzer, AstExpr *expr) {
             break;
         }
         case AST_FOR: {
+            analyzeFor(analyzer, &expr->asFor);
             break;
         }
         case AST_PROPERTY_ACCESS: {
@@ -409,6 +999,9 @@ static void analyzeExpr(Analyzer *analyzer, AstExpr *expr) {
             analyzeStop(analyzer, expr->asStop);
             break;
         }
+        case AST_SYNC: {
+            break;
+        }
         case AST_UNARY: {
             break;
         }
@@ -470,6 +1063,15 @@ static void analyzeExpr(Analyzer *analyzer, AstExpr *expr) {
         case AST_EMBED: {
             break;
         }
+        case AST_RANGE: {
+            break;
+        }
+        case AST_INDEX: {
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            break;
+        }
         case AST_ERR_EXPR: {
             exitWithInternalCompilerError("found error expression in analyzer");
             break;
@@ -480,35 +1082,1557 @@ static void analyzeExpr(Analyzer *analyzer, AstExpr *expr) {
     }
 }
 
-void analyze(Analyzer *analyzer) {
-    if (analyzer->parser->ast.exprCount == 0) {
-        raiseNoEntryPointErr(analyzer);
-        return;
+AstExpr *findFunction(Ast ast, char *name) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        if (expr->type == AST_FUNCTION_DECLARATION && strcmp(expr->asFunction.name, name) == 0) {
+            return expr;
+        }
+
+        if (expr->type != AST_STRUCT_DECLARATION) continue;
+
+        for (int j = 0; j < expr->asStruct.memberCount; j++) {
+            AstExpr *member = expr->asStruct.members[j];
+
+            if (member->type == AST_FUNCTION_DECLARATION && strcmp(member->asFunction.name, name) == 0) {
+                return member;
+            }
+        }
     }
 
-    bool hasEntryPoint = false;
-    bool isPublicEntryPoint = false;
-    bool isInlineEntryPoint = false;
-    for (int i = 0; i < analyzer->parser->ast.exprCount; i++) {
-        AstExpr *expr = analyzer->parser->ast.exprs[i];
+    return NULL;
+}
 
-        if (!hasEntryPoint && expr->type == AST_FUNCTION_DECLARATION) {
-            if (strcmp(expr->asFunction.name, "main") == 0) {
-                hasEntryPoint = true;
+typedef struct {
+    Ast       ast;
+    char     *target;
 
-                if (expr->asFunction.isPublic) {
-                    isPublicEntryPoint = true;
-                }
+    char    **visited;
+    int       visitedCount;
+    int       visitedCapacity;
 
-                if (expr->asFunction.isInline) {
-                    isInlineEntryPoint = true;
-                }
+    bool      found;
+} CallSearch;
+
+static bool searchCallsVisitor(AstExpr *expr, void *context) {
+    CallSearch *search = context;
+    if (search->found) return false;
+    if (expr->type != AST_CALL_EXPR) return true;
+
+    char *name = expr->asCallExpr.name;
+    if (strcmp(name, search->target) == 0) {
+        search->found = true;
+        return false;
+    }
+
+    for (int i = 0; i < search->visitedCount; i++) {
+        if (strcmp(search->visited[i], name) == 0) return true;
+    }
+
+    if (search->visitedCount >= search->visitedCapacity) {
+        search->visitedCapacity *= 2;
+        search->visited = realloc(search->visited, sizeof(char *) * search->visitedCapacity);
+    }
+    search->visited[search->visitedCount++] = name;
+
+    AstExpr *callee = findFunction(search->ast, name);
+    if (callee) walkExpr(callee, searchCallsVisitor, search);
+
+    return true;
+}
+
+bool isRecursive(Ast ast, AstExpr *function) {
+    CallSearch search = {
+        .ast = ast,
+        .target = function->asFunction.name,
+        .visited = malloc(sizeof(char *)),
+        .visitedCount = 0,
+        .visitedCapacity = 1,
+        .found = false
+    };
+
+    walkExpr(function, searchCallsVisitor, &search);
+    free(search.visited);
+
+    return search.found;
+}
+
+typedef struct {
+    char *name;
+    bool  found;
+} AddressSearch;
+
+static bool searchAddressVisitor(AstExpr *expr, void *context) {
+    AddressSearch *search = context;
+
+    if (expr->type == AST_UNARY && expr->asUnary.operator == OP_ADDRESS_OF) {
+        AstExpr *right = expr->asUnary.right;
+
+        if (right->type == AST_IDENTIFIER && strcmp(right->asIdentifier.name, search->name) == 0) {
+            search->found = true;
+        }
+    }
+
+    return !search->found;
+}
+
+static bool isAddressTaken(Analyzer *analyzer, char *name) {
+    AddressSearch search = { .name = name, .found = false };
+
+    Ast ast = analyzer->parser->ast;
+    for (int i = 0; i < ast.exprCount && !search.found; i++) {
+        walkExpr(ast.exprs[i], searchAddressVisitor, &search);
+    }
+
+    return search.found;
+}
+
+typedef struct {
+    Analyzer *analyzer;
+    char     *tag;
+    bool      isConst;
+
+    // functions may only call functions carrying one of these tags
+    uint32_t  callableTags;
+    char     *callReason;
+
+    // names declared by the function itself, writes to anything else are side effects
+    char    **locals;
+    int       localCount;
+    int       localCapacity;
+
+    // set to the first side effect found
+    char     *reason;
+    char     *subject;
+} PurityCheck;
+
+static void addLocal(PurityCheck *check, char *name) {
+    if (check->localCount >= check->localCapacity) {
+        check->localCapacity *= 2;
+        check->locals = realloc(check->locals, sizeof(char *) * check->localCapacity);
+    }
+
+    check->locals[check->localCount++] = name;
+}
+
+static bool isLocal(PurityCheck *check, char *name) {
+    for (int i = 0; i < check->localCount; i++) {
+        if (strcmp(check->locals[i], name) == 0) return true;
+    }
+
+    return false;
+}
+
+static bool collectLocalsVisitor(AstExpr *expr, void *context) {
+    if (expr->type == AST_LET) addLocal(context, expr->asLet.name);
+
+    return true;
+}
+
+// the element written by an assignment to 'name[index]' or 'name[index].field'
+static IndexExpr *elementOf(AstExpr *target) {
+    if (target->type == AST_PROPERTY_ACCESS) return &target->asProperty.object->asIndex;
+
+    return &target->asIndex;
+}
+
+static bool purityVisitor(AstExpr *expr, void *context) {
+    PurityCheck *check = context;
+    if (check->reason) return false;
+
+    switch (expr->type) {
+        case AST_EMBED: {
+            check->reason = "contains an embed block";
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            AstExpr *target = expr->asAssign.target;
+
+            if (expr->asAssign.ptrDepth > 0) {
+                check->reason = "writes through pointer '%s'";
+                check->subject = expr->asAssign.name;
+            } else if (target && elementOf(target)->objectType.isSlice) {
+                check->reason = "writes through slice '%s'";
+                check->subject = expr->asAssign.name;
+            } else if (!isLocal(check, expr->asAssign.name)) {
+                check->reason = "writes to non-local '%s'";
+                check->subject = expr->asAssign.name;
+            }
+            break;
+        }
+        case AST_UNARY: {
+            if (check->isConst && expr->asUnary.operator == OP_DEREF) {
+                check->reason = "reads memory through a pointer";
+            }
+            break;
+        }
+        case AST_INDEX: {
+            // slices and array parameters point at memory the function does not own
+            AstExpr *object = expr->asIndex.object;
+            bool isOwned = object->type == AST_IDENTIFIER && isLocal(check, object->asIdentifier.name)
+                && !expr->asIndex.objectType.isSlice;
+
+            if (check->isConst && !isOwned) {
+                check->reason = "reads memory through '%s'";
+                check->subject = object->type == AST_IDENTIFIER ? object->asIdentifier.name : "an index";
             }
+            break;
         }
+        case AST_CALL_EXPR: {
+            AstExpr *callee = findFunction(check->analyzer->parser->ast, expr->asCallExpr.name);
 
-        analyzeExpr(analyzer, expr);
+            if (!callee || !(callee->asFunction.tags & check->callableTags)) {
+                check->reason = check->callReason;
+                check->subject = expr->asCallExpr.name;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return check->reason == NULL;
+}
+
+// sets 'reason' to the first side effect in the function, if it has one
+static void findSideEffect(PurityCheck *check, AstExpr *functionExpr) {
+    FunctionDeclaration function = functionExpr->asFunction;
+
+    for (int i = 0; i < function.paramCount; i++) {
+        addLocal(check, function.parameters[i].name);
+    }
+    walkExpr(functionExpr, collectLocalsVisitor, check);
+    walkExpr(functionExpr, purityVisitor, check);
+}
+
+// '@pure' functions may only read memory and '@const' functions may not touch it at all
+// neither may write outside of their own locals or call anything weaker than themselves
+static void checkPurity(Analyzer *analyzer, AstExpr *functionExpr, char *tag, bool isConst, uint32_t callableTags, char *callReason) {
+    FunctionDeclaration function = functionExpr->asFunction;
+
+    if (strcmp("u0", function.returnType.name) == 0 && function.returnType.ptrDepth == 0) {
+        raiseVoidFunctionCannotBePure(analyzer, function.name, tag);
+        return;
+    }
+
+    PurityCheck check = {
+        .analyzer = analyzer,
+        .tag = tag,
+        .isConst = isConst,
+        .callableTags = callableTags,
+        .callReason = callReason,
+        .locals = malloc(sizeof(char *)),
+        .localCount = 0,
+        .localCapacity = 1,
+        .reason = NULL,
+        .subject = NULL
+    };
+
+    findSideEffect(&check, functionExpr);
+
+    if (check.reason) {
+        char reason[256];
+        snprintf(reason, sizeof(reason), check.reason, check.subject);
+
+        raiseImpureFunction(analyzer, function.name, tag, reason);
+    }
+
+    free(check.locals);
+}
+
+// a function which only writes its own locals cannot change memory a caller passed it,
+// whatever else the caller passed, so it may take read-only arguments by reference
+static void markLocalWrites(Analyzer *analyzer, AstExpr *functionExpr) {
+    PurityCheck check = {
+        .analyzer = analyzer,
+        .tag = NULL,
+        .isConst = false,
+        .callableTags = TAG_PURE | TAG_CONST | TAG_COMPTIME,
+        .callReason = "calls '%s'",
+        .locals = malloc(sizeof(char *)),
+        .localCount = 0,
+        .localCapacity = 1,
+        .reason = NULL,
+        .subject = NULL
+    };
+
+    findSideEffect(&check, functionExpr);
+    functionExpr->asFunction.writesOnlyLocals = check.reason == NULL;
+
+    free(check.locals);
+}
+
+static bool isPointerParameter(FunctionParameter parameter) {
+    return parameter.type.ptrDepth > 0 && !parameter.type.arrayLength && !parameter.type.isSlice;
+}
+
+static void checkFunctionTags(Analyzer *analyzer, AstExpr *functionExpr) {
+    FunctionDeclaration function = functionExpr->asFunction;
+
+    for (int i = 0; i < function.paramCount; i++) {
+        FunctionParameter parameter = function.parameters[i];
+
+        if (hasTag(parameter.tags, TAG_NOALIAS) && !isPointerParameter(parameter)) {
+            raiseNoAliasNotPointer(analyzer, function.name, parameter.name);
+        }
+    }
+
+    if (hasTag(function.tags, TAG_HOT) && hasTag(function.tags, TAG_COLD)) {
+        raiseConflictingTags(analyzer, function.name, "hot", "cold");
+    }
+
+    if (hasTag(function.tags, TAG_PURE) && hasTag(function.tags, TAG_CONST)) {
+        raiseConflictingTags(analyzer, function.name, "pure", "const");
+    } else if (hasTag(function.tags, TAG_PURE)) {
+        checkPurity(analyzer, functionExpr, "pure", false, 
+            TAG_PURE | TAG_CONST | TAG_COMPTIME, "calls '%s' which is not '@pure' or '@const'"
+        );
+    } else if (hasTag(function.tags, TAG_CONST)) {
+        checkPurity(analyzer, functionExpr, "const", true, 
+            TAG_CONST | TAG_COMPTIME, "calls '%s' which is not '@const'"
+        );
+    }
+
+    // compile time functions are run by the interpreter, which has no memory to read or write
+    if (hasTag(function.tags, TAG_COMPTIME)) {
+        checkPurity(analyzer, functionExpr, "comptime", true, 
+            TAG_COMPTIME, "calls '%s' which is not '@comptime'"
+        );
+    }
+
+    if (!hasTag(function.tags, TAG_INLINE)) return;
+
+    if (hasTag(function.tags, TAG_NOINLINE)) {
+        raiseConflictingTags(analyzer, function.name, "inline", "noinline");
+        return;
     }
 
+    if (isRecursive(analyzer->parser->ast, functionExpr)) {
+        raiseRecursiveInline(analyzer, function.name);
+    } else if (isAddressTaken(analyzer, function.name)) {
+        warnAddressTakenInline(analyzer, function.name);
+    }
+}
+
+static bool divisionByZeroVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+    if (expr->type != AST_BINARY) return true;
+
+    OperatorType operator = expr->asBinary.operator;
+    if (operator != OP_DIVIDE && operator != OP_MOD) return true;
+
+    ConstValue divisor = evaluateConstant(expr->asBinary.right);
+    if (divisor.isConstant && divisor.bits == 0) {
+        raiseDivisionByZero(analyzer);
+    }
+
+    return true;
+}
+
+typedef struct {
+    char     *name;
+    TypeExpr  type;
+} ScopedVariable;
+
+typedef struct {
+    Analyzer       *analyzer;
+
+    // the for loops enclosing the expression being visited, innermost last
+    ForStatement  **loops;
+    int             loopCount;
+    int             loopCapacity;
+
+    // the parameters and locals declared in the blocks enclosing the expression, innermost last
+    // leaving a block drops the variables it declared
+    ScopedVariable *variables;
+    int             variableCount;
+    int             variableCapacity;
+} IndexResolver;
+
+static void declareVariable(IndexResolver *resolver, char *name, TypeExpr type) {
+    if (resolver->variableCount >= resolver->variableCapacity) {
+        resolver->variableCapacity *= 2;
+        resolver->variables = realloc(resolver->variables, sizeof(ScopedVariable) * resolver->variableCapacity);
+    }
+
+    resolver->variables[resolver->variableCount++] = (ScopedVariable){ name, type };
+}
+
+// the innermost declaration in scope, falling back to the globals
+static bool findVariableType(IndexResolver *resolver, char *name, TypeExpr *type) {
+    for (int i = resolver->variableCount - 1; i >= 0; i--) {
+        if (strcmp(resolver->variables[i].name, name) != 0) continue;
+
+        *type = resolver->variables[i].type;
+        return true;
+    }
+
+    Ast ast = resolver->analyzer->parser->ast;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        if (expr->type == AST_LET && strcmp(expr->asLet.name, name) == 0) {
+            *type = expr->asLet.type;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool isAssignedVisitor(AstExpr *expr, void *context) {
+    char **name = context;
+    if (!*name) return false;
+
+    if (expr->type == AST_ASSIGN_EXPR && !expr->asAssign.target && strcmp(expr->asAssign.name, *name) == 0) {
+        *name = NULL;
+    }
+
+    return *name != NULL;
+}
+
+static bool isAssignedIn(BlockExpr block, char *name) {
+    for (int i = 0; i < block.count; i++) {
+        char *search = name;
+        walkExpr(block.body[i], isAssignedVisitor, &search);
+
+        if (!search) return true;
+    }
+
+    return false;
+}
+
+static bool isConstantAtLeast(AstExpr *expr, long long minimum) {
+    ConstValue value = evaluateConstant(expr);
+    if (!value.isConstant) return false;
+
+    bool isHuge = !value.kind.isSigned && value.kind.width == 64 && value.bits > INT64_MAX;
+    return isHuge || constantAsSigned(value) >= minimum;
+}
+
+static bool isConstantAtMost(AstExpr *expr, long long maximum) {
+    ConstValue value = evaluateConstant(expr);
+    if (!value.isConstant) return false;
+
+    bool isHuge = !value.kind.isSigned && value.kind.width == 64 && value.bits > INT64_MAX;
+    return !isHuge && constantAsSigned(value) <= maximum;
+}
+
+// whether the range of 'loop' keeps its variable within the bounds of the array or slice 'name'
+//
+// the loop must count up from a constant which is not negative, and stop before 'name.len'
+// or before a constant no greater than the length of an array
+// a slice being indexed may not be assigned in the body
+static bool isLoopWithinBounds(ForStatement *loop, char *name, TypeExpr type) {
+    if (loop->iterator->type != AST_RANGE) return false;
+    RangeExpr range = loop->iterator->asRange;
+
+    if (range.step && !isConstantAtLeast(range.step, 1)) return false;
+    if (!isConstantAtLeast(range.start, 0)) return false;
+
+    if (type.isSlice && isAssignedIn(loop->block, name)) return false;
+
+    AstExpr *end = range.end;
+
+    // 'len' of an array has already been replaced by its length, only slices still have it
+    if (!range.isInclusive && end->type == AST_PROPERTY_ACCESS && strcmp(end->asProperty.property, "len") == 0) {
+        AstExpr *object = end->asProperty.object;
+        return object->type == AST_IDENTIFIER && strcmp(object->asIdentifier.name, name) == 0;
+    }
+
+    if (!type.arrayLength) return false;
+
+    return isConstantAtMost(end, range.isInclusive ? type.arrayLength - 1 : type.arrayLength);
+}
+
+static bool isIndexWithinBounds(IndexResolver *resolver, AstExpr *index, char *name, TypeExpr type) {
+    ConstValue constant = evaluateConstant(index);
+
+    if (constant.isConstant) {
+        if (!type.arrayLength) return false;
+
+        if (!isConstantAtLeast(index, 0) || !isConstantAtMost(index, type.arrayLength - 1)) {
+            raiseIndexOutOfBounds(resolver->analyzer, constantAsSigned(constant), name, type.arrayLength);
+            return false;
+        }
+
+        return true;
+    }
+
+    if (index->type != AST_IDENTIFIER) return false;
+
+    // the innermost loop with that variable is the one it refers to
+    for (int i = resolver->loopCount - 1; i >= 0; i--) {
+        ForStatement *loop = resolver->loops[i];
+
+        if (strcmp(loop->variable, index->asIdentifier.name) == 0) {
+            return isLoopWithinBounds(loop, name, type);
+        }
+    }
+
+    return false;
+}
+
+// a slice 'name[start..end]' is in bounds when both ends are constants within an array
+static bool isSliceWithinBounds(IndexResolver *resolver, RangeExpr range, char *name, TypeExpr type) {
+    if (!type.arrayLength) return false;
+
+    long long maximum = range.isInclusive ? type.arrayLength - 1 : type.arrayLength;
+
+    if (!isConstantAtLeast(range.start, 0) || !isConstantAtMost(range.start, type.arrayLength)) return false;
+    if (!isConstantAtMost(range.end, maximum)) return false;
+
+    long long start = constantAsSigned(evaluateConstant(range.start));
+    long long end = constantAsSigned(evaluateConstant(range.end)) + range.isInclusive;
+
+    if (start > end) {
+        raiseIndexOutOfBounds(resolver->analyzer, start, name, type.arrayLength);
+        return false;
+    }
+
+    return true;
+}
+
+static bool indexVisitor(AstExpr *expr, void *context);
+
+static void resolveBlockIndexes(IndexResolver *resolver, BlockExpr block) {
+    int scope = resolver->variableCount;
+
+    for (int i = 0; i < block.count; i++) {
+        walkExpr(block.body[i], indexVisitor, resolver);
+    }
+
+    resolver->variableCount = scope;
+}
+
+static void resolveForIndexes(IndexResolver *resolver, ForStatement *loop) {
+    walkExpr(loop->iterator, indexVisitor, resolver);
+
+    if (resolver->loopCount >= resolver->loopCapacity) {
+        resolver->loopCapacity *= 2;
+        resolver->loops = realloc(resolver->loops, sizeof(ForStatement *) * resolver->loopCapacity);
+    }
+    resolver->loops[resolver->loopCount++] = loop;
+
+    int scope = resolver->variableCount;
+    declareVariable(resolver, loop->variable, loop->type);
+
+    resolveBlockIndexes(resolver, loop->block);
+
+    resolver->variableCount = scope;
+    resolver->loopCount--;
+}
+
+// the length of a fixed array or the lane count of a vector, zero for anything else
+static int fixedLength(TypeExpr type) {
+    if (type.arrayLength) return type.arrayLength;
+
+    VectorType vector;
+    if (!type.isSlice && !type.ptrDepth && type.name && lookupVectorType(type.name, &vector)) return vector.lanes;
+
+    return 0;
+}
+
+static void resolveIndex(IndexResolver *resolver, IndexExpr *index) {
+    if (index->object->type != AST_IDENTIFIER) {
+        raiseUnnamedIndex(resolver->analyzer);
+        return;
+    }
+
+    char *name = index->object->asIdentifier.name;
+
+    TypeExpr type;
+    if (!findVariableType(resolver, name, &type)) {
+        raiseNotIndexable(resolver->analyzer, name);
+        return;
+    }
+
+    // the lanes of a vector are indexed like a fixed array
+    if (!type.arrayLength && fixedLength(type)) {
+        if (index->index->type == AST_RANGE) {
+            raiseVectorSlice(resolver->analyzer, name);
+            return;
+        }
+
+        type.arrayLength = fixedLength(type);
+    }
+
+    if (!type.arrayLength && !type.isSlice) {
+        raiseNotIndexable(resolver->analyzer, name);
+        return;
+    }
+
+    free(index->objectType.name);
+    index->objectType = cloneType(type);
+
+    if (index->index->type == AST_RANGE) {
+        RangeExpr range = index->index->asRange;
+
+        if (range.step) {
+            raiseSliceStep(resolver->analyzer);
+            return;
+        }
+
+        index->isProvenInBounds = isSliceWithinBounds(resolver, range, name, type);
+        return;
+    }
+
+    index->isProvenInBounds = isIndexWithinBounds(resolver, index->index, name, type);
+}
+
+static bool isEnumName(Ast ast, char *name) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type == AST_ENUM && strcmp(ast.exprs[i]->asEnum.name, name) == 0) return true;
+    }
+
+    return false;
+}
+
+// a match on a variable of an enum type finds its patterns among the values of that enum
+static void resolveMatchSubject(IndexResolver *resolver, MatchExpr *match) {
+    if (match->expression->type != AST_IDENTIFIER) return;
+
+    TypeExpr type;
+    if (!findVariableType(resolver, match->expression->asIdentifier.name, &type)) return;
+    if (!type.name || type.ptrDepth || type.arrayLength || type.isSlice) return;
+
+    if (!isEnumName(resolver->analyzer->parser->ast, type.name)) return;
+
+    free(match->enumName);
+    match->enumName = strdup(type.name);
+}
+
+// resolves the type being indexed for each index expression and proves what bounds checks it can,
+// and the enum each match is on, as both need the variables in scope
+static bool indexVisitor(AstExpr *expr, void *context) {
+    IndexResolver *resolver = context;
+
+    switch (expr->type) {
+        case AST_MATCH: {
+            resolveMatchSubject(resolver, &expr->asMatch);
+            return true;
+        }
+        case AST_LET: {
+            // the value is resolved before the name it declares comes into scope
+            walkExpr(expr->asLet.value, indexVisitor, resolver);
+            declareVariable(resolver, expr->asLet.name, expr->asLet.type);
+            return false;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            int scope = resolver->variableCount;
+
+            FunctionDeclaration function = expr->asFunction;
+            for (int i = 0; i < function.paramCount; i++) {
+                declareVariable(resolver, function.parameters[i].name, function.parameters[i].type);
+            }
+
+            if (function.isLambda) {
+                walkExpr(function.lambdaExpr, indexVisitor, resolver);
+            } else {
+                resolveBlockIndexes(resolver, function.block);
+            }
+
+            resolver->variableCount = scope;
+            return false;
+        }
+        case AST_BLOCK: {
+            resolveBlockIndexes(resolver, expr->asBlock);
+            return false;
+        }
+        case AST_IF: {
+            walkExpr(expr->asIf.condition, indexVisitor, resolver);
+            resolveBlockIndexes(resolver, expr->asIf.block);
+            return false;
+        }
+        case AST_WHILE: {
+            walkExpr(expr->asWhile.condition, indexVisitor, resolver);
+            resolveBlockIndexes(resolver, expr->asWhile.block);
+            walkExpr(expr->asWhile.alteration, indexVisitor, resolver);
+            return false;
+        }
+        case AST_FOR: {
+            resolveForIndexes(resolver, &expr->asFor);
+            return false;
+        }
+        case AST_INDEX: {
+            resolveIndex(resolver, &expr->asIndex);
+            return true;
+        }
+        case AST_PROPERTY_ACCESS: {
+            // the length of a fixed array or vector is a constant
+            AstExpr *object = expr->asProperty.object;
+            if (strcmp(expr->asProperty.property, "len") != 0 || object->type != AST_IDENTIFIER) return true;
+
+            TypeExpr type;
+            if (!findVariableType(resolver, object->asIdentifier.name, &type) || !fixedLength(type)) return true;
+
+            replaceExpr(expr, newIntegerExpr(fixedLength(type)));
+            return false;
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+static void resolveIndexes(Analyzer *analyzer, AstExpr *expr) {
+    IndexResolver resolver = {
+        .analyzer = analyzer,
+        .loops = malloc(sizeof(ForStatement *)),
+        .loopCount = 0,
+        .loopCapacity = 1,
+        .variables = malloc(sizeof(ScopedVariable)),
+        .variableCount = 0,
+        .variableCapacity = 1,
+    };
+
+    walkExpr(expr, indexVisitor, &resolver);
+
+    free(resolver.loops);
+    free(resolver.variables);
+}
+
+static bool vectorVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            checkVectorType(analyzer, expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            checkVectorType(analyzer, expr->asStructField.type);
+            break;
+        }
+        case AST_FOR: {
+            checkVectorType(analyzer, expr->asFor.type);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            checkVectorType(analyzer, expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                checkVectorType(analyzer, expr->asFunction.parameters[i].type);
+            }
+            break;
+        }
+        case AST_CALL_EXPR: {
+            CallExpr call = expr->asCallExpr;
+
+            VectorType vector;
+            VectorBuiltin builtin;
+            if (!lookupVectorBuiltin(call.name, &vector, &builtin)) break;
+
+            int expected = vectorBuiltinArgCount(builtin);
+            if (call.argCount != expected) {
+                raiseBuiltinArguments(analyzer, call.name, expected, call.argCount);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// checks the argument counts of the 'Arena' and 'Pool' builtins
+static bool allocatorVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+    if (expr->type != AST_CALL_EXPR) return true;
+
+    CallExpr call = expr->asCallExpr;
+
+    int expected;
+    ArenaBuiltin arenaBuiltin;
+    PoolBuiltin poolBuiltin;
+    if (lookupArenaBuiltin(call.name, &arenaBuiltin)) {
+        expected = arenaBuiltinArgCount(arenaBuiltin);
+    } else if (lookupPoolBuiltin(call.name, &poolBuiltin)) {
+        expected = poolBuiltinArgCount(poolBuiltin);
+    } else {
+        return true;
+    }
+
+    if (call.argCount != expected) {
+        raiseBuiltinArguments(analyzer, call.name, expected, call.argCount);
+    }
+
+    return true;
+}
+
+// the type an array literal passed as argument 'index' of 'call' takes from the parameter,
+// false when the parameter cannot be built from one
+static bool arrayArgumentType(Analyzer *analyzer, CallExpr call, int index, TypeExpr *type) {
+    VectorType vector;
+    VectorBuiltin builtin;
+    if (lookupVectorBuiltin(call.name, &vector, &builtin)) {
+        if (index >= vectorBuiltinArgCount(builtin)) return false;
+
+        VectorParameter parameter = vectorBuiltinParameter(builtin, index);
+        if (parameter == VECTOR_PARAMETER_ELEMENT) return false;
+        if (parameter == VECTOR_PARAMETER_MASK) vector = vectorMaskType(vector);
+
+        char name[16];
+        snprintf(name, sizeof(name), "v%d%s", vector.lanes, vector.element);
+
+        *type = (TypeExpr){ strdup(parameter == VECTOR_PARAMETER_POINTER ? vector.element : name), 0, 0, false, NULL, 0 };
+        if (parameter == VECTOR_PARAMETER_POINTER) type->ptrDepth = 1;
+        return true;
+    }
+
+    Ast ast = analyzer->parser->ast;
+
+    AstExpr *callee = findFunction(ast, call.name);
+    if (!callee || index >= callee->asFunction.paramCount) return false;
+
+    TypeExpr parameter = callee->asFunction.parameters[index].type;
+
+    bool isVector = !parameter.ptrDepth && lookupVectorType(parameter.name, &vector);
+    bool isArray = parameter.arrayLength || parameter.ptrDepth || parameter.isSlice;
+    if (!isVector && (!isArray || isSoaType(ast, parameter))) return false;
+
+    *type = cloneType(parameter);
+    return true;
+}
+
+// the number of elements a parameter of 'type' can be built from, 0 when it takes any number
+static int arrayArgumentLength(TypeExpr type) {
+    if (type.arrayLength) return type.arrayLength;
+
+    VectorType vector;
+    if (!type.ptrDepth && !type.isSlice && lookupVectorType(type.name, &vector)) return vector.lanes;
+
+    return 0;
+}
+
+static bool arrayLiteralVisitor(AstExpr *expr, void *context);
+
+// walks the elements of 'expr' when it is an array literal which already has a type, otherwise 'expr' itself
+static void walkTypedArrayLiteral(Analyzer *analyzer, AstExpr *expr) {
+    if (!expr || expr->type != AST_ARRAY_LITERAL) {
+        walkExpr(expr, arrayLiteralVisitor, analyzer);
+        return;
+    }
+
+    for (int i = 0; i < expr->asArray.elementCount; i++) {
+        walkExpr(expr->asArray.elements[i], arrayLiteralVisitor, analyzer);
+    }
+}
+
+// a compile time function returning a fixed array may return a literal of it
+static bool arrayReturnVisitor(AstExpr *expr, void *context) {
+    if (expr->type != AST_RETURN) return arrayLiteralVisitor(expr, context);
+
+    walkTypedArrayLiteral(context, expr->asReturn.value);
+    return false;
+}
+
+// an array literal takes its type from the variable or struct field it initialises, or the parameter
+// it is passed to, anywhere else there is no type for it to become
+static bool arrayLiteralVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+
+    switch (expr->type) {
+        case AST_FUNCTION_DECLARATION: {
+            FunctionDeclaration function = expr->asFunction;
+            if (!function.returnType.arrayLength) return true;
+
+            if (function.isLambda) {
+                walkTypedArrayLiteral(analyzer, function.lambdaExpr);
+                return false;
+            }
+
+            for (int i = 0; i < function.block.count; i++) {
+                walkExpr(function.block.body[i], arrayReturnVisitor, analyzer);
+            }
+            return false;
+        }
+        case AST_LET: {
+            walkTypedArrayLiteral(analyzer, expr->asLet.value);
+            return false;
+        }
+        case AST_STRUCT_INITIALIZER: {
+            for (int i = 0; i < expr->asStructInit.fieldCount; i++) {
+                walkTypedArrayLiteral(analyzer, expr->asStructInit.fields[i].value);
+            }
+            return false;
+        }
+        case AST_CALL_EXPR: {
+            CallExpr call = expr->asCallExpr;
+
+            for (int i = 0; i < call.argCount; i++) {
+                AstExpr *argument = call.arguments[i];
+                if (argument->type != AST_ARRAY_LITERAL) continue;
+
+                ArrayLiteral *array = &argument->asArray;
+                freeType(array->type);
+
+                if (!arrayArgumentType(analyzer, call, i, &array->type)) {
+                    array->type = (TypeExpr){ NULL, 0, 0, false, NULL, 0 };
+                    raiseUntypedArrayLiteral(analyzer);
+                    continue;
+                }
+
+                int length = arrayArgumentLength(array->type);
+                if (length && array->elementCount > length) {
+                    raiseArrayArgumentTooLong(analyzer, call.name, i, array->elementCount, length);
+                }
+            }
+
+            walkExpr(call.receiver, arrayLiteralVisitor, analyzer);
+            for (int i = 0; i < call.argCount; i++) {
+                walkTypedArrayLiteral(analyzer, call.arguments[i]);
+            }
+            return false;
+        }
+        case AST_ARRAY_LITERAL: {
+            raiseUntypedArrayLiteral(analyzer);
+            return false;
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+static void checkAtomicType(Analyzer *analyzer, TypeExpr type) {
+    TypeExpr element;
+    if (!lookupAtomicType(type.name, &element)) return;
+
+    if (!isAtomicElementType(element)) raiseNotAtomicElement(analyzer, element.name);
+    free(element.name);
+}
+
+static void checkMemoryOrders(Analyzer *analyzer, CallExpr call, AtomicBuiltin builtin) {
+    for (int i = 0; i < call.argCount; i++) {
+        if (!isOrderingArgument(builtin, i)) continue;
+
+        AstExpr *argument = call.arguments[i];
+
+        MemoryOrder order;
+        if (argument->type != AST_IDENTIFIER || !lookupMemoryOrder(argument->asIdentifier.name, &order)) {
+            raiseNotMemoryOrder(analyzer, call.name);
+            continue;
+        }
+
+        if (!(allowedOrderings(builtin, i) & order)) {
+            raiseMemoryOrderNotAllowed(analyzer, call.name, argument->asIdentifier.name);
+        }
+    }
+}
+
+static bool atomicVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            checkAtomicType(analyzer, expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            checkAtomicType(analyzer, expr->asStructField.type);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            checkAtomicType(analyzer, expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                checkAtomicType(analyzer, expr->asFunction.parameters[i].type);
+            }
+            break;
+        }
+        case AST_CALL_EXPR: {
+            CallExpr call = expr->asCallExpr;
+
+            AtomicBuiltin builtin;
+            if (!lookupAtomicBuiltin(call.name, &builtin)) break;
+
+            int expected = atomicBuiltinArgCount(builtin);
+            if (call.argCount != expected) {
+                raiseBuiltinArguments(analyzer, call.name, expected, call.argCount);
+                break;
+            }
+
+            checkMemoryOrders(analyzer, call, builtin);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+typedef struct {
+    char *name;
+
+    // a pointer to an atomic rather than an atomic
+    bool  isPointer;
+} AtomicVariable;
+
+typedef struct {
+    Analyzer       *analyzer;
+
+    AtomicVariable *variables;
+    int             variableCount;
+    int             variableCapacity;
+
+    // identifiers whose address is taken, which is how an atomic is given to the builtins
+    AstExpr       **addressed;
+    int             addressedCount;
+    int             addressedCapacity;
+} AtomicAccess;
+
+static void addAtomicVariable(AtomicAccess *access, char *name, TypeExpr type) {
+    TypeExpr element;
+    if (type.arrayLength || type.isSlice || type.ptrDepth > 1 || !lookupAtomicType(type.name, &element)) return;
+    free(element.name);
+
+    if (access->variableCount >= access->variableCapacity) {
+        access->variableCapacity *= 2;
+        access->variables = realloc(access->variables, sizeof(AtomicVariable) * access->variableCapacity);
+    }
+    access->variables[access->variableCount++] = (AtomicVariable){ name, type.ptrDepth == 1 };
+}
+
+static AtomicVariable *findAtomicVariable(AtomicAccess *access, char *name) {
+    for (int i = 0; i < access->variableCount; i++) {
+        if (strcmp(access->variables[i].name, name) == 0) return &access->variables[i];
+    }
+
+    return NULL;
+}
+
+static bool atomicDeclarationVisitor(AstExpr *expr, void *context) {
+    AtomicAccess *access = context;
+
+    if (expr->type == AST_LET) {
+        addAtomicVariable(access, expr->asLet.name, expr->asLet.type);
+    }
+
+    if (expr->type == AST_UNARY && expr->asUnary.operator == OP_ADDRESS_OF && expr->asUnary.right->type == AST_IDENTIFIER) {
+        if (access->addressedCount >= access->addressedCapacity) {
+            access->addressedCapacity *= 2;
+            access->addressed = realloc(access->addressed, sizeof(AstExpr *) * access->addressedCapacity);
+        }
+        access->addressed[access->addressedCount++] = expr->asUnary.right;
+    }
+
+    return true;
+}
+
+static bool isAddressed(AtomicAccess *access, AstExpr *identifier) {
+    for (int i = 0; i < access->addressedCount; i++) {
+        if (access->addressed[i] == identifier) return true;
+    }
+
+    return false;
+}
+
+static bool atomicAccessVisitor(AstExpr *expr, void *context) {
+    AtomicAccess *access = context;
+
+    if (expr->type == AST_IDENTIFIER) {
+        AtomicVariable *variable = findAtomicVariable(access, expr->asIdentifier.name);
+        if (variable && !variable->isPointer && !isAddressed(access, expr)) {
+            raiseNonAtomicAccess(access->analyzer, variable->name);
+        }
+    }
+
+    if (expr->type == AST_UNARY && expr->asUnary.operator == OP_DEREF && expr->asUnary.right->type == AST_IDENTIFIER) {
+        AtomicVariable *variable = findAtomicVariable(access, expr->asUnary.right->asIdentifier.name);
+        if (variable && variable->isPointer) {
+            raiseNonAtomicDereference(access->analyzer, variable->name);
+        }
+    }
+
+    return true;
+}
+
+// an atomic is only read and written by the builtins, which are given its address,
+// any other use of it or a dereference of a pointer to one is a plain access and is rejected
+static void checkAtomicAccess(Analyzer *analyzer, AstExpr *function) {
+    AtomicAccess access = {
+        .analyzer = analyzer,
+        .variables = malloc(sizeof(AtomicVariable)),
+        .variableCount = 0,
+        .variableCapacity = 1,
+        .addressed = malloc(sizeof(AstExpr *)),
+        .addressedCount = 0,
+        .addressedCapacity = 1,
+    };
+
+    Ast ast = analyzer->parser->ast;
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type == AST_LET) {
+            addAtomicVariable(&access, ast.exprs[i]->asLet.name, ast.exprs[i]->asLet.type);
+        }
+    }
+
+    for (int i = 0; i < function->asFunction.paramCount; i++) {
+        FunctionParameter parameter = function->asFunction.parameters[i];
+        addAtomicVariable(&access, parameter.name, parameter.type);
+    }
+
+    walkExpr(function, atomicDeclarationVisitor, &access);
+    if (access.variableCount) walkExpr(function, atomicAccessVisitor, &access);
+
+    free(access.variables);
+    free(access.addressed);
+}
+
+typedef struct {
+    Analyzer *analyzer;
+    AstExpr  *function;
+} PoolSlots;
+
+static bool findPoolVariableType(PoolSlots *slots, char *name, TypeExpr *type) {
+    if (findLocalType(slots->function, name, type)) return true;
+
+    Ast ast = slots->analyzer->parser->ast;
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type != AST_LET || strcmp(ast.exprs[i]->asLet.name, name) != 0) continue;
+
+        *type = ast.exprs[i]->asLet.type;
+        return true;
+    }
+
+    return false;
+}
+
+// the slot type of the typed pool given to a builtin as '&nodes' or as a '*Pool<T>'
+static bool findPoolElement(PoolSlots *slots, AstExpr *pool, TypeExpr *element) {
+    int ptrDepth = 1;
+    if (pool->type == AST_UNARY && pool->asUnary.operator == OP_ADDRESS_OF) {
+        pool = pool->asUnary.right;
+        ptrDepth = 0;
+    }
+
+    TypeExpr type;
+    if (pool->type != AST_IDENTIFIER || !findPoolVariableType(slots, pool->asIdentifier.name, &type)) return false;
+    if (type.ptrDepth != ptrDepth || type.arrayLength || type.isSlice) return false;
+
+    return lookupPoolType(type.name, element);
+}
+
+// 'rawptr' is left unchecked, as it is in C
+static bool isPoolSlotType(TypeExpr type, TypeExpr element) {
+    if (type.arrayLength || type.isSlice) return false;
+    if (strcmp(type.name, "rawptr") == 0 && !type.ptrDepth) return true;
+
+    return strcmp(type.name, element.name) == 0 && type.ptrDepth == element.ptrDepth + 1;
+}
+
+// the name of the slot type as written, '*Node' for a 'Pool<*Node>'
+static char *poolElementName(TypeExpr element) {
+    char *name = malloc(strlen(element.name) + element.ptrDepth + 1);
+    memset(name, '*', element.ptrDepth);
+    strcpy(name + element.ptrDepth, element.name);
+
+    return name;
+}
+
+static void checkPoolSlot(PoolSlots *slots, char *name, TypeExpr type, AstExpr *value) {
+    if (value->type != AST_CALL_EXPR || strcmp(value->asCallExpr.name, "poolAlloc") != 0) return;
+    if (value->asCallExpr.argCount != 1) return;
+
+    TypeExpr element;
+    if (!findPoolElement(slots, value->asCallExpr.arguments[0], &element)) return;
+
+    if (!isPoolSlotType(type, element)) {
+        char *elementName = poolElementName(element);
+        raisePoolSlotType(slots->analyzer, name, elementName);
+        free(elementName);
+    }
+
+    free(element.name);
+}
+
+static void checkPoolSize(PoolSlots *slots, char *name, TypeExpr type, AstExpr *value) {
+    if (value->type != AST_CALL_EXPR || strcmp(value->asCallExpr.name, "poolNew") != 0) return;
+    if (value->asCallExpr.argCount != 2) return;
+
+    TypeExpr element;
+    if (type.ptrDepth || !lookupPoolType(type.name, &element)) return;
+
+    AstExpr *size = value->asCallExpr.arguments[0];
+    bool isElementSize = size->type == AST_UNARY && size->asUnary.operator == OP_SIZEOF
+        && size->asUnary.right->type == AST_IDENTIFIER && strcmp(size->asUnary.right->asIdentifier.name, element.name) == 0;
+
+    // there is no 'sizeof' for a pointer type, so a pool of pointers is not checked
+    if (!isElementSize && !element.ptrDepth) raisePoolSlotSize(slots->analyzer, name, element.name);
+    free(element.name);
+}
+
+static void checkPoolFree(PoolSlots *slots, CallExpr call) {
+    if (strcmp(call.name, "poolFree") != 0 || call.argCount != 2) return;
+
+    AstExpr *slot = call.arguments[1];
+    TypeExpr type;
+    if (slot->type != AST_IDENTIFIER || !findPoolVariableType(slots, slot->asIdentifier.name, &type)) return;
+
+    TypeExpr element;
+    if (!findPoolElement(slots, call.arguments[0], &element)) return;
+
+    if (!isPoolSlotType(type, element)) {
+        char *elementName = poolElementName(element);
+        raisePoolFreeType(slots->analyzer, slot->asIdentifier.name, elementName);
+        free(elementName);
+    }
+
+    free(element.name);
+}
+
+static bool poolSlotVisitor(AstExpr *expr, void *context) {
+    PoolSlots *slots = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            if (!expr->asLet.value) break;
+
+            checkPoolSlot(slots, expr->asLet.name, expr->asLet.type, expr->asLet.value);
+            checkPoolSize(slots, expr->asLet.name, expr->asLet.type, expr->asLet.value);
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            AssignmentExpr assign = expr->asAssign;
+
+            TypeExpr type;
+            if (assign.target || assign.ptrDepth || !findPoolVariableType(slots, assign.name, &type)) break;
+
+            checkPoolSlot(slots, assign.name, type, assign.value);
+            checkPoolSize(slots, assign.name, type, assign.value);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            checkPoolFree(slots, expr->asCallExpr);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// a 'Pool<T>' is a 'Pool' whose slots are known to hold a 'T', so the slots handed out,
+// the slots given back and the slot size it is made with are checked against 'T'
+static void checkPoolSlots(Analyzer *analyzer, AstExpr *function) {
+    PoolSlots slots = { analyzer, function };
+    walkExpr(function, poolSlotVisitor, &slots);
+}
+
+static void checkNotSpawned(Analyzer *analyzer, AstExpr *expr) {
+    if (expr && expr->type == AST_CALL_EXPR && expr->asCallExpr.isSpawned) {
+        raiseMisplacedSpawn(analyzer, expr->asCallExpr.name);
+    }
+}
+
+// the result of a spawned call is only there after 'sync', so it can only be stored in a variable
+// and never used within an expression
+static bool spawnVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+
+    switch (expr->type) {
+        case AST_BINARY: {
+            checkNotSpawned(analyzer, expr->asBinary.left);
+            checkNotSpawned(analyzer, expr->asBinary.right);
+            break;
+        }
+        case AST_UNARY: {
+            checkNotSpawned(analyzer, expr->asUnary.right);
+            break;
+        }
+        case AST_GROUPING: {
+            checkNotSpawned(analyzer, expr->asGrouping.expression);
+            break;
+        }
+        case AST_TERNARY: {
+            checkNotSpawned(analyzer, expr->asTernary.condition);
+            checkNotSpawned(analyzer, expr->asTernary.trueExpr);
+            checkNotSpawned(analyzer, expr->asTernary.falseExpr);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            for (int i = 0; i < expr->asCallExpr.argCount; i++) {
+                checkNotSpawned(analyzer, expr->asCallExpr.arguments[i]);
+            }
+            break;
+        }
+        case AST_INDEX: {
+            checkNotSpawned(analyzer, expr->asIndex.object);
+            checkNotSpawned(analyzer, expr->asIndex.index);
+            break;
+        }
+        case AST_RETURN: {
+            checkNotSpawned(analyzer, expr->asReturn.value);
+            break;
+        }
+        case AST_IF: {
+            checkNotSpawned(analyzer, expr->asIf.condition);
+            break;
+        }
+        case AST_WHILE: {
+            checkNotSpawned(analyzer, expr->asWhile.condition);
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            // only a plain variable is written by the task
+            if (expr->asAssign.target || expr->asAssign.ptrDepth) checkNotSpawned(analyzer, expr->asAssign.value);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            if (expr->asFunction.isLambda) checkNotSpawned(analyzer, expr->asFunction.lambdaExpr);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// describes the memory a pointer argument reaches, 'p' for a pointer variable and '&a.b[]' for an
+// address, indexes are left out as they may be equal, false when it cannot be told
+static bool describePointer(AstExpr *expr, char *place, size_t size) {
+    switch (expr->type) {
+        case AST_GROUPING: {
+            return describePointer(expr->asGrouping.expression, place, size);
+        }
+        case AST_IDENTIFIER: {
+            snprintf(place, size, "%s", expr->asIdentifier.name);
+            return true;
+        }
+        case AST_PROPERTY_ACCESS: {
+            if (!describePointer(expr->asProperty.object, place, size)) return false;
+
+            size_t length = strlen(place);
+            snprintf(place + length, size - length, ".%s", expr->asProperty.property);
+            return true;
+        }
+        case AST_INDEX: {
+            if (!describePointer(expr->asIndex.object, place, size)) return false;
+
+            size_t length = strlen(place);
+            snprintf(place + length, size - length, "[]");
+            return true;
+        }
+        case AST_UNARY: {
+            if (expr->asUnary.operator != OP_ADDRESS_OF || expr->asUnary.right->type == AST_UNARY) return false;
+
+            place[0] = '&';
+            return describePointer(expr->asUnary.right, place + 1, size - 1);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// '&a' reaches '&a.b' and '&a[]', so either of them being written could be seen through the other
+static bool isOverlapping(char *first, char *second) {
+    size_t firstLength = strlen(first);
+    size_t secondLength = strlen(second);
+
+    if (firstLength > secondLength) return isOverlapping(second, first);
+    if (strncmp(first, second, firstLength) != 0) return false;
+
+    char next = second[firstLength];
+    return next == '\0' || (first[0] == '&' && (next == '.' || next == '['));
+}
+
+// a best effort check that two pointer arguments are not the same memory when either parameter is '@noalias'
+static bool noAliasVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+    if (expr->type != AST_CALL_EXPR) return true;
+
+    AstExpr *callee = findFunction(analyzer->parser->ast, expr->asCallExpr.name);
+    if (!callee) return true;
+
+    FunctionDeclaration function = callee->asFunction;
+    int count = function.paramCount < expr->asCallExpr.argCount ? function.paramCount : expr->asCallExpr.argCount;
+
+    for (int i = 0; i < count; i++) {
+        FunctionParameter first = function.parameters[i];
+        if (!isPointerParameter(first)) continue;
+
+        char firstPlace[256];
+        if (!describePointer(expr->asCallExpr.arguments[i], firstPlace, sizeof(firstPlace))) continue;
+
+        for (int j = i + 1; j < count; j++) {
+            FunctionParameter second = function.parameters[j];
+            if (!isPointerParameter(second)) continue;
+            if (!hasTag(first.tags, TAG_NOALIAS) && !hasTag(second.tags, TAG_NOALIAS)) continue;
+
+            char secondPlace[256];
+            if (!describePointer(expr->asCallExpr.arguments[j], secondPlace, sizeof(secondPlace))) continue;
+
+            if (isOverlapping(firstPlace, secondPlace)) {
+                raiseAliasedArguments(analyzer, function.name, first.name, second.name);
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool soaVisitor(AstExpr *expr, void *context) {
+    Analyzer *analyzer = context;
+    Ast ast = analyzer->parser->ast;
+
+    switch (expr->type) {
+        case AST_STRUCT_DECLARATION: {
+            StructDeclaration declaration = expr->asStruct;
+            if (!hasTag(declaration.tags, TAG_SOA)) break;
+
+            for (int i = 0; i < declaration.memberCount; i++) {
+                if (declaration.members[i]->type != AST_STRUCT_FIELD) continue;
+
+                StructField field = declaration.members[i]->asStructField;
+                if (field.type.arrayLength) raiseSoaArrayField(analyzer, declaration.name, field.name);
+            }
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            FunctionDeclaration function = expr->asFunction;
+
+            for (int i = 0; i < function.paramCount; i++) {
+                TypeExpr type = function.parameters[i].type;
+                if (type.arrayLength && isSoaType(ast, type)) raiseSoaArrayParameter(analyzer, function.parameters[i].name);
+            }
+            break;
+        }
+        case AST_UNARY: {
+            AstExpr *operand = expr->asUnary.right;
+            if (expr->asUnary.operator != OP_ADDRESS_OF || operand->type != AST_INDEX) break;
+
+            IndexExpr index = operand->asIndex;
+            if (index.index->type != AST_RANGE && isSoaType(ast, index.objectType)) {
+                raiseSoaElementAddress(analyzer, index.object->asIdentifier.name);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// runs checks which need every declaration in the program to be known
+static void analyzeProgram(Analyzer *analyzer) {
+    Ast ast = analyzer->parser->ast;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        walkExpr(expr, divisionByZeroVisitor, analyzer);
+        walkExpr(expr, vectorVisitor, analyzer);
+        walkExpr(expr, allocatorVisitor, analyzer);
+        walkExpr(expr, arrayLiteralVisitor, analyzer);
+        walkExpr(expr, atomicVisitor, analyzer);
+        walkExpr(expr, spawnVisitor, analyzer);
+
+        if (expr->type != AST_STRUCT_DECLARATION) {
+            resolveIndexes(analyzer, expr);
+        }
+
+        walkExpr(expr, soaVisitor, analyzer);
+        walkExpr(expr, noAliasVisitor, analyzer);
+
+        if (expr->type == AST_FUNCTION_DECLARATION) {
+            checkFunctionTags(analyzer, expr);
+            checkAtomicAccess(analyzer, expr);
+            checkPoolSlots(analyzer, expr);
+            markLocalWrites(analyzer, expr);
+        }
+
+        if (expr->type != AST_STRUCT_DECLARATION) continue;
+
+        for (int j = 0; j < expr->asStruct.memberCount; j++) {
+            if (expr->asStruct.members[j]->type == AST_FUNCTION_DECLARATION) {
+                resolveIndexes(analyzer, expr->asStruct.members[j]);
+                checkFunctionTags(analyzer, expr->asStruct.members[j]);
+                checkAtomicAccess(analyzer, expr->asStruct.members[j]);
+                checkPoolSlots(analyzer, expr->asStruct.members[j]);
+                markLocalWrites(analyzer, expr->asStruct.members[j]);
+            }
+        }
+    }
+}
+
+static void tagParameters(AstExpr *function) {
+    for (int i = 0; i < function->asFunction.paramCount; i++) {
+        FunctionParameter *parameter = &function->asFunction.parameters[i];
+        if (isPointerParameter(*parameter)) parameter->tags |= TAG_NOALIAS;
+    }
+}
+
+// '--noalias' makes every pointer parameter '@noalias'
+static void tagPointerParameters(Ast ast) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+        if (expr->type == AST_FUNCTION_DECLARATION) tagParameters(expr);
+
+        if (expr->type != AST_STRUCT_DECLARATION) continue;
+
+        for (int j = 0; j < expr->asStruct.memberCount; j++) {
+            if (expr->asStruct.members[j]->type == AST_FUNCTION_DECLARATION) tagParameters(expr->asStruct.members[j]);
+        }
+    }
+}
+
+void analyze(Analyzer *analyzer) {
+    if (analyzer->parser->ast.exprCount == 0 && !analyzer->isLibrary) {
+        raiseNoEntryPointErr(analyzer);
+        return;
+    }
+
+    // everything after works on the specializations, the generic declarations are gone
+    instantiateGenerics(analyzer);
+    if (analyzer->hadErr) return;
+
+    // method calls become plain calls before anything looks up the functions they name
+    resolveMethodCalls(analyzer);
+    if (analyzer->hadErr) return;
+
+    if (analyzer->isNoAlias) tagPointerParameters(analyzer->parser->ast);
+
+    bool hasEntryPoint = false;
+    bool isPublicEntryPoint = false;
+    bool isInlineEntryPoint = false;
+    for (int i = 0; i < analyzer->parser->ast.exprCount; i++) {
+        AstExpr *expr = analyzer->parser->ast.exprs[i];
+
+        if (!hasEntryPoint && expr->type == AST_FUNCTION_DECLARATION) {
+            if (strcmp(expr->asFunction.name, "main") == 0) {
+                hasEntryPoint = true;
+
+                if (expr->asFunction.isPublic) {
+                    isPublicEntryPoint = true;
+                }
+
+                if (hasTag(expr->asFunction.tags, TAG_INLINE)) {
+                    isInlineEntryPoint = true;
+                }
+            }
+        }
+
+        analyzeExpr(analyzer, expr);
+    }
+
+    analyzeProgram(analyzer);
+
+    // libraries are linked into another program and do not need their own entry point
+    if (analyzer->isLibrary && !hasEntryPoint) return;
+
     if (!hasEntryPoint) {
         raiseNoEntryPointErr(analyzer);
     }
@@ -4,11 +4,6 @@
 #include "cli.h"
 #include "parse.h"
 
-typedef struct {
-    bool isConstant;
-    long value;
-} ConstEvalResult;
-
 typedef struct {
     char    *name;
     AstExpr *declaration;
@@ -31,14 +26,26 @@ typedef struct {
 
     bool        insideLoop;
 
+    // library builds are not required to define 'main'
+    bool        isLibrary;
+
+    // every pointer parameter is treated as '@noalias'
+    bool        isNoAlias;
+
     Parser     *parser;
     SymbolTable table;
 } Analyzer;
 
 
-Analyzer newAnalyzer(Parser *parser);
+Analyzer newAnalyzer(Parser *parser, bool isLibrary, bool isNoAlias);
 void freeAnalyzer(Analyzer *analyzer);
 
 void analyze(Analyzer *analyzer);
 
+// functions are resolved by name across the whole program, struct functions included
+AstExpr *findFunction(Ast ast, char *name);
+
+// whether 'function' can reach a call to itself, directly or through other functions
+bool isRecursive(Ast ast, AstExpr *function);
+
 #endif
\ No newline at end of file
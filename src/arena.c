@@ -0,0 +1,34 @@
+#include <string.h>
+
+#include "arena.h"
+
+typedef struct {
+    char *name;
+    int   argCount;
+} ArenaBuiltinInfo;
+
+// indexed by 'ArenaBuiltin'
+static ArenaBuiltinInfo builtins[] = {
+    { "arenaNew", 1 },
+    { "arenaAlloc", 2 },
+    { "arenaAllocAligned", 3 },
+    { "arenaReset", 1 },
+    { "arenaFree", 1 },
+};
+
+#define builtinCount (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+bool lookupArenaBuiltin(char *name, ArenaBuiltin *builtin) {
+    for (int i = 0; i < builtinCount; i++) {
+        if (strcmp(name, builtins[i].name) != 0) continue;
+
+        *builtin = (ArenaBuiltin)i;
+        return true;
+    }
+
+    return false;
+}
+
+int arenaBuiltinArgCount(ArenaBuiltin builtin) {
+    return builtins[builtin].argCount;
+}
@@ -0,0 +1,22 @@
+#ifndef arena_h
+#define arena_h
+
+#include <stdbool.h>
+
+// the chunk size of an arena made with 'arenaNew(0)'
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef enum {
+    ARENA_NEW,
+    ARENA_ALLOC,
+    ARENA_ALLOC_ALIGNED,
+    ARENA_RESET,
+    ARENA_FREE,
+} ArenaBuiltin;
+
+// whether 'name' is one of the builtins working on an 'Arena', such as 'arenaAlloc'
+bool lookupArenaBuiltin(char *name, ArenaBuiltin *builtin);
+
+int arenaBuiltinArgCount(ArenaBuiltin builtin);
+
+#endif
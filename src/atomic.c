@@ -0,0 +1,134 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "atomic.h"
+
+#define ATOMIC_PREFIX "atomic__"
+#define POINTER_SUFFIX "_ptr"
+
+#define ORDER_ANY (ORDER_RELAXED | ORDER_ACQUIRE | ORDER_RELEASE | ORDER_ACQ_REL | ORDER_SEQ_CST)
+#define ORDER_READ (ORDER_RELAXED | ORDER_ACQUIRE | ORDER_SEQ_CST)
+#define ORDER_WRITE (ORDER_RELAXED | ORDER_RELEASE | ORDER_SEQ_CST)
+
+typedef struct {
+    char       *name;
+    char       *cName;
+    int         argCount;
+
+    // the orderings come last, a compare exchange takes one for success and one for failure
+    int         orderingCount;
+    MemoryOrder allowed[2];
+} AtomicBuiltinInfo;
+
+// indexed by 'AtomicBuiltin'
+static AtomicBuiltinInfo builtins[] = {
+    { "atomicLoad", "atomic_load_explicit", 2, 1, { ORDER_READ } },
+    { "atomicStore", "atomic_store_explicit", 3, 1, { ORDER_WRITE } },
+    { "atomicExchange", "atomic_exchange_explicit", 3, 1, { ORDER_ANY } },
+    { "atomicCompareExchangeWeak", "atomic_compare_exchange_weak_explicit", 5, 2, { ORDER_ANY, ORDER_READ } },
+    { "atomicCompareExchangeStrong", "atomic_compare_exchange_strong_explicit", 5, 2, { ORDER_ANY, ORDER_READ } },
+    { "atomicFetchAdd", "atomic_fetch_add_explicit", 3, 1, { ORDER_ANY } },
+    { "atomicFetchSub", "atomic_fetch_sub_explicit", 3, 1, { ORDER_ANY } },
+    { "atomicFetchAnd", "atomic_fetch_and_explicit", 3, 1, { ORDER_ANY } },
+    { "atomicFetchOr", "atomic_fetch_or_explicit", 3, 1, { ORDER_ANY } },
+    { "atomicFence", "atomic_thread_fence", 1, 1, { ORDER_ANY } },
+};
+
+#define builtinCount (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+static struct { char *name; MemoryOrder order; } orders[] = {
+    { "relaxed", ORDER_RELAXED },
+    { "acquire", ORDER_ACQUIRE },
+    { "release", ORDER_RELEASE },
+    { "acq_rel", ORDER_ACQ_REL },
+    { "seq_cst", ORDER_SEQ_CST },
+};
+
+#define orderCount (int)(sizeof(orders) / sizeof(orders[0]))
+
+static char *elementTypes[] = {
+    "bool", "i8", "u8", "i16", "u16", "i32", "u32", "i64", "u64", "size", "rawptr",
+};
+
+#define elementTypeCount (int)(sizeof(elementTypes) / sizeof(elementTypes[0]))
+
+char *atomicTypeName(TypeExpr element) {
+    size_t length = strlen(ATOMIC_PREFIX) + strlen(element.name) + strlen(POINTER_SUFFIX) * element.ptrDepth + 1;
+
+    char *name = malloc(length);
+    strcpy(name, ATOMIC_PREFIX);
+    strcat(name, element.name);
+    for (int i = 0; i < element.ptrDepth; i++) strcat(name, POINTER_SUFFIX);
+
+    return name;
+}
+
+bool lookupAtomicType(char *name, TypeExpr *element) {
+    size_t prefixLength = strlen(ATOMIC_PREFIX);
+    if (!name || strncmp(name, ATOMIC_PREFIX, prefixLength) != 0) return false;
+
+    char *elementName = strdup(name + prefixLength);
+    size_t length = strlen(elementName);
+    size_t suffixLength = strlen(POINTER_SUFFIX);
+
+    uint8_t ptrDepth = 0;
+    while (length > suffixLength && strcmp(elementName + length - suffixLength, POINTER_SUFFIX) == 0) {
+        length -= suffixLength;
+        elementName[length] = '\0';
+        ptrDepth++;
+    }
+
+    *element = (TypeExpr){ .name = elementName, .ptrDepth = ptrDepth };
+    return true;
+}
+
+bool isAtomicElementType(TypeExpr element) {
+    if (element.arrayLength || element.isSlice) return false;
+    if (element.ptrDepth) return true;
+
+    for (int i = 0; i < elementTypeCount; i++) {
+        if (strcmp(element.name, elementTypes[i]) == 0) return true;
+    }
+
+    return false;
+}
+
+bool lookupAtomicBuiltin(char *name, AtomicBuiltin *builtin) {
+    for (int i = 0; i < builtinCount; i++) {
+        if (strcmp(name, builtins[i].name) != 0) continue;
+
+        *builtin = (AtomicBuiltin)i;
+        return true;
+    }
+
+    return false;
+}
+
+int atomicBuiltinArgCount(AtomicBuiltin builtin) {
+    return builtins[builtin].argCount;
+}
+
+char *atomicBuiltinCName(AtomicBuiltin builtin) {
+    return builtins[builtin].cName;
+}
+
+bool isOrderingArgument(AtomicBuiltin builtin, int index) {
+    AtomicBuiltinInfo info = builtins[builtin];
+    return index >= info.argCount - info.orderingCount && index < info.argCount;
+}
+
+MemoryOrder allowedOrderings(AtomicBuiltin builtin, int index) {
+    AtomicBuiltinInfo info = builtins[builtin];
+    return info.allowed[index - (info.argCount - info.orderingCount)];
+}
+
+bool lookupMemoryOrder(char *name, MemoryOrder *order) {
+    for (int i = 0; i < orderCount; i++) {
+        if (strcmp(name, orders[i].name) != 0) continue;
+
+        *order = orders[i].order;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,55 @@
+#ifndef atomic_h
+#define atomic_h
+
+#include <stdbool.h>
+
+#include "parse.h"
+
+typedef enum {
+    ATOMIC_LOAD,
+    ATOMIC_STORE,
+    ATOMIC_EXCHANGE,
+    ATOMIC_COMPARE_EXCHANGE_WEAK,
+    ATOMIC_COMPARE_EXCHANGE_STRONG,
+    ATOMIC_FETCH_ADD,
+    ATOMIC_FETCH_SUB,
+    ATOMIC_FETCH_AND,
+    ATOMIC_FETCH_OR,
+    ATOMIC_FENCE,
+} AtomicBuiltin;
+
+typedef enum {
+    ORDER_RELAXED = 1 << 0,
+    ORDER_ACQUIRE = 1 << 1,
+    ORDER_RELEASE = 1 << 2,
+    ORDER_ACQ_REL = 1 << 3,
+    ORDER_SEQ_CST = 1 << 4,
+} MemoryOrder;
+
+// the name 'atomic<T>' is given once resolved, 'atomic__i32' or 'atomic__Node_ptr' for 'atomic<*Node>'
+char *atomicTypeName(TypeExpr element);
+
+// whether 'name' is that of an atomic type, and the type it holds
+bool lookupAtomicType(char *name, TypeExpr *element);
+
+// atomics hold integers, bools and pointers
+bool isAtomicElementType(TypeExpr element);
+
+// whether 'name' is one of the builtins working on atomics, such as 'atomicLoad'
+bool lookupAtomicBuiltin(char *name, AtomicBuiltin *builtin);
+
+int atomicBuiltinArgCount(AtomicBuiltin builtin);
+
+// the C11 function the builtin is emitted as, 'atomic_load_explicit'
+char *atomicBuiltinCName(AtomicBuiltin builtin);
+
+// whether argument 'index' of the builtin is a memory ordering
+bool isOrderingArgument(AtomicBuiltin builtin, int index);
+
+// the orderings argument 'index' of the builtin can be given
+MemoryOrder allowedOrderings(AtomicBuiltin builtin, int index);
+
+// whether 'name' is one of 'relaxed', 'acquire', 'release', 'acq_rel' or 'seq_cst'
+bool lookupMemoryOrder(char *name, MemoryOrder *order);
+
+#endif
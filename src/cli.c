@@ -33,8 +33,38 @@ static inline char *readFile(char *path) {
     return buff;
 }
 
-void runC() {
-    int code = system("gcc out.c -o out && ./out");
+void runC(AsterCompiler *compiler) {
+    AsterConfig config = compiler->config;
+
+    // the debug dumps are still buffered when stdout is a pipe, so flush them
+    // before the program's own output
+    fflush(stdout);
+
+    // functions taking vectors are internal, so GCC's note that 32 and 64 byte vectors
+    // are passed differently without AVX is not about any ABI that matters
+    char flags[64];
+    snprintf(flags, sizeof(flags), "%s -Wno-psabi%s%s",
+        config.isRelease ? "-O2" : "-O0",
+        compiler->usesOpenMP ? " -fopenmp" : compiler->usesOpenMPSimd ? " -fopenmp-simd" : "",
+        compiler->usesThreads ? " -pthread" : ""
+    );
+
+    char command[128];
+    if (config.isLibrary) {
+        snprintf(command, sizeof(command), "gcc %s -c out.c -o out.o", flags);
+
+        int code = system(command);
+        if (code != 0) {
+            fprintf(stderr, "compilation failed\n");
+        }
+
+        system("rm out.c");
+        return;
+    }
+
+    snprintf(command, sizeof(command), "gcc %s out.c -o out && ./out", flags);
+
+    int code = system(command);
     if (code != 0) {
         fprintf(stderr, "compilation or execution failed\n");
     }
@@ -44,20 +74,33 @@ void runC() {
 }
 
 
-ExecResult runFromSource(char *path) {
+// the numbers come from the C compiler itself, through 'sizeof' and 'offsetof'
+static void runLayoutReport() {
+    int code = system("gcc -w layout.c -o layout && ./layout");
+    if (code != 0) {
+        fprintf(stderr, "layout report failed\n");
+    }
+
+    system("rm -f layout layout.c out.c");
+}
+
+ExecResult runFromSource(char *path, AsterConfig config) {
     char *source = readFile(path);
     if (!source) return EXEC_FAIL;
 
-    AsterConfig config = {
-        .lexerDebug = true,
-        .parserDebug = true,
-        .path = path
-    };
+    config.lexerDebug = true;
+    config.parserDebug = true;
+    config.path = path;
 
     AsterCompiler aster = newCompiler(source, config);
     ExecResult result = compileToC(&aster);
 
-    runC();
+    if (config.isLayoutReport) {
+        if (result == EXEC_OK) runLayoutReport();
+        return result;
+    }
+
+    runC(&aster);
 
     return EXEC_OK;
 }
@@ -100,7 +143,7 @@ ExecResult runCreate(char *projectName) {
     return EXEC_OK;
 }
 
-ExecResult runProject() {
+ExecResult runProject(AsterConfig config) {
     FILE *fptr = fopen("aster.yaml", "r");
     if (!fptr) {
         fprintf(stderr, "unable to find 'aster.yaml'\n");
@@ -111,11 +154,7 @@ ExecResult runProject() {
     char *source = readFile("srcc/main.ast");
     if (!source) return EXEC_FAIL;
 
-    AsterConfig config = {
-        .lexerDebug = false,
-        .parserDebug = false,
-        .path = "srcc/main.ast"
-    };
+    config.path = "srcc/main.ast";
 
     AsterCompiler aster = newCompiler(source, config);
     ExecResult result = compileToC(&aster);
@@ -123,11 +162,33 @@ ExecResult runProject() {
     return result;
 }
 
+// reads the integer value of the option at 'argv[*i]', advancing past it
+static bool parseIntOption(int argc, char **argv, int *i, int *value) {
+    if (*i + 1 >= argc) {
+        fprintf(stderr, "expected argument after '%s'\n", argv[*i]);
+        return false;
+    }
+
+    char *end = NULL;
+    long parsed = strtol(argv[*i + 1], &end, 10);
+    if (*end != '\0' || parsed < 0) {
+        fprintf(stderr, "expected a non-negative integer after '%s'\n", argv[*i]);
+        return false;
+    }
+
+    *value = (int)parsed;
+    (*i)++;
+
+    return true;
+}
+
 ExecResult runCli(int argc, char **argv) {
     bool isRepl = false;
     bool isFile = false;
     char *path = NULL;
 
+    AsterConfig config = newConfig();
+
     if (argc < 2) {
         fprintf(stderr, "usage: aster <command>\n");
         return EXEC_FAIL;
@@ -140,12 +201,26 @@ ExecResult runCli(int argc, char **argv) {
         }
 
         return runCreate(argv[2]);
-    } else if (strcmp(argv[1], "run") == 0) {
-        return runProject();
     }
 
     for (int i = 0; i < argc; i++) {
-        if (strcmp(argv[i], "--repl") == 0) {
+        if (strcmp(argv[i], "--inline-size") == 0) {
+            if (!parseIntOption(argc, argv, &i, &config.inlineMaxNodes)) return EXEC_FAIL;
+        } else if (strcmp(argv[i], "--inline-depth") == 0) {
+            if (!parseIntOption(argc, argv, &i, &config.inlineMaxDepth)) return EXEC_FAIL;
+        } else if (strcmp(argv[i], "--comptime-steps") == 0) {
+            if (!parseIntOption(argc, argv, &i, &config.comptimeMaxSteps)) return EXEC_FAIL;
+        } else if (strcmp(argv[i], "--comptime-depth") == 0) {
+            if (!parseIntOption(argc, argv, &i, &config.comptimeMaxDepth)) return EXEC_FAIL;
+        } else if (strcmp(argv[i], "--lib") == 0) {
+            config.isLibrary = true;
+        } else if (strcmp(argv[i], "--release") == 0) {
+            config.isRelease = true;
+        } else if (strcmp(argv[i], "--layout-report") == 0) {
+            config.isLayoutReport = true;
+        } else if (strcmp(argv[i], "--noalias") == 0) {
+            config.isNoAlias = true;
+        } else if (strcmp(argv[i], "--repl") == 0) {
             isRepl = true;
         } else if (strcmp(argv[i], "--path") == 0) {
             isFile = true;
@@ -159,6 +234,10 @@ ExecResult runCli(int argc, char **argv) {
         }
     }
 
+    if (strcmp(argv[1], "run") == 0) {
+        return runProject(config);
+    }
+
     if (isFile && isRepl) {
         fprintf(stderr, "invalid flag combination, '--repl' and '--path'\n");
         return EXEC_FAIL;
@@ -170,7 +249,7 @@ ExecResult runCli(int argc, char **argv) {
     }
 
     if (isFile) {
-        return runFromSource(path);
+        return runFromSource(path, config);
     } else if (isRepl) {
         return runRepl();
     }
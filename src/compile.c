@@ -5,13 +5,41 @@
 #include "tokenize.h"
 #include "parse.h"
 #include "analyze.h"
+#include "comptime.h"
+#include "inline.h"
+#include "fold.h"
+#include "reach.h"
 #include "transpile.h"
 
+AsterConfig newConfig() {
+    AsterConfig config;
+    config.lexerDebug = false;
+    config.parserDebug = false;
+    config.path = NULL;
+
+    config.inlineMaxNodes = DEFAULT_INLINE_MAX_NODES;
+    config.inlineMaxDepth = DEFAULT_INLINE_MAX_DEPTH;
+
+    config.comptimeMaxSteps = DEFAULT_COMPTIME_MAX_STEPS;
+    config.comptimeMaxDepth = DEFAULT_COMPTIME_MAX_DEPTH;
+
+    config.isLibrary = false;
+    config.isRelease = false;
+    config.isLayoutReport = false;
+    config.isNoAlias = false;
+
+    return config;
+}
+
 AsterCompiler newCompiler(char *source, AsterConfig config) {
     AsterCompiler compiler;
     compiler.source = source;
     compiler.config = config;
 
+    compiler.usesOpenMP = false;
+    compiler.usesOpenMPSimd = false;
+    compiler.usesThreads = false;
+
     return compiler;
 }
 
@@ -41,7 +69,7 @@ ExecResult compileToC(AsterCompiler *compiler) {
         return EXEC_COMPILE_ERR;
     }
 
-    Analyzer analyzer = newAnalyzer(&parser);
+    Analyzer analyzer = newAnalyzer(&parser, compiler->config.isLibrary, compiler->config.isNoAlias);
     analyze(&analyzer);
 
     if (analyzer.hadErr) {
@@ -52,15 +80,51 @@ ExecResult compileToC(AsterCompiler *compiler) {
         return EXEC_COMPILE_ERR;
     }
 
+    Interpreter interpreter = newInterpreter(&analyzer, compiler->config.comptimeMaxSteps, compiler->config.comptimeMaxDepth);
+    evaluateComptimeCalls(&interpreter);
+
+    if (analyzer.hadErr) {
+        freeParser(&parser);
+        freeLexer(&lexer);
+        freeAnalyzer(&analyzer);
+
+        return EXEC_COMPILE_ERR;
+    }
+
+    Inliner inliner = newInliner(parser.ast, compiler->config.inlineMaxNodes, compiler->config.inlineMaxDepth);
+    inlineFunctions(&inliner);
+
+    foldConstants(parser.ast);
+
+    Reachability reach = newReachability(parser.ast, compiler->config.isLibrary);
+    markReachable(&reach);
+
     FILE *fptr = fopen("out.c", "w");
     if (!fptr) {
         fprintf(stderr, "unable to open c source output\n");
         return EXEC_FAIL;
     }
 
-    Transpiler transpiler = newTranspiler(fptr, parser.ast);
+    Transpiler transpiler = newTranspiler(fptr, parser.ast, compiler->config.isRelease);
     transpile(&transpiler);
 
+    compiler->usesOpenMP = transpiler.usesOpenMP;
+    compiler->usesOpenMPSimd = transpiler.usesOpenMPSimd;
+    compiler->usesThreads = transpiler.usesThreads;
+
+    if (compiler->config.isLayoutReport) {
+        FILE *layoutFptr = fopen("layout.c", "w");
+        if (!layoutFptr) {
+            fprintf(stderr, "unable to open layout report output\n");
+            return EXEC_FAIL;
+        }
+
+        Transpiler layoutTranspiler = newTranspiler(layoutFptr, parser.ast, compiler->config.isRelease);
+        transpileLayoutReport(&layoutTranspiler);
+
+        fclose(layoutFptr);
+    }
+
     freeLexer(&lexer);
     freeParser(&parser);
     freeAnalyzer(&analyzer);
@@ -5,17 +5,52 @@
 
 #include "cli.h"
 
+#define DEFAULT_INLINE_MAX_NODES 16
+#define DEFAULT_INLINE_MAX_DEPTH 4
+
+#define DEFAULT_COMPTIME_MAX_STEPS 1000000
+#define DEFAULT_COMPTIME_MAX_DEPTH 256
+
 typedef struct {
     bool  lexerDebug;
     bool  parserDebug;
     char *path;
+
+    // thresholds for substituting arrow functions into their callers, 0 disables inlining
+    int   inlineMaxNodes;
+    int   inlineMaxDepth;
+
+    // limits on evaluating 'const fn' calls, 0 disables compile time evaluation
+    int   comptimeMaxSteps;
+    int   comptimeMaxDepth;
+
+    // library builds keep every 'pub' symbol and are compiled without being linked or run
+    bool  isLibrary;
+
+    // release builds are optimised and leave out the bounds checks the analyzer proved redundant
+    bool  isRelease;
+
+    // also writes a C program which prints the layout of every struct, rather than running the program
+    bool  isLayoutReport;
+
+    // treats every pointer parameter as '@noalias'
+    bool  isNoAlias;
 } AsterConfig;
 
 typedef struct {
     char          *source;
     AsterConfig config;
+
+    // set by 'compileToC' when the output uses OpenMP, '@parallel' needs the runtime
+    // while '@simd' only needs the pragmas to be understood
+    bool usesOpenMP;
+    bool usesOpenMPSimd;
+
+    // set when spawned calls run on the task runtime's worker threads
+    bool usesThreads;
 } AsterCompiler;
 
+AsterConfig newConfig();
 AsterCompiler newCompiler(char *source, AsterConfig config);
 ExecResult compileToC(AsterCompiler *compiler);
 
@@ -0,0 +1,808 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "comptime.h"
+#include "fold.h"
+#include "err.h"
+
+typedef struct {
+    char       *name;
+    char       *typeName;
+    ConstValue  value;
+
+    // the elements of a fixed array, 'value' is unused when these are set
+    ConstValue *elements;
+    int         length;
+} Variable;
+
+typedef struct {
+    Variable   *variables;
+    int         count;
+    int         capacity;
+
+    // the type of the function being run, a fixed array is returned through 'returnElements'
+    TypeExpr    returnType;
+    ConstValue  returnValue;
+    ConstValue *returnElements;
+} Frame;
+
+typedef enum {
+    FLOW_NORMAL,
+    FLOW_RETURN,
+    FLOW_STOP,
+    FLOW_NEXT,
+
+    // something was reached which cannot be evaluated at compile time
+    FLOW_FAILED,
+} Flow;
+
+static ConstValue evaluate(Interpreter *interpreter, Frame *frame, AstExpr *expr);
+static bool evaluateArray(Interpreter *interpreter, Frame *frame, AstExpr *expr, TypeExpr type, ConstValue *elements);
+static Flow execute(Interpreter *interpreter, Frame *frame, AstExpr *statement);
+
+Interpreter newInterpreter(Analyzer *analyzer, int maxSteps, int maxDepth) {
+    Interpreter interpreter;
+    interpreter.analyzer = analyzer;
+
+    interpreter.maxSteps = maxSteps;
+    interpreter.maxDepth = maxDepth;
+
+    interpreter.steps = 0;
+    interpreter.depth = 0;
+
+    interpreter.exceededSteps = false;
+    interpreter.exceededDepth = false;
+
+    return interpreter;
+}
+
+static Frame newFrame(TypeExpr returnType) {
+    Frame frame;
+    frame.variables = malloc(sizeof(Variable));
+    frame.count = 0;
+    frame.capacity = 1;
+
+    frame.returnType = returnType;
+    frame.returnElements = NULL;
+
+    if (!frame.variables) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    return frame;
+}
+
+static ConstValue *newElements(int length) {
+    ConstValue *elements = malloc(sizeof(ConstValue) * length);
+    if (!elements) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    return elements;
+}
+
+static ConstValue newFailure() {
+    return (ConstValue){ .isConstant = false };
+}
+
+// the value of an 'int' literal
+static ConstValue newIntConstant(uint64_t bits) {
+    return (ConstValue){ .isConstant = true, .bits = bits, .kind = { 32, true } };
+}
+
+static void declareVariable(Frame *frame, char *name, char *typeName, ConstValue value) {
+    if (frame->count >= frame->capacity) {
+        frame->capacity *= 2;
+        frame->variables = realloc(frame->variables, sizeof(Variable) * frame->capacity);
+    }
+
+    frame->variables[frame->count++] = (Variable){ .name = name, .typeName = typeName, .value = value };
+}
+
+// the frame owns 'elements' from here on
+static void declareArray(Frame *frame, char *name, TypeExpr type, ConstValue *elements) {
+    declareVariable(frame, name, type.name, newFailure());
+
+    frame->variables[frame->count - 1].elements = elements;
+    frame->variables[frame->count - 1].length = type.arrayLength;
+}
+
+// drops the variables declared after 'count', such as those of a block which has ended
+static void leaveScope(Frame *frame, int count) {
+    while (frame->count > count) {
+        free(frame->variables[--frame->count].elements);
+    }
+}
+
+static void freeFrame(Frame *frame) {
+    leaveScope(frame, 0);
+
+    free(frame->variables);
+    free(frame->returnElements);
+}
+
+// searched from the most recent declaration so inner scopes shadow outer ones
+static Variable *findVariable(Frame *frame, char *name) {
+    for (int i = frame->count - 1; i >= 0; i--) {
+        if (strcmp(frame->variables[i].name, name) == 0) return &frame->variables[i];
+    }
+
+    return NULL;
+}
+
+static bool consumeStep(Interpreter *interpreter) {
+    if (++interpreter->steps <= interpreter->maxSteps) return true;
+
+    interpreter->exceededSteps = true;
+    return false;
+}
+
+// only integers and bools, and fixed arrays of them, exist at compile time
+static ConstValue convertToType(ConstValue value, TypeExpr type) {
+    if (type.ptrDepth != 0 || type.arrayLength || type.isSlice) return newFailure();
+
+    return castConstant(value, type.name);
+}
+
+static AstExpr *findGlobalConstant(Ast ast, char *name) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        if (expr->type == AST_LET && expr->asLet.isConstant && strcmp(expr->asLet.name, name) == 0) {
+            return expr;
+        }
+    }
+
+    return NULL;
+}
+
+static bool enterCall(Interpreter *interpreter) {
+    if (interpreter->depth >= interpreter->maxDepth) {
+        interpreter->exceededDepth = true;
+        return false;
+    }
+
+    interpreter->depth++;
+    return true;
+}
+
+static ConstValue evaluateIdentifier(Interpreter *interpreter, Frame *frame, char *name) {
+    Variable *variable = findVariable(frame, name);
+    if (variable) return variable->value;
+
+    AstExpr *global = findGlobalConstant(interpreter->analyzer->parser->ast, name);
+    if (!global) return newFailure();
+
+    // counted as a call so constants defined in terms of each other cannot loop forever
+    if (!enterCall(interpreter)) return newFailure();
+
+    Frame globalFrame = newFrame((TypeExpr){ 0 });
+    ConstValue value = evaluate(interpreter, &globalFrame, global->asLet.value);
+    freeFrame(&globalFrame);
+
+    interpreter->depth--;
+
+    return convertToType(value, global->asLet.type);
+}
+
+static Flow executeReturn(Interpreter *interpreter, Frame *frame, ReturnStatement returnStatement);
+
+static Flow executeFunction(Interpreter *interpreter, Frame *frame, FunctionDeclaration function) {
+    if (function.isLambda) {
+        return executeReturn(interpreter, frame, (ReturnStatement){ .value = function.lambdaExpr });
+    }
+
+    for (int i = 0; i < function.block.count; i++) {
+        Flow flow = execute(interpreter, frame, function.block.body[i]);
+        if (flow != FLOW_NORMAL) return flow;
+    }
+
+    // falling off the end of a function which returns a value is not a constant
+    return FLOW_FAILED;
+}
+
+static AstExpr *findComptimeFunction(Interpreter *interpreter, char *name) {
+    AstExpr *callee = findFunction(interpreter->analyzer->parser->ast, name);
+    if (!callee || !hasTag(callee->asFunction.tags, TAG_COMPTIME)) return NULL;
+
+    return callee;
+}
+
+// runs 'function' in 'calleeFrame', which the caller frees once it has taken the result
+static bool runCall(Interpreter *interpreter, Frame *frame, CallExpr call, FunctionDeclaration function, Frame *calleeFrame) {
+    if (function.paramCount != call.argCount) return false;
+
+    for (int i = 0; i < call.argCount; i++) {
+        FunctionParameter parameter = function.parameters[i];
+
+        ConstValue argument = convertToType(evaluate(interpreter, frame, call.arguments[i]), parameter.type);
+        if (!argument.isConstant) return false;
+
+        declareVariable(calleeFrame, parameter.name, parameter.type.name, argument);
+    }
+
+    if (!enterCall(interpreter)) return false;
+
+    Flow flow = executeFunction(interpreter, calleeFrame, function);
+    interpreter->depth--;
+
+    return flow == FLOW_RETURN;
+}
+
+static ConstValue evaluateCall(Interpreter *interpreter, Frame *frame, CallExpr call) {
+    AstExpr *callee = findComptimeFunction(interpreter, call.name);
+    if (!callee) return newFailure();
+
+    FunctionDeclaration function = callee->asFunction;
+
+    Frame calleeFrame = newFrame(function.returnType);
+    bool isReturned = runCall(interpreter, frame, call, function, &calleeFrame);
+
+    ConstValue result = calleeFrame.returnValue;
+    freeFrame(&calleeFrame);
+
+    if (!isReturned) return newFailure();
+
+    return convertToType(result, function.returnType);
+}
+
+// the array a call returns is only taken when it has the type it is wanted as
+static bool evaluateArrayCall(Interpreter *interpreter, Frame *frame, CallExpr call, TypeExpr type, ConstValue *elements) {
+    AstExpr *callee = findComptimeFunction(interpreter, call.name);
+    if (!callee) return false;
+
+    FunctionDeclaration function = callee->asFunction;
+
+    TypeExpr returnType = function.returnType;
+    if (returnType.arrayLength != type.arrayLength || returnType.ptrDepth || strcmp(returnType.name, type.name) != 0) {
+        return false;
+    }
+
+    Frame calleeFrame = newFrame(returnType);
+    bool isReturned = runCall(interpreter, frame, call, function, &calleeFrame);
+
+    if (isReturned) {
+        memcpy(elements, calleeFrame.returnElements, sizeof(ConstValue) * type.arrayLength);
+    }
+
+    freeFrame(&calleeFrame);
+    return isReturned;
+}
+
+static Variable *findArray(Frame *frame, AstExpr *expr) {
+    if (expr->type != AST_IDENTIFIER) return NULL;
+
+    Variable *variable = findVariable(frame, expr->asIdentifier.name);
+    if (!variable || !variable->elements) return NULL;
+
+    return variable;
+}
+
+// an array literal leaves the elements it does not give as zero, the same as in C
+static bool evaluateArrayLiteral(Interpreter *interpreter, Frame *frame, ArrayLiteral array, TypeExpr type, ConstValue *elements) {
+    if (array.elementCount > type.arrayLength) return false;
+
+    ConstValue zero = castConstant(newIntConstant(0), type.name);
+
+    for (int i = 0; i < type.arrayLength; i++) {
+        elements[i] = i < array.elementCount ? castConstant(evaluate(interpreter, frame, array.elements[i]), type.name) : zero;
+        if (!elements[i].isConstant) return false;
+    }
+
+    return true;
+}
+
+// fills the 'type.arrayLength' elements of a fixed array from a literal, another array or a call
+static bool evaluateArray(Interpreter *interpreter, Frame *frame, AstExpr *expr, TypeExpr type, ConstValue *elements) {
+    if (!expr || !consumeStep(interpreter)) return false;
+
+    switch (expr->type) {
+        case AST_ARRAY_LITERAL: {
+            return evaluateArrayLiteral(interpreter, frame, expr->asArray, type, elements);
+        }
+        case AST_IDENTIFIER: {
+            Variable *array = findArray(frame, expr);
+            if (!array || array->length != type.arrayLength || strcmp(array->typeName, type.name) != 0) return false;
+
+            memcpy(elements, array->elements, sizeof(ConstValue) * type.arrayLength);
+            return true;
+        }
+        case AST_CALL_EXPR: {
+            return evaluateArrayCall(interpreter, frame, expr->asCallExpr, type, elements);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// the position of 'index' in 'array', or -1 when it is not a constant within its bounds
+static int64_t evaluateArrayPosition(Interpreter *interpreter, Frame *frame, Variable *array, AstExpr *index) {
+    if (index->type == AST_RANGE) return -1;
+
+    ConstValue position = evaluate(interpreter, frame, index);
+    if (!position.isConstant) return -1;
+
+    int64_t value = constantAsSigned(position);
+    if (!position.kind.isSigned && position.bits > INT64_MAX) return -1;
+    if (value < 0 || value >= array->length) return -1;
+
+    return value;
+}
+
+static ConstValue evaluateIndex(Interpreter *interpreter, Frame *frame, IndexExpr index) {
+    Variable *array = findArray(frame, index.object);
+    if (!array) return newFailure();
+
+    int64_t position = evaluateArrayPosition(interpreter, frame, array, index.index);
+    if (position < 0) return newFailure();
+
+    return array->elements[position];
+}
+
+static ConstValue evaluateBinaryExpr(Interpreter *interpreter, Frame *frame, BinaryExpr binary) {
+    if (binary.operator == OP_AS_CAST) {
+        if (binary.right->type != AST_IDENTIFIER) return newFailure();
+
+        ConstValue value = evaluate(interpreter, frame, binary.left);
+        return castConstant(value, binary.right->asIdentifier.name);
+    }
+
+    ConstValue left = evaluate(interpreter, frame, binary.left);
+    if (!left.isConstant) return left;
+
+    // the right operand must not be evaluated when the left decides the result
+    if (binary.operator == OP_AND && left.bits == 0) return applyBinaryOperator(OP_AND, left, left);
+    if (binary.operator == OP_OR && left.bits != 0) return applyBinaryOperator(OP_OR, left, left);
+
+    return applyBinaryOperator(binary.operator, left, evaluate(interpreter, frame, binary.right));
+}
+
+static ConstValue evaluate(Interpreter *interpreter, Frame *frame, AstExpr *expr) {
+    if (!expr || !consumeStep(interpreter)) return newFailure();
+
+    switch (expr->type) {
+        case AST_INTEGER_LITERAL:
+        case AST_BOOL_LITERAL:
+        case AST_CHAR_LITERAL: {
+            return evaluateConstant(expr);
+        }
+        case AST_IDENTIFIER: {
+            return evaluateIdentifier(interpreter, frame, expr->asIdentifier.name);
+        }
+        case AST_GROUPING: {
+            return evaluate(interpreter, frame, expr->asGrouping.expression);
+        }
+        case AST_UNARY: {
+            return applyUnaryOperator(expr->asUnary.operator, evaluate(interpreter, frame, expr->asUnary.right));
+        }
+        case AST_BINARY: {
+            return evaluateBinaryExpr(interpreter, frame, expr->asBinary);
+        }
+        case AST_TERNARY: {
+            ConstValue condition = evaluate(interpreter, frame, expr->asTernary.condition);
+            if (!condition.isConstant) return condition;
+
+            AstExpr *branch = condition.bits != 0 ? expr->asTernary.trueExpr : expr->asTernary.falseExpr;
+            return evaluate(interpreter, frame, branch);
+        }
+        case AST_MATCH: {
+            ConstValue subject = evaluate(interpreter, frame, expr->asMatch.expression);
+
+            MatchCaseExpr *selected = selectMatchCase(expr->asMatch, subject);
+            if (!selected) return newFailure();
+
+            return evaluate(interpreter, frame, selected->expression);
+        }
+        case AST_CALL_EXPR: {
+            return evaluateCall(interpreter, frame, expr->asCallExpr);
+        }
+        case AST_INDEX: {
+            return evaluateIndex(interpreter, frame, expr->asIndex);
+        }
+        default: {
+            return newFailure();
+        }
+    }
+}
+
+static Flow executeBlock(Interpreter *interpreter, Frame *frame, BlockExpr block) {
+    int scopeStart = frame->count;
+
+    Flow flow = FLOW_NORMAL;
+    for (int i = 0; i < block.count && flow == FLOW_NORMAL; i++) {
+        flow = execute(interpreter, frame, block.body[i]);
+    }
+
+    leaveScope(frame, scopeStart);
+    return flow;
+}
+
+static Flow executeWhile(Interpreter *interpreter, Frame *frame, WhileStatement whileStatement) {
+    while (true) {
+        ConstValue condition = evaluate(interpreter, frame, whileStatement.condition);
+        if (!condition.isConstant) return FLOW_FAILED;
+        if (condition.bits == 0) return FLOW_NORMAL;
+
+        Flow flow = executeBlock(interpreter, frame, whileStatement.block);
+        if (flow == FLOW_RETURN || flow == FLOW_FAILED) return flow;
+        if (flow == FLOW_STOP) return FLOW_NORMAL;
+
+        if (whileStatement.alteration) {
+            flow = execute(interpreter, frame, whileStatement.alteration);
+            if (flow != FLOW_NORMAL) return FLOW_FAILED;
+        }
+    }
+}
+
+// a range counts down when its step is negative, and stops before the loop variable would pass 'end'
+static Flow executeFor(Interpreter *interpreter, Frame *frame, ForStatement forStatement) {
+    if (forStatement.iterator->type != AST_RANGE) return FLOW_FAILED;
+    RangeExpr range = forStatement.iterator->asRange;
+
+    ConstValue start = evaluate(interpreter, frame, range.start);
+    ConstValue end = evaluate(interpreter, frame, range.end);
+    ConstValue step = range.step ? evaluate(interpreter, frame, range.step) : newIntConstant(1);
+    if (!start.isConstant || !end.isConstant || !step.isConstant) return FLOW_FAILED;
+
+    // without a type the loop variable takes the type C gives to 'start + end'
+    char *typeName = forStatement.type.name;
+    if (!typeName) typeName = integerKindName(applyBinaryOperator(OP_PLUS, start, end).kind);
+
+    bool isCountingDown = step.kind.isSigned && constantAsSigned(step) < 0;
+
+    OperatorType comparison = isCountingDown ? OP_GREATER_THAN : OP_LESS_THAN;
+    if (range.isInclusive) comparison = isCountingDown ? OP_GREATER_THAN_EQUALS : OP_LESS_THAN_EQUALS;
+
+    ConstValue next = castConstant(start, typeName);
+
+    while (true) {
+        ConstValue isInRange = applyBinaryOperator(comparison, next, end);
+        if (!isInRange.isConstant) return FLOW_FAILED;
+        if (isInRange.bits == 0) return FLOW_NORMAL;
+
+        ConstValue current = next;
+
+        int scopeStart = frame->count;
+        declareVariable(frame, forStatement.variable, typeName, current);
+
+        Flow flow = executeBlock(interpreter, frame, forStatement.block);
+        leaveScope(frame, scopeStart);
+
+        if (flow == FLOW_RETURN || flow == FLOW_FAILED) return flow;
+        if (flow == FLOW_STOP) return FLOW_NORMAL;
+
+        // stepped in a wider type so passing the end of a narrow one stops the loop instead of wrapping
+        next = applyBinaryOperator(OP_PLUS, current, step);
+        ConstValue hasWrapped = applyBinaryOperator(isCountingDown ? OP_GREATER_THAN : OP_LESS_THAN, next, current);
+        if (!next.isConstant || !hasWrapped.isConstant || hasWrapped.bits != 0) return FLOW_NORMAL;
+
+        isInRange = applyBinaryOperator(comparison, next, end);
+        if (!isInRange.isConstant || isInRange.bits == 0) return FLOW_NORMAL;
+
+        next = castConstant(next, typeName);
+    }
+}
+
+static Flow executeArrayLet(Interpreter *interpreter, Frame *frame, LetDeclaration let) {
+    ConstValue *elements = newElements(let.type.arrayLength);
+
+    if (!evaluateArray(interpreter, frame, let.value, let.type, elements)) {
+        free(elements);
+        return FLOW_FAILED;
+    }
+
+    declareArray(frame, let.name, let.type, elements);
+    return FLOW_NORMAL;
+}
+
+static Flow executeElementAssignment(Interpreter *interpreter, Frame *frame, AssignmentExpr assign) {
+    if (assign.target->type != AST_INDEX) return FLOW_FAILED;
+
+    Variable *array = findArray(frame, assign.target->asIndex.object);
+    if (!array) return FLOW_FAILED;
+
+    int64_t position = evaluateArrayPosition(interpreter, frame, array, assign.target->asIndex.index);
+    if (position < 0) return FLOW_FAILED;
+
+    ConstValue value = castConstant(evaluate(interpreter, frame, assign.value), array->typeName);
+    if (!value.isConstant) return FLOW_FAILED;
+
+    array->elements[position] = value;
+    return FLOW_NORMAL;
+}
+
+static Flow executeReturn(Interpreter *interpreter, Frame *frame, ReturnStatement returnStatement) {
+    if (!frame->returnType.arrayLength) {
+        frame->returnValue = evaluate(interpreter, frame, returnStatement.value);
+        return frame->returnValue.isConstant ? FLOW_RETURN : FLOW_FAILED;
+    }
+
+    ConstValue *elements = newElements(frame->returnType.arrayLength);
+
+    if (!evaluateArray(interpreter, frame, returnStatement.value, frame->returnType, elements)) {
+        free(elements);
+        return FLOW_FAILED;
+    }
+
+    free(frame->returnElements);
+    frame->returnElements = elements;
+    return FLOW_RETURN;
+}
+
+static Flow executeMatch(Interpreter *interpreter, Frame *frame, MatchExpr match) {
+    ConstValue subject = evaluate(interpreter, frame, match.expression);
+
+    MatchCaseExpr *selected = selectMatchCase(match, subject);
+    if (!selected) return FLOW_FAILED;
+
+    if (selected->expression->type == AST_BLOCK) {
+        return executeBlock(interpreter, frame, selected->expression->asBlock);
+    }
+
+    return execute(interpreter, frame, selected->expression);
+}
+
+static Flow execute(Interpreter *interpreter, Frame *frame, AstExpr *statement) {
+    if (!consumeStep(interpreter)) return FLOW_FAILED;
+
+    switch (statement->type) {
+        case AST_LET: {
+            LetDeclaration let = statement->asLet;
+            if (let.type.arrayLength) return executeArrayLet(interpreter, frame, let);
+
+            ConstValue value = convertToType(evaluate(interpreter, frame, let.value), let.type);
+            if (!value.isConstant) return FLOW_FAILED;
+
+            declareVariable(frame, let.name, let.type.name, value);
+            return FLOW_NORMAL;
+        }
+        case AST_ASSIGN_EXPR: {
+            AssignmentExpr assign = statement->asAssign;
+            if (assign.ptrDepth != 0) return FLOW_FAILED;
+            if (assign.target) return executeElementAssignment(interpreter, frame, assign);
+
+            Variable *variable = findVariable(frame, assign.name);
+            if (!variable) return FLOW_FAILED;
+
+            ConstValue value = castConstant(evaluate(interpreter, frame, assign.value), variable->typeName);
+            if (!value.isConstant) return FLOW_FAILED;
+
+            variable->value = value;
+            return FLOW_NORMAL;
+        }
+        case AST_RETURN: {
+            return executeReturn(interpreter, frame, statement->asReturn);
+        }
+        case AST_IF: {
+            ConstValue condition = evaluate(interpreter, frame, statement->asIf.condition);
+            if (!condition.isConstant) return FLOW_FAILED;
+            if (condition.bits == 0) return FLOW_NORMAL;
+
+            return executeBlock(interpreter, frame, statement->asIf.block);
+        }
+        case AST_WHILE: {
+            return executeWhile(interpreter, frame, statement->asWhile);
+        }
+        case AST_FOR: {
+            return executeFor(interpreter, frame, statement->asFor);
+        }
+        case AST_MATCH: {
+            return executeMatch(interpreter, frame, statement->asMatch);
+        }
+        case AST_BLOCK: {
+            return executeBlock(interpreter, frame, statement->asBlock);
+        }
+        case AST_STOP: {
+            return FLOW_STOP;
+        }
+        case AST_NEXT: {
+            return FLOW_NEXT;
+        }
+        case AST_CALL_EXPR: {
+            ConstValue value = evaluate(interpreter, frame, statement);
+            return value.isConstant ? FLOW_NORMAL : FLOW_FAILED;
+        }
+        default: {
+            return FLOW_FAILED;
+        }
+    }
+}
+
+static void warnExceededLimit(Interpreter *interpreter, char *name) {
+    if (interpreter->exceededSteps) {
+        compileWarningFromAnalyzer(interpreter->analyzer,
+            "compile time call to '%s' did not finish within %d steps, it will be evaluated at runtime\n",
+            name, interpreter->maxSteps
+        );
+    } else if (interpreter->exceededDepth) {
+        compileWarningFromAnalyzer(interpreter->analyzer,
+            "compile time call to '%s' nests deeper than %d calls, it will be evaluated at runtime\n",
+            name, interpreter->maxDepth
+        );
+    }
+}
+
+// a fixed array cannot be returned in C, so there is nothing to fall back to at runtime
+static void raiseUnevaluatedArray(Interpreter *interpreter, char *name, char *function) {
+    if (interpreter->exceededSteps) {
+        compileErrFromAnalyzer(interpreter->analyzer,
+            "'%s' is initialised by '%s', which did not finish within %d steps\n",
+            name, function, interpreter->maxSteps
+        );
+    } else if (interpreter->exceededDepth) {
+        compileErrFromAnalyzer(interpreter->analyzer,
+            "'%s' is initialised by '%s', which nests deeper than %d calls\n",
+            name, function, interpreter->maxDepth
+        );
+    } else {
+        compileErrFromAnalyzer(interpreter->analyzer,
+            "'%s' is initialised by '%s', which could not be evaluated at compile time\n",
+            name, function
+        );
+    }
+}
+
+static void raiseArrayCallOutsideLet(Interpreter *interpreter, char *function) {
+    compileErrFromAnalyzer(interpreter->analyzer,
+        "'%s' returns a fixed array, so it can only initialise a 'const' array\n", function
+    );
+}
+
+static void resetLimits(Interpreter *interpreter) {
+    interpreter->steps = 0;
+    interpreter->depth = 0;
+    interpreter->exceededSteps = false;
+    interpreter->exceededDepth = false;
+}
+
+static bool returnsArray(Interpreter *interpreter, char *name) {
+    AstExpr *callee = findComptimeFunction(interpreter, name);
+    return callee && callee->asFunction.returnType.arrayLength;
+}
+
+// each call site gets its own budget so one expensive call cannot starve the others
+static bool evaluateCallSite(Interpreter *interpreter, AstExpr *expr) {
+    if (interpreter->maxSteps <= 0 || interpreter->maxDepth <= 0) return false;
+    if (!findComptimeFunction(interpreter, expr->asCallExpr.name)) return false;
+
+    resetLimits(interpreter);
+
+    Frame frame = newFrame((TypeExpr){ 0 });
+    ConstValue result = evaluateCall(interpreter, &frame, expr->asCallExpr);
+    freeFrame(&frame);
+
+    if (!result.isConstant) {
+        warnExceededLimit(interpreter, expr->asCallExpr.name);
+        return false;
+    }
+
+    replaceExpr(expr, newConstantExpr(result));
+    return true;
+}
+
+// 'const TABLE: [N]T = makeTable()' becomes an array literal of the elements the call returned
+static void evaluateArrayLet(Interpreter *interpreter, LetDeclaration let) {
+    CallExpr call = let.value->asCallExpr;
+    int length = let.type.arrayLength;
+
+    resetLimits(interpreter);
+
+    ConstValue *elements = newElements(length);
+
+    Frame frame = newFrame((TypeExpr){ 0 });
+    bool isEvaluated = evaluateArrayCall(interpreter, &frame, call, let.type, elements);
+    freeFrame(&frame);
+
+    if (!isEvaluated) {
+        raiseUnevaluatedArray(interpreter, let.name, call.name);
+        free(elements);
+        return;
+    }
+
+    AstExpr **literals = malloc(sizeof(AstExpr *) * length);
+    if (!literals) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    for (int i = 0; i < length; i++) {
+        literals[i] = newConstantExpr(elements[i]);
+    }
+    free(elements);
+
+    replaceExpr(let.value, newArrayLiteral(literals, length, length));
+}
+
+static bool comptimeVisitor(AstExpr *expr, void *context);
+
+// a call which is a statement on its own has nowhere to put its result, only its arguments are visited
+static void visitStatement(Interpreter *interpreter, AstExpr *statement) {
+    if (statement->type != AST_CALL_EXPR) {
+        walkExpr(statement, comptimeVisitor, interpreter);
+        return;
+    }
+
+    for (int i = 0; i < statement->asCallExpr.argCount; i++) {
+        walkExpr(statement->asCallExpr.arguments[i], comptimeVisitor, interpreter);
+    }
+}
+
+static void visitBlock(Interpreter *interpreter, BlockExpr block) {
+    for (int i = 0; i < block.count; i++) {
+        visitStatement(interpreter, block.body[i]);
+    }
+}
+
+static bool comptimeVisitor(AstExpr *expr, void *context) {
+    Interpreter *interpreter = context;
+
+    switch (expr->type) {
+        case AST_CALL_EXPR: {
+            if (returnsArray(interpreter, expr->asCallExpr.name)) {
+                raiseArrayCallOutsideLet(interpreter, expr->asCallExpr.name);
+                return false;
+            }
+
+            return !evaluateCallSite(interpreter, expr);
+        }
+        case AST_LET: {
+            LetDeclaration let = expr->asLet;
+            if (!let.type.arrayLength || let.value->type != AST_CALL_EXPR || !returnsArray(interpreter, let.value->asCallExpr.name)) {
+                return true;
+            }
+
+            evaluateArrayLet(interpreter, let);
+            return false;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            // only ever run by the interpreter, the function is not emitted
+            if (expr->asFunction.returnType.arrayLength) return false;
+            if (expr->asFunction.isLambda) return true;
+
+            visitBlock(interpreter, expr->asFunction.block);
+            return false;
+        }
+        case AST_BLOCK: {
+            visitBlock(interpreter, expr->asBlock);
+            return false;
+        }
+        case AST_IF: {
+            walkExpr(expr->asIf.condition, comptimeVisitor, interpreter);
+            visitBlock(interpreter, expr->asIf.block);
+            return false;
+        }
+        case AST_WHILE: {
+            walkExpr(expr->asWhile.condition, comptimeVisitor, interpreter);
+            walkExpr(expr->asWhile.alteration, comptimeVisitor, interpreter);
+            visitBlock(interpreter, expr->asWhile.block);
+            return false;
+        }
+        case AST_FOR: {
+            walkExpr(expr->asFor.iterator, comptimeVisitor, interpreter);
+            visitBlock(interpreter, expr->asFor.block);
+            return false;
+        }
+        case AST_MATCH: {
+            walkExpr(expr->asMatch.expression, comptimeVisitor, interpreter);
+
+            for (int i = 0; i < expr->asMatch.caseCount; i++) {
+                visitStatement(interpreter, expr->asMatch.cases[i].expression);
+            }
+            return false;
+        }
+        case AST_DEFER_STATEMENT: {
+            visitStatement(interpreter, expr->asDefer.statement);
+            return false;
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+void evaluateComptimeCalls(Interpreter *interpreter) {
+    Ast ast = interpreter->analyzer->parser->ast;
+    for (int i = 0; i < ast.exprCount; i++) {
+        walkExpr(ast.exprs[i], comptimeVisitor, interpreter);
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef comptime_h
+#define comptime_h
+
+#include "analyze.h"
+
+typedef struct {
+    Analyzer *analyzer;
+
+    // how many expressions and statements one call site may evaluate
+    int       maxSteps;
+
+    // how deeply compile time calls may nest
+    int       maxDepth;
+
+    int       steps;
+    int       depth;
+
+    // set when a limit stopped evaluation so the call site can be warned about
+    bool      exceededSteps;
+    bool      exceededDepth;
+} Interpreter;
+
+Interpreter newInterpreter(Analyzer *analyzer, int maxSteps, int maxDepth);
+
+// replaces calls to 'const fn' functions with constant arguments by the value they return
+void evaluateComptimeCalls(Interpreter *interpreter);
+
+#endif
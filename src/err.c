@@ -90,6 +90,18 @@ void compileErrFromAnalyzer(Analyzer *analyzer, const char *format, ...) {
     printf("\n");
 }
 
+void compileWarningFromAnalyzer(Analyzer *analyzer, const char *format, ...) {
+    printf("\n");
+    printf("warning in %s\n", analyzer->parser->filePath);
+
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+
+    printf("\n");
+}
+
 void exitWithInternalCompilerError(char *err) {
     fprintf(stderr, "\ninternal compiler error: %s", err);
     fprintf(stderr, "\nthis should not have happened, oops. please report this bug.\n\n");
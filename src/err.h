@@ -9,6 +9,7 @@ void compileWarningFromParse(Parser *parser, char *message);
 
 void compileErrFromTokenize(Lexer *lexer, char *message);
 void compileErrFromAnalyzer(Analyzer *analyzer, const char *format, ...);
+void compileWarningFromAnalyzer(Analyzer *analyzer, const char *format, ...);
 
 void exitWithInternalCompilerError(char *err);
 
@@ -77,6 +77,10 @@ AstExpr *newTypeExpr(char *name, uint8_t ptrDepth) {
 
     expr->asType.name = strdup(name);
     expr->asType.ptrDepth = ptrDepth;
+    expr->asType.arrayLength = 0;
+    expr->asType.isSlice = false;
+    expr->asType.typeArguments = NULL;
+    expr->asType.typeArgumentCount = 0;
 
     return expr;
 }
@@ -87,11 +91,12 @@ AstExpr *newAssignExpr(char *name, AstExpr *value, uint8_t ptrDepth) {
     expr->asAssign.name = strdup(name);
     expr->asAssign.value = value;
     expr->asAssign.ptrDepth = ptrDepth;
+    expr->asAssign.target = NULL;
 
     return expr;
 }
 
-AstExpr *newFunctionDeclaration(char *name, TypeExpr returnType, BlockExpr body, int paramCount, int paramCapacity, FunctionParameter *parameters, bool isLambda, AstExpr *lambdaExpr, bool isPublic, bool isInline) {
+AstExpr *newFunctionDeclaration(char *name, TypeExpr returnType, BlockExpr body, int paramCount, int paramCapacity, FunctionParameter *parameters, bool isLambda, AstExpr *lambdaExpr, bool isPublic, uint32_t tags) {
     AstExpr *expr = newExpr(AST_FUNCTION_DECLARATION);
 
     expr->asFunction.name = strdup(name);
@@ -103,7 +108,11 @@ AstExpr *newFunctionDeclaration(char *name, TypeExpr returnType, BlockExpr body,
     expr->asFunction.isLambda = isLambda;
     expr->asFunction.lambdaExpr = lambdaExpr;
     expr->asFunction.isPublic = isPublic;
-    expr->asFunction.isInline = isInline;
+    expr->asFunction.tags = tags;
+    expr->asFunction.isReachable = true;
+    expr->asFunction.writesOnlyLocals = false;
+    expr->asFunction.typeParameters = NULL;
+    expr->asFunction.typeParameterCount = 0;
 
     return expr;
 }
@@ -131,11 +140,12 @@ AstExpr *newFunctionParameter(char *name, AstExpr *type) {
 
     expr->asParameter.name = strdup(name);
     expr->asParameter.type = type->asType;
+    expr->asParameter.tags = 0;
 
     return expr;
 }
 
-AstExpr *newStructDeclaration(char *name, AstExpr **members, int memberCount, int memberCapacity, bool isInterface, bool isPublic) {
+AstExpr *newStructDeclaration(char *name, AstExpr **members, int memberCount, int memberCapacity, bool isInterface, bool isPublic, uint32_t tags, int alignment) {
     AstExpr *expr = newExpr(AST_STRUCT_DECLARATION);
     expr->asStruct.name = strdup(name);
 
@@ -144,26 +154,36 @@ AstExpr *newStructDeclaration(char *name, AstExpr **members, int memberCount, in
     expr->asStruct.memberCount = memberCount;
     expr->asStruct.isInterface = isInterface;
     expr->asStruct.isPublic = isPublic;
+    expr->asStruct.isReachable = true;
+    expr->asStruct.tags = tags;
+    expr->asStruct.alignment = alignment;
+    expr->asStruct.typeParameters = NULL;
+    expr->asStruct.typeParameterCount = 0;
+    expr->asStruct.interfaces = NULL;
+    expr->asStruct.interfaceCount = 0;
 
     return expr;
 }
 
-AstExpr *newStructField(char *name, AstExpr *type, bool isPublic) {
+AstExpr *newStructField(char *name, AstExpr *type, bool isPublic, uint32_t tags, int alignment) {
     AstExpr *expr = newExpr(AST_STRUCT_FIELD);
 
     expr->asStructField.name = strdup(name);
     expr->asStructField.type = type->asType;
     expr->asStructField.isPublic = isPublic;
+    expr->asStructField.tags = tags;
+    expr->asStructField.alignment = alignment;
 
     return expr;
 }
 
-AstExpr *newWhileStatement(AstExpr *condition, AstExpr *block, AstExpr *alteration) {
+AstExpr *newWhileStatement(AstExpr *condition, AstExpr *block, AstExpr *alteration, uint32_t tags) {
     AstExpr *expr = newExpr(AST_WHILE);
     
     expr->asWhile.block = block->asBlock;
     expr->asWhile.condition = condition;
     expr->asWhile.alteration = alteration;
+    expr->asWhile.tags = tags;
 
     return expr;
 }
@@ -180,6 +200,12 @@ AstExpr *newStopStatement() {
     return expr;
 }
 
+AstExpr *newSyncStatement() {
+    AstExpr *expr = newExpr(AST_SYNC);
+
+    return expr;
+}
+
 AstExpr *newUnaryExpr(AstExpr *right, OperatorType operator) {
     AstExpr *expr = newExpr(AST_UNARY);
 
@@ -196,6 +222,10 @@ AstExpr *newCallExpr(char *name, int argCount, int argCapacity, AstExpr **argume
     expr->asCallExpr.argCount = argCount;
     expr->asCallExpr.argCapacity = argCapacity;
     expr->asCallExpr.arguments = arguments;
+    expr->asCallExpr.typeArguments = NULL;
+    expr->asCallExpr.typeArgumentCount = 0;
+    expr->asCallExpr.receiver = NULL;
+    expr->asCallExpr.isSpawned = false;
 
     return expr;
 }
@@ -220,32 +250,73 @@ AstExpr *newTernaryExpr(AstExpr *condition, AstExpr *falseExpr, AstExpr *trueExp
     return expr;
 }
 
-AstExpr *newForStatement(char *variable, AstExpr *iterator, BlockExpr block) {
+AstExpr *newForStatement(char *variable, TypeExpr type, AstExpr *iterator, BlockExpr block, uint32_t tags, int unrollCount) {
     AstExpr *expr = newExpr(AST_FOR);
     
     expr->asFor.block = block;
     expr->asFor.variable = strdup(variable);
+    expr->asFor.type = type;
     expr->asFor.iterator = iterator;
+    expr->asFor.tags = tags;
+    expr->asFor.unrollCount = unrollCount;
+    expr->asFor.reductions = NULL;
+    expr->asFor.reductionCount = 0;
+
+    return expr;
+}
+
+AstExpr *newIndexExpr(AstExpr *object, AstExpr *index) {
+    AstExpr *expr = newExpr(AST_INDEX);
+
+    expr->asIndex.object = object;
+    expr->asIndex.index = index;
+    expr->asIndex.objectType = (TypeExpr){ NULL, 0, 0, false, NULL, 0 };
+    expr->asIndex.isProvenInBounds = false;
+
+    return expr;
+}
+
+AstExpr *newArrayLiteral(AstExpr **elements, int elementCount, int elementCapacity) {
+    AstExpr *expr = newExpr(AST_ARRAY_LITERAL);
+
+    expr->asArray.elements = elements;
+    expr->asArray.elementCount = elementCount;
+    expr->asArray.elementCapacity = elementCapacity;
+    expr->asArray.type = (TypeExpr){ NULL, 0, 0, false, NULL, 0 };
 
     return expr;
 }
 
-AstExpr *newIfStatement(AstExpr *condition, BlockExpr block) {
+AstExpr *newRangeExpr(AstExpr *start, AstExpr *end, AstExpr *step, bool isInclusive) {
+    AstExpr *expr = newExpr(AST_RANGE);
+
+    expr->asRange.start = start;
+    expr->asRange.end = end;
+    expr->asRange.step = step;
+    expr->asRange.isInclusive = isInclusive;
+
+    return expr;
+}
+
+AstExpr *newIfStatement(AstExpr *condition, BlockExpr block, uint32_t tags) {
     AstExpr *expr = newExpr(AST_IF);
     
     expr->asIf.block = block;
     expr->asIf.condition = condition;
+    expr->asIf.tags = tags;
 
     return expr;
 }
 
-AstExpr *newMatchExpr(AstExpr *expression, MatchCaseExpr *cases, int caseCount, int caseCapacity) {
+AstExpr *newMatchExpr(AstExpr *expression, MatchCaseExpr *cases, int caseCount, int caseCapacity, uint32_t tags) {
     AstExpr *expr = newExpr(AST_MATCH);
 
     expr->asMatch.expression = expression;
     expr->asMatch.cases = cases;
     expr->asMatch.caseCapacity = caseCapacity;
     expr->asMatch.caseCount = caseCount;
+    expr->asMatch.tags = tags;
+    expr->asMatch.enumName = NULL;
 
     return expr;
 }
@@ -268,6 +339,7 @@ AstExpr *newEnumDeclaration(char *name, char **values, int valueCount, int value
     expr->asEnum.valueCount = valueCount;
     expr->asEnum.valueCapacity = valueCapacity;
     expr->asEnum.isPublic = isPublic;
+    expr->asEnum.isReachable = true;
 
     return expr;
 }
@@ -324,10 +396,485 @@ AstExpr *newEmbedStatement(char *embedSource) {
     return expr;
 }
 
+AstExpr *newInlinedCallExpr(char *name, TypeExpr returnType, AstExpr **temps, int tempCount, int tempCapacity, AstExpr *body) {
+    AstExpr *expr = newExpr(AST_INLINED_CALL);
+
+    expr->asInlinedCall.name = strdup(name);
+    expr->asInlinedCall.returnType = returnType;
+    expr->asInlinedCall.temps = temps;
+    expr->asInlinedCall.tempCount = tempCount;
+    expr->asInlinedCall.tempCapacity = tempCapacity;
+    expr->asInlinedCall.body = body;
+
+    return expr;
+}
+
 AstExpr *newErrExpr() {
     AstExpr *expr = newExpr(AST_ERR_EXPR);
 
     expr->asErr.dummy = 0;
 
     return expr;
+}
+
+static void walkBlock(BlockExpr block, bool (*visit)(AstExpr *expr, void *context), void *context) {
+    for (int i = 0; i < block.count; i++) {
+        walkExpr(block.body[i], visit, context);
+    }
+}
+
+typedef struct {
+    char     *name;
+    TypeExpr *type;
+} LocalSearch;
+
+static bool localVisitor(AstExpr *expr, void *context) {
+    LocalSearch *search = context;
+    if (search->type) return false;
+
+    if (expr->type == AST_LET && strcmp(expr->asLet.name, search->name) == 0) {
+        search->type = &expr->asLet.type;
+    }
+
+    if (expr->type == AST_FOR && expr->asFor.type.name && strcmp(expr->asFor.variable, search->name) == 0) {
+        search->type = &expr->asFor.type;
+    }
+
+    return !search->type;
+}
+
+// locals are not scoped here, the first declaration of the name is used
+bool findLocalType(AstExpr *function, char *name, TypeExpr *type) {
+    FunctionDeclaration declaration = function->asFunction;
+
+    for (int i = 0; i < declaration.paramCount; i++) {
+        if (strcmp(declaration.parameters[i].name, name) != 0) continue;
+
+        *type = declaration.parameters[i].type;
+        return true;
+    }
+
+    LocalSearch search = { name, NULL };
+    walkExpr(function, localVisitor, &search);
+    if (!search.type) return false;
+
+    *type = *search.type;
+    return true;
+}
+
+void walkExpr(AstExpr *expr, bool (*visit)(AstExpr *expr, void *context), void *context) {
+    if (!expr) return;
+    if (!visit(expr, context)) return;
+
+    switch (expr->type) {
+        case AST_GROUPING: {
+            walkExpr(expr->asGrouping.expression, visit, context);
+            break;
+        }
+        case AST_LET: {
+            walkExpr(expr->asLet.value, visit, context);
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            walkExpr(expr->asAssign.target, visit, context);
+            walkExpr(expr->asAssign.value, visit, context);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            if (expr->asFunction.isLambda) {
+                walkExpr(expr->asFunction.lambdaExpr, visit, context);
+            } else {
+                walkBlock(expr->asFunction.block, visit, context);
+            }
+            break;
+        }
+        case AST_BLOCK: {
+            walkBlock(expr->asBlock, visit, context);
+            break;
+        }
+        case AST_RETURN: {
+            walkExpr(expr->asReturn.value, visit, context);
+            break;
+        }
+        case AST_STRUCT_DECLARATION: {
+            for (int i = 0; i < expr->asStruct.memberCount; i++) {
+                walkExpr(expr->asStruct.members[i], visit, context);
+            }
+            break;
+        }
+        case AST_WHILE: {
+            walkExpr(expr->asWhile.condition, visit, context);
+            walkBlock(expr->asWhile.block, visit, context);
+            walkExpr(expr->asWhile.alteration, visit, context);
+            break;
+        }
+        case AST_FOR: {
+            walkExpr(expr->asFor.iterator, visit, context);
+            walkBlock(expr->asFor.block, visit, context);
+            break;
+        }
+        case AST_IF: {
+            walkExpr(expr->asIf.condition, visit, context);
+            walkBlock(expr->asIf.block, visit, context);
+            break;
+        }
+        case AST_UNARY: {
+            walkExpr(expr->asUnary.right, visit, context);
+            break;
+        }
+        case AST_BINARY: {
+            walkExpr(expr->asBinary.left, visit, context);
+            walkExpr(expr->asBinary.right, visit, context);
+            break;
+        }
+        case AST_TERNARY: {
+            walkExpr(expr->asTernary.condition, visit, context);
+            walkExpr(expr->asTernary.trueExpr, visit, context);
+            walkExpr(expr->asTernary.falseExpr, visit, context);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            walkExpr(expr->asCallExpr.receiver, visit, context);
+            for (int i = 0; i < expr->asCallExpr.argCount; i++) {
+                walkExpr(expr->asCallExpr.arguments[i], visit, context);
+            }
+            break;
+        }
+        case AST_MATCH: {
+            walkExpr(expr->asMatch.expression, visit, context);
+            for (int i = 0; i < expr->asMatch.caseCount; i++) {
+                walkExpr(expr->asMatch.cases[i].pattern, visit, context);
+                walkExpr(expr->asMatch.cases[i].expression, visit, context);
+            }
+            break;
+        }
+        case AST_PROPERTY_ACCESS: {
+            walkExpr(expr->asProperty.object, visit, context);
+            break;
+        }
+        case AST_STRUCT_INITIALIZER: {
+            for (int i = 0; i < expr->asStructInit.fieldCount; i++) {
+                walkExpr(expr->asStructInit.fields[i].value, visit, context);
+            }
+            break;
+        }
+        case AST_DEFER_STATEMENT: {
+            walkExpr(expr->asDefer.statement, visit, context);
+            break;
+        }
+        case AST_INLINED_CALL: {
+            for (int i = 0; i < expr->asInlinedCall.tempCount; i++) {
+                walkExpr(expr->asInlinedCall.temps[i], visit, context);
+            }
+            walkExpr(expr->asInlinedCall.body, visit, context);
+            break;
+        }
+        case AST_INDEX: {
+            walkExpr(expr->asIndex.object, visit, context);
+            walkExpr(expr->asIndex.index, visit, context);
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            for (int i = 0; i < expr->asArray.elementCount; i++) {
+                walkExpr(expr->asArray.elements[i], visit, context);
+            }
+            break;
+        }
+        case AST_RANGE: {
+            walkExpr(expr->asRange.start, visit, context);
+            walkExpr(expr->asRange.end, visit, context);
+            walkExpr(expr->asRange.step, visit, context);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+TypeExpr cloneType(TypeExpr type) {
+    TypeExpr clone = type;
+    clone.name = type.name ? strdup(type.name) : NULL;
+
+    if (type.typeArgumentCount) {
+        clone.typeArguments = malloc(sizeof(TypeExpr) * type.typeArgumentCount);
+        for (int i = 0; i < type.typeArgumentCount; i++) {
+            clone.typeArguments[i] = cloneType(type.typeArguments[i]);
+        }
+    }
+
+    return clone;
+}
+
+void freeType(TypeExpr type) {
+    free(type.name);
+
+    for (int i = 0; i < type.typeArgumentCount; i++) {
+        freeType(type.typeArguments[i]);
+    }
+    free(type.typeArguments);
+}
+
+static char **cloneNames(char **names, int count) {
+    if (!count) return NULL;
+
+    char **clone = malloc(sizeof(char *) * count);
+    for (int i = 0; i < count; i++) {
+        clone[i] = strdup(names[i]);
+    }
+
+    return clone;
+}
+
+static BlockExpr cloneBlock(BlockExpr block) {
+    BlockExpr clone = block;
+    if (!block.body) return clone;
+
+    int capacity = block.capacity > block.count ? block.capacity : block.count + 1;
+    clone.capacity = capacity;
+    clone.body = malloc(sizeof(AstExpr *) * capacity);
+
+    for (int i = 0; i < block.count; i++) {
+        clone.body[i] = cloneExpr(block.body[i]);
+    }
+
+    return clone;
+}
+
+static AstExpr **cloneExprs(AstExpr **exprs, int count, int capacity) {
+    if (capacity < count + 1) capacity = count + 1;
+
+    AstExpr **clone = malloc(sizeof(AstExpr *) * capacity);
+    for (int i = 0; i < count; i++) {
+        clone[i] = cloneExpr(exprs[i]);
+    }
+
+    return clone;
+}
+
+AstExpr *cloneExpr(AstExpr *expr) {
+    if (!expr) return NULL;
+
+    AstExpr *clone = newExpr(expr->type);
+    *clone = *expr;
+
+    switch (expr->type) {
+        case AST_IDENTIFIER: {
+            clone->asIdentifier.name = strdup(expr->asIdentifier.name);
+            break;
+        }
+        case AST_STRING_LITERAL: {
+            clone->asString.value = strdup(expr->asString.value);
+            break;
+        }
+        case AST_CHAR_LITERAL: {
+            clone->asChar.value = strdup(expr->asChar.value);
+            break;
+        }
+        case AST_TYPE_EXPR: {
+            clone->asType = cloneType(expr->asType);
+            break;
+        }
+        case AST_GROUPING: {
+            clone->asGrouping.expression = cloneExpr(expr->asGrouping.expression);
+            break;
+        }
+        case AST_LET: {
+            clone->asLet.name = strdup(expr->asLet.name);
+            clone->asLet.type = cloneType(expr->asLet.type);
+            clone->asLet.value = cloneExpr(expr->asLet.value);
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            clone->asAssign.name = strdup(expr->asAssign.name);
+            clone->asAssign.value = cloneExpr(expr->asAssign.value);
+            clone->asAssign.target = cloneExpr(expr->asAssign.target);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            FunctionDeclaration *function = &clone->asFunction;
+
+            function->name = strdup(expr->asFunction.name);
+            function->returnType = cloneType(expr->asFunction.returnType);
+            function->block = cloneBlock(expr->asFunction.block);
+            function->lambdaExpr = cloneExpr(expr->asFunction.lambdaExpr);
+
+            function->paramCapacity = function->paramCount + 1;
+            function->parameters = malloc(sizeof(FunctionParameter) * function->paramCapacity);
+            for (int i = 0; i < function->paramCount; i++) {
+                function->parameters[i] = expr->asFunction.parameters[i];
+                function->parameters[i].name = strdup(expr->asFunction.parameters[i].name);
+                function->parameters[i].type = cloneType(expr->asFunction.parameters[i].type);
+            }
+
+            function->typeParameters = cloneNames(expr->asFunction.typeParameters, expr->asFunction.typeParameterCount);
+            break;
+        }
+        case AST_BLOCK: {
+            clone->asBlock = cloneBlock(expr->asBlock);
+            break;
+        }
+        case AST_RETURN: {
+            clone->asReturn.value = cloneExpr(expr->asReturn.value);
+            break;
+        }
+        case AST_STRUCT_DECLARATION: {
+            clone->asStruct.name = strdup(expr->asStruct.name);
+            clone->asStruct.members = cloneExprs(expr->asStruct.members, expr->asStruct.memberCount, expr->asStruct.memberCapacity);
+            clone->asStruct.memberCapacity = expr->asStruct.memberCount + 1;
+            clone->asStruct.typeParameters = cloneNames(expr->asStruct.typeParameters, expr->asStruct.typeParameterCount);
+            clone->asStruct.interfaces = cloneNames(expr->asStruct.interfaces, expr->asStruct.interfaceCount);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            clone->asStructField.name = strdup(expr->asStructField.name);
+            clone->asStructField.type = cloneType(expr->asStructField.type);
+            break;
+        }
+        case AST_WHILE: {
+            clone->asWhile.condition = cloneExpr(expr->asWhile.condition);
+            clone->asWhile.alteration = cloneExpr(expr->asWhile.alteration);
+            clone->asWhile.block = cloneBlock(expr->asWhile.block);
+            break;
+        }
+        case AST_FOR: {
+            clone->asFor.variable = strdup(expr->asFor.variable);
+            clone->asFor.type = cloneType(expr->asFor.type);
+            clone->asFor.iterator = cloneExpr(expr->asFor.iterator);
+            clone->asFor.block = cloneBlock(expr->asFor.block);
+
+            if (expr->asFor.reductionCount) {
+                clone->asFor.reductions = malloc(sizeof(LoopReduction) * expr->asFor.reductionCount);
+            }
+            for (int i = 0; i < expr->asFor.reductionCount; i++) {
+                clone->asFor.reductions[i].name = strdup(expr->asFor.reductions[i].name);
+                clone->asFor.reductions[i].operator = expr->asFor.reductions[i].operator;
+            }
+            break;
+        }
+        case AST_IF: {
+            clone->asIf.condition = cloneExpr(expr->asIf.condition);
+            clone->asIf.block = cloneBlock(expr->asIf.block);
+            break;
+        }
+        case AST_UNARY: {
+            clone->asUnary.right = cloneExpr(expr->asUnary.right);
+            break;
+        }
+        case AST_BINARY: {
+            clone->asBinary.left = cloneExpr(expr->asBinary.left);
+            clone->asBinary.right = cloneExpr(expr->asBinary.right);
+            break;
+        }
+        case AST_INDEX: {
+            clone->asIndex.object = cloneExpr(expr->asIndex.object);
+            clone->asIndex.index = cloneExpr(expr->asIndex.index);
+            clone->asIndex.objectType = cloneType(expr->asIndex.objectType);
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            clone->asArray.elements = malloc(sizeof(AstExpr *) * (expr->asArray.elementCount + 1));
+            clone->asArray.elementCapacity = expr->asArray.elementCount + 1;
+
+            for (int i = 0; i < expr->asArray.elementCount; i++) {
+                clone->asArray.elements[i] = cloneExpr(expr->asArray.elements[i]);
+            }
+            clone->asArray.type = cloneType(expr->asArray.type);
+            break;
+        }
+        case AST_RANGE: {
+            clone->asRange.start = cloneExpr(expr->asRange.start);
+            clone->asRange.end = cloneExpr(expr->asRange.end);
+            clone->asRange.step = cloneExpr(expr->asRange.step);
+            break;
+        }
+        case AST_TERNARY: {
+            clone->asTernary.condition = cloneExpr(expr->asTernary.condition);
+            clone->asTernary.trueExpr = cloneExpr(expr->asTernary.trueExpr);
+            clone->asTernary.falseExpr = cloneExpr(expr->asTernary.falseExpr);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            clone->asCallExpr.name = strdup(expr->asCallExpr.name);
+            clone->asCallExpr.arguments = cloneExprs(expr->asCallExpr.arguments, expr->asCallExpr.argCount, expr->asCallExpr.argCapacity);
+            clone->asCallExpr.argCapacity = expr->asCallExpr.argCount + 1;
+
+            if (expr->asCallExpr.typeArgumentCount) {
+                clone->asCallExpr.typeArguments = malloc(sizeof(TypeExpr) * expr->asCallExpr.typeArgumentCount);
+            }
+            for (int i = 0; i < expr->asCallExpr.typeArgumentCount; i++) {
+                clone->asCallExpr.typeArguments[i] = cloneType(expr->asCallExpr.typeArguments[i]);
+            }
+
+            clone->asCallExpr.receiver = cloneExpr(expr->asCallExpr.receiver);
+            break;
+        }
+        case AST_MATCH: {
+            MatchExpr *match = &clone->asMatch;
+
+            match->expression = cloneExpr(expr->asMatch.expression);
+            match->enumName = expr->asMatch.enumName ? strdup(expr->asMatch.enumName) : NULL;
+            match->caseCapacity = match->caseCount + 1;
+            match->cases = malloc(sizeof(MatchCaseExpr) * match->caseCapacity);
+
+            for (int i = 0; i < match->caseCount; i++) {
+                match->cases[i] = expr->asMatch.cases[i];
+                match->cases[i].pattern = cloneExpr(expr->asMatch.cases[i].pattern);
+                match->cases[i].expression = cloneExpr(expr->asMatch.cases[i].expression);
+            }
+            break;
+        }
+        case AST_ENUM: {
+            EnumDeclaration *enumDeclaration = &clone->asEnum;
+
+            enumDeclaration->name = strdup(expr->asEnum.name);
+            enumDeclaration->valueCapacity = enumDeclaration->valueCount + 1;
+            enumDeclaration->values = malloc(sizeof(char *) * enumDeclaration->valueCapacity);
+
+            for (int i = 0; i < enumDeclaration->valueCount; i++) {
+                enumDeclaration->values[i] = strdup(expr->asEnum.values[i]);
+            }
+            break;
+        }
+        case AST_PROPERTY_ACCESS: {
+            clone->asProperty.object = cloneExpr(expr->asProperty.object);
+            clone->asProperty.property = strdup(expr->asProperty.property);
+            break;
+        }
+        case AST_STRUCT_INITIALIZER: {
+            StructInitializer *init = &clone->asStructInit;
+
+            init->fieldCapacity = init->fieldCount + 1;
+            init->fields = malloc(sizeof(StructFieldInit) * init->fieldCapacity);
+
+            for (int i = 0; i < init->fieldCount; i++) {
+                init->fields[i].name = strdup(expr->asStructInit.fields[i].name);
+                init->fields[i].value = cloneExpr(expr->asStructInit.fields[i].value);
+            }
+            break;
+        }
+        case AST_DEFER_STATEMENT: {
+            clone->asDefer.statement = cloneExpr(expr->asDefer.statement);
+            break;
+        }
+        case AST_EMBED: {
+            clone->asEmbed.embedSource = strdup(expr->asEmbed.embedSource);
+            break;
+        }
+        case AST_INLINED_CALL: {
+            InlinedCallExpr *call = &clone->asInlinedCall;
+
+            call->name = strdup(expr->asInlinedCall.name);
+            call->returnType = cloneType(expr->asInlinedCall.returnType);
+            call->temps = cloneExprs(expr->asInlinedCall.temps, call->tempCount, call->tempCapacity);
+            call->tempCapacity = call->tempCount + 1;
+            call->body = cloneExpr(expr->asInlinedCall.body);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return clone;
 }
\ No newline at end of file
@@ -38,6 +38,11 @@ typedef enum {
     AST_STRUCT_FIELD_INIT,
     AST_DEFER_STATEMENT,
     AST_EMBED,
+    AST_INLINED_CALL,
+    AST_RANGE,
+    AST_INDEX,
+    AST_ARRAY_LITERAL,
+    AST_SYNC,
 } AstType;
 
 typedef enum {
@@ -71,6 +76,53 @@ typedef enum {
     OP_BITWISE_XOR,
 } OperatorType;
 
+// tags are written as '@name' before the declaration or statement they apply to
+typedef enum {
+    TAG_INLINE   = 1 << 0,
+    TAG_NOINLINE = 1 << 1,
+    TAG_HOT      = 1 << 2,
+    TAG_COLD     = 1 << 3,
+    TAG_PURE     = 1 << 4,
+    TAG_CONST    = 1 << 5,
+    TAG_LIKELY   = 1 << 6,
+    TAG_UNLIKELY = 1 << 7,
+
+    // also written as 'const fn'
+    TAG_COMPTIME = 1 << 8,
+
+    // a loop around a match, dispatched with computed gotos
+    TAG_DISPATCH = 1 << 9,
+
+    // written '@unroll(N)', the factor is kept on the loop
+    TAG_UNROLL   = 1 << 10,
+
+    // iterations are independent, so they may run in vector lanes or on several threads
+    TAG_SIMD     = 1 << 11,
+    TAG_PARALLEL = 1 << 12,
+
+    // struct layout, '@align(N)' and '@cacheline' also apply to fields
+    TAG_PACKED    = 1 << 13,
+    TAG_ALIGN     = 1 << 14,
+    TAG_CACHELINE = 1 << 15,
+
+    // written '@repr(C)', fields keep the order they are declared in
+    TAG_REPR_C    = 1 << 16,
+
+    // arrays of the struct are stored as one array per field
+    TAG_SOA       = 1 << 17,
+
+    // a pointer parameter which no other pointer reaching the same memory is passed alongside, emitted as 'restrict'
+    TAG_NOALIAS   = 1 << 18,
+} TagType;
+
+#define FUNCTION_TAGS (TAG_INLINE | TAG_NOINLINE | TAG_HOT | TAG_COLD | TAG_PURE | TAG_CONST | TAG_COMPTIME)
+#define BRANCH_TAGS   (TAG_LIKELY | TAG_UNLIKELY)
+#define STRUCT_TAGS   (TAG_PACKED | TAG_ALIGN | TAG_CACHELINE | TAG_REPR_C | TAG_SOA)
+#define FIELD_TAGS    (TAG_ALIGN | TAG_CACHELINE)
+#define PARAM_TAGS    (TAG_NOALIAS)
+
+#define hasTag(tags, tag) (((tags) & (tag)) != 0)
+
 typedef struct {
     AstExpr *expression;
 } GroupingExpression;
@@ -99,10 +151,22 @@ typedef struct {
     bool value;
 } BoolLiteralExpr;
 
-typedef struct {
-    char   *name;
-    uint8_t ptrDepth; 
-} TypeExpr;
+// for '[N]T' and '[]T' the name and pointer depth are those of the element type 'T'
+typedef struct TypeExpr TypeExpr;
+struct TypeExpr {
+    char     *name;
+    uint8_t   ptrDepth; 
+
+    // the 'N' of a fixed array, 0 when the type is not one
+    int       arrayLength;
+
+    // a pointer and a length
+    bool      isSlice;
+
+    // the 'i32' of 'Vec<i32>', gone once the name is replaced by that of the specialization
+    TypeExpr *typeArguments;
+    int       typeArgumentCount;
+};
 
 typedef struct {
     char    *name;
@@ -115,6 +179,9 @@ typedef struct {
     char    *name;
     AstExpr *value;
     uint8_t  ptrDepth;
+
+    // the element being assigned in 'name[i] = value', otherwise null
+    AstExpr *target;
 } AssignmentExpr;
 
 typedef struct {
@@ -137,6 +204,7 @@ typedef struct {
 typedef struct {
     char    *name;
     TypeExpr type;
+    uint32_t tags;
 } FunctionParameter;
 
 typedef struct {
@@ -145,11 +213,23 @@ typedef struct {
     int       argCount;
     int       argCapacity;
     AstExpr **arguments;
+
+    // given as 'max<i32>(a, b)', otherwise inferred from the arguments
+    TypeExpr *typeArguments;
+    int       typeArgumentCount;
+
+    // the 'shape' of 'shape.area()', null for a plain call
+    // method calls are rewritten into plain calls before analysis, see 'resolveMethodCalls'
+    AstExpr  *receiver;
+
+    // 'spawn f(x)', the call runs as a task which is waited for by 'sync'
+    bool      isSpawned;
 } CallExpr;
 
 typedef struct {
     AstExpr *condition;
     BlockExpr block;
+    uint32_t  tags;
 } IfStatement;
 
 typedef struct {
@@ -165,13 +245,29 @@ typedef struct {
     AstExpr           *lambdaExpr;
 
     bool               isPublic;
-    bool               isInline;
+    uint32_t           tags;
+
+    // cleared for functions which no root can reach
+    bool               isReachable;
+
+    // set by the analyzer when the function writes nothing but its own locals and
+    // calls nothing but '@pure' and '@const' functions
+    bool               writesOnlyLocals;
+
+    // the 'T' of 'fn max<T>', a generic function is only emitted through its specializations
+    char             **typeParameters;
+    int                typeParameterCount;
 } FunctionDeclaration;
 
 typedef struct {
     char    *name;
     TypeExpr type;
     bool     isPublic;
+
+    uint32_t tags;
+
+    // the alignment given by '@align(N)', 0 when there is none
+    int      alignment;
 } StructField;
 // change to StructFieldDeclaration
 
@@ -189,6 +285,17 @@ typedef struct {
     AstExpr **members;
 
     bool      isPublic;
+    bool      isReachable;
+
+    uint32_t  tags;
+    int       alignment;
+
+    char    **typeParameters;
+    int       typeParameterCount;
+
+    // the interfaces named after 'with'
+    char    **interfaces;
+    int       interfaceCount;
 } StructDeclaration;
 
 typedef struct {
@@ -203,12 +310,39 @@ typedef struct {
     AstExpr  *condition;
     AstExpr  *alteration;
     BlockExpr block;
+    uint32_t  tags;
 } WhileStatement;
 
+// 'start..end' or 'start..=end', optionally followed by 'step n'
 typedef struct {
-    char     *variable;
-    AstExpr  *iterator;
-    BlockExpr block;
+    AstExpr *start;
+    AstExpr *end;
+
+    // may be null, the range then counts up by one
+    AstExpr *step;
+    bool     isInclusive;
+} RangeExpr;
+
+// an outer variable which each iteration of a '@simd' or '@parallel' loop combines into
+typedef struct {
+    char         *name;
+    OperatorType  operator;
+} LoopReduction;
+
+typedef struct {
+    char          *variable;
+
+    // the type of the loop variable, the name is null when it is left to be inferred
+    TypeExpr       type;
+    AstExpr       *iterator;
+    BlockExpr      block;
+
+    uint32_t       tags;
+    int            unrollCount;
+
+    // found by the analyzer for '@simd' and '@parallel' loops
+    LoopReduction *reductions;
+    int            reductionCount;
 } ForStatement;
 
 typedef struct {
@@ -230,6 +364,28 @@ typedef struct {
     char *property;
 } PropertyAccessExpr;
 
+// 'object[index]', or a slice of the object when the index is a range
+typedef struct {
+    AstExpr *object;
+    AstExpr *index;
+
+    // filled in by the analyzer, the array or slice type of 'object'
+    TypeExpr objectType;
+
+    // the analyzer proved the index is in bounds, so release builds leave out the check
+    bool     isProvenInBounds;
+} IndexExpr;
+
+typedef struct {
+    int       elementCount;
+    int       elementCapacity;
+    AstExpr **elements;
+
+    // the type of the parameter a literal passed as an argument becomes, set by the analyzer
+    // a literal initialising a 'let' takes the type of the variable instead and leaves this empty
+    TypeExpr  type;
+} ArrayLiteral;
+
 typedef struct {
     AstExpr  *pattern;
 
@@ -246,6 +402,7 @@ typedef struct {
     int    valueCapacity;
     char **values;
     bool   isPublic;
+    bool   isReachable;
 } EnumDeclaration;
 
 typedef struct {
@@ -259,6 +416,11 @@ typedef struct {
     // may be null
     // -should it be null though.. NO! 
     MatchCaseExpr *elseCase;
+
+    uint32_t       tags;
+
+    // the enum the subject is a variable of, set by the analyzer, null when it is not one
+    char          *enumName;
 } MatchExpr;
 
 typedef struct {
@@ -275,6 +437,19 @@ typedef struct {
     char *embedSource;
 } EmbedStatement;
 
+// a call to an arrow function which has been substituted into the caller
+// non-trivial arguments are bound to 'let' temporaries first so they are evaluated once and in order
+typedef struct {
+    char     *name;
+    TypeExpr  returnType;
+
+    int       tempCount;
+    int       tempCapacity;
+    AstExpr **temps;
+
+    AstExpr  *body;
+} InlinedCallExpr;
+
 struct AstExpr {
     AstType type;
 
@@ -303,6 +478,9 @@ struct AstExpr {
         BinaryExpr          asBinary;
         TernaryExpression   asTernary;
         ForStatement        asFor;
+        RangeExpr           asRange;
+        IndexExpr           asIndex;
+        ArrayLiteral        asArray;
         IfStatement         asIf;
         MatchExpr           asMatch;
         MatchCaseExpr       asMatchCase;
@@ -313,6 +491,7 @@ struct AstExpr {
         StructFieldInit     asStructFieldInit;
         DeferStatement      asDefer;
         EmbedStatement      asEmbed;
+        InlinedCallExpr     asInlinedCall;
     };
 };
 
@@ -325,22 +504,26 @@ AstExpr *newBoolExpr(bool value);
 AstExpr *newLetDeclaration(char *name, AstExpr *type, AstExpr *value, bool isConstant);
 AstExpr *newTypeExpr(char *name, uint8_t ptrDepth);
 AstExpr *newAssignExpr(char *name, AstExpr *value, uint8_t ptrDepth);
-AstExpr *newFunctionDeclaration(char *name, TypeExpr returnType, BlockExpr body, int paramCount, int paramCapacity, FunctionParameter *parameters, bool isLambda, AstExpr *lambdaExpr, bool isPublic, bool isInline);
+AstExpr *newFunctionDeclaration(char *name, TypeExpr returnType, BlockExpr body, int paramCount, int paramCapacity, FunctionParameter *parameters, bool isLambda, AstExpr *lambdaExpr, bool isPublic, uint32_t tags);
 AstExpr *newBlockExpr(AstExpr **body, int count, int capacity);
 AstExpr *newReturnStatement(AstExpr *expr);
 AstExpr *newFunctionParameter(char *name, AstExpr *type);
-AstExpr *newStructDeclaration(char *name, AstExpr **members, int memberCount, int memberCapacity, bool isInterface, bool isPublic);
-AstExpr *newStructField(char *name, AstExpr *type, bool isPublic);
-AstExpr *newWhileStatement(AstExpr *condition, AstExpr *alteration, AstExpr *block);
+AstExpr *newStructDeclaration(char *name, AstExpr **members, int memberCount, int memberCapacity, bool isInterface, bool isPublic, uint32_t tags, int alignment);
+AstExpr *newStructField(char *name, AstExpr *type, bool isPublic, uint32_t tags, int alignment);
+AstExpr *newWhileStatement(AstExpr *condition, AstExpr *block, AstExpr *alteration, uint32_t tags);
 AstExpr *newNextStatement();
 AstExpr *newStopStatement();
+AstExpr *newSyncStatement();
 AstExpr *newUnaryExpr(AstExpr *right, OperatorType operator);
 AstExpr *newCallExpr(char *name, int argCount, int argCapacity, AstExpr **arguments);
 AstExpr *newBinaryExpr(AstExpr *right, OperatorType operator, AstExpr *left);
 AstExpr *newTernaryExpr(AstExpr *condition, AstExpr *falseExpr, AstExpr *trueExpr);
-AstExpr *newForStatement(char *variable, AstExpr *iterator, BlockExpr block);
-AstExpr *newIfStatement(AstExpr *condition, BlockExpr block);
-AstExpr *newMatchExpr(AstExpr *expression, MatchCaseExpr *cases, int caseCount, int caseCapacity);
+AstExpr *newForStatement(char *variable, TypeExpr type, AstExpr *iterator, BlockExpr block, uint32_t tags, int unrollCount);
+AstExpr *newRangeExpr(AstExpr *start, AstExpr *end, AstExpr *step, bool isInclusive);
+AstExpr *newIndexExpr(AstExpr *object, AstExpr *index);
+AstExpr *newArrayLiteral(AstExpr **elements, int elementCount, int elementCapacity);
+AstExpr *newIfStatement(AstExpr *condition, BlockExpr block, uint32_t tags);
+AstExpr *newMatchExpr(AstExpr *expression, MatchCaseExpr *cases, int caseCount, int caseCapacity, uint32_t tags);
 AstExpr *newMatchCaseExpr(AstExpr *pattern, AstExpr *expression, bool isElseCase);
 AstExpr *newEnumDeclaration(char *name, char **values, int valueCount, int valueCapacity, bool isPublic);
 AstExpr *newGroupingExpr(AstExpr *expression);
@@ -349,7 +532,20 @@ AstExpr *newStructInitializer(StructFieldInit *fields, int fieldCount, int field
 AstExpr *newStructFieldInit(char *name, AstExpr *value);
 AstExpr *newDeferStatement(AstExpr *expr);
 AstExpr *newEmbedStatement(char *embedSource);
+AstExpr *newInlinedCallExpr(char *name, TypeExpr returnType, AstExpr **temps, int tempCount, int tempCapacity, AstExpr *body);
 
 AstExpr *newErrExpr();
 
+// returns a deep copy of 'expr'
+AstExpr *cloneExpr(AstExpr *expr);
+TypeExpr cloneType(TypeExpr type);
+void freeType(TypeExpr type);
+
+// finds the declared type of a parameter or local of 'function'
+bool findLocalType(AstExpr *function, char *name, TypeExpr *type);
+
+// visits 'expr' and then every expression nested within it, depth first
+// children are skipped when 'visit' returns false
+void walkExpr(AstExpr *expr, bool (*visit)(AstExpr *expr, void *context), void *context);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,550 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "fold.h"
+#include "err.h"
+
+static const IntegerKind intKind = { .width = 32, .isSigned = true };
+static const IntegerKind longKind = { .width = 64, .isSigned = true };
+
+static ConstValue newNonConstant() {
+    return (ConstValue){ .isConstant = false };
+}
+
+static uint64_t truncateBits(uint64_t bits, uint8_t width) {
+    if (width >= 64) return bits;
+    return bits & ((1ULL << width) - 1);
+}
+
+static ConstValue newConstant(uint64_t bits, IntegerKind kind) {
+    return (ConstValue){ .isConstant = true, .bits = truncateBits(bits, kind.width), .kind = kind };
+}
+
+static ConstValue newBooleanConstant(bool value) {
+    ConstValue constant = newConstant(value, intKind);
+    constant.isBoolean = true;
+
+    return constant;
+}
+
+int64_t constantAsSigned(ConstValue value) {
+    uint8_t width = value.kind.width;
+    if (!value.kind.isSigned || width >= 64) return (int64_t)value.bits;
+
+    uint64_t signBit = 1ULL << (width - 1);
+    return (int64_t)((value.bits ^ signBit) - signBit);
+}
+
+static bool isNegative(ConstValue value) {
+    return value.kind.isSigned && constantAsSigned(value) < 0;
+}
+
+static bool mapIntegerKind(char *name, IntegerKind *kind) {
+    static const struct { char *name; IntegerKind kind; } kinds[] = {
+        { "i8",   { 8,  true  } }, { "u8",  { 8,  false } },
+        { "i16",  { 16, true  } }, { "u16", { 16, false } },
+        { "i32",  { 32, true  } }, { "u32", { 32, false } },
+        { "i64",  { 64, true  } }, { "u64", { 64, false } },
+        { "size", { 64, false } },
+    };
+
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (strcmp(kinds[i].name, name) == 0) {
+            *kind = kinds[i].kind;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+char *integerKindName(IntegerKind kind) {
+    switch (kind.width) {
+        case 8:  return kind.isSigned ? "i8"  : "u8";
+        case 16: return kind.isSigned ? "i16" : "u16";
+        case 32: return kind.isSigned ? "i32" : "u32";
+        default: return kind.isSigned ? "i64" : "u64";
+    }
+}
+
+// converts to 'kind' the way an implicit conversion or cast in C would, wrapping out of range values
+static ConstValue convertConstant(ConstValue value, IntegerKind kind) {
+    return newConstant((uint64_t)constantAsSigned(value), kind);
+}
+
+// every type narrower than int fits in an int
+static ConstValue promoteConstant(ConstValue value) {
+    if (value.kind.width >= 32) {
+        value.isBoolean = false;
+        return value;
+    }
+
+    return convertConstant(value, intKind);
+}
+
+// the usual arithmetic conversions, operands have already been promoted
+static IntegerKind commonKind(IntegerKind left, IntegerKind right) {
+    if (left.isSigned == right.isSigned) {
+        return left.width >= right.width ? left : right;
+    }
+
+    IntegerKind unsignedKind = left.isSigned ? right : left;
+    IntegerKind signedKind = left.isSigned ? left : right;
+
+    if (unsignedKind.width >= signedKind.width) return unsignedKind;
+    return signedKind;
+}
+
+static bool evaluateCharLiteral(char *literal, uint64_t *value) {
+    if (literal[0] != '\\') {
+        if (literal[0] == '\0' || literal[1] != '\0') return false;
+
+        *value = (unsigned char)literal[0];
+        return true;
+    }
+
+    if (literal[1] == '\0' || literal[2] != '\0') return false;
+
+    switch (literal[1]) {
+        case 'n':  *value = '\n'; return true;
+        case 't':  *value = '\t'; return true;
+        case 'r':  *value = '\r'; return true;
+        case '0':  *value = '\0'; return true;
+        case '\\': *value = '\\'; return true;
+        case '\'': *value = '\''; return true;
+        case '"':  *value = '"';  return true;
+        default:   return false;
+    }
+}
+
+ConstValue castConstant(ConstValue value, char *typeName) {
+    if (!value.isConstant) return value;
+
+    if (strcmp(typeName, "bool") == 0) {
+        return newBooleanConstant(value.bits != 0);
+    }
+
+    IntegerKind kind;
+    if (!mapIntegerKind(typeName, &kind)) return newNonConstant();
+
+    return convertConstant(value, kind);
+}
+
+static ConstValue evaluateCast(AstExpr *expr) {
+    if (expr->asBinary.right->type != AST_IDENTIFIER) return newNonConstant();
+
+    ConstValue value = evaluateConstant(expr->asBinary.left);
+    return castConstant(value, expr->asBinary.right->asIdentifier.name);
+}
+
+static ConstValue evaluateLogical(AstExpr *expr) {
+    ConstValue left = evaluateConstant(expr->asBinary.left);
+    if (!left.isConstant) return left;
+
+    // the right operand is never evaluated when the left decides the result
+    bool isAnd = expr->asBinary.operator == OP_AND;
+    if (isAnd && left.bits == 0) return newBooleanConstant(false);
+    if (!isAnd && left.bits != 0) return newBooleanConstant(true);
+
+    ConstValue right = evaluateConstant(expr->asBinary.right);
+    if (!right.isConstant) return right;
+
+    return newBooleanConstant(right.bits != 0);
+}
+
+static bool fitsSignedKind(int64_t value, IntegerKind kind) {
+    if (kind.width >= 64) return true;
+
+    int64_t limit = 1LL << (kind.width - 1);
+    return value >= -limit && value < limit;
+}
+
+// signed arithmetic whose result does not fit its type is undefined in C, so it is not folded
+static ConstValue newSignedResult(bool hasOverflowed, int64_t value, IntegerKind kind) {
+    if (hasOverflowed || !fitsSignedKind(value, kind)) return newNonConstant();
+
+    return newConstant((uint64_t)value, kind);
+}
+
+static ConstValue evaluateArithmetic(OperatorType operator, ConstValue left, ConstValue right, IntegerKind kind) {
+    if (!kind.isSigned) {
+        switch (operator) {
+            case OP_PLUS:  return newConstant(left.bits + right.bits, kind);
+            case OP_MINUS: return newConstant(left.bits - right.bits, kind);
+            default:       return newConstant(left.bits * right.bits, kind);
+        }
+    }
+
+    int64_t l = constantAsSigned(left), r = constantAsSigned(right), result;
+
+    bool hasOverflowed;
+    switch (operator) {
+        case OP_PLUS:  hasOverflowed = __builtin_add_overflow(l, r, &result); break;
+        case OP_MINUS: hasOverflowed = __builtin_sub_overflow(l, r, &result); break;
+        default:       hasOverflowed = __builtin_mul_overflow(l, r, &result); break;
+    }
+
+    return newSignedResult(hasOverflowed, result, kind);
+}
+
+static ConstValue evaluateShift(OperatorType operator, ConstValue left, ConstValue right) {
+    if (isNegative(right) || right.bits >= left.kind.width) return newNonConstant();
+
+    if (operator == OP_BITWISE_SHIFT_LEFT) {
+        if (!left.kind.isSigned) return newConstant(left.bits << right.bits, left.kind);
+
+        // a signed shift must not push a set bit into or past the sign bit
+        if (isNegative(left) || left.bits >> (left.kind.width - 1 - right.bits) != 0) return newNonConstant();
+        return newConstant(left.bits << right.bits, left.kind);
+    }
+
+    if (left.kind.isSigned) {
+        return newConstant((uint64_t)(constantAsSigned(left) >> right.bits), left.kind);
+    }
+
+    return newConstant(left.bits >> right.bits, left.kind);
+}
+
+static ConstValue evaluateDivision(OperatorType operator, ConstValue left, ConstValue right, IntegerKind kind) {
+    if (right.bits == 0) return newNonConstant();
+
+    bool isDivide = operator == OP_DIVIDE;
+    if (!kind.isSigned) {
+        return newConstant(isDivide ? left.bits / right.bits : left.bits % right.bits, kind);
+    }
+
+    int64_t dividend = constantAsSigned(left);
+    int64_t divisor = constantAsSigned(right);
+
+    // the quotient of the most negative value and -1 does not fit
+    int64_t minimum = kind.width >= 64 ? INT64_MIN : -(1LL << (kind.width - 1));
+    if (dividend == minimum && divisor == -1) return newNonConstant();
+
+    return newConstant((uint64_t)(isDivide ? dividend / divisor : dividend % divisor), kind);
+}
+
+static ConstValue evaluateComparison(OperatorType operator, ConstValue left, ConstValue right) {
+    int comparison;
+    if (left.kind.isSigned) {
+        int64_t l = constantAsSigned(left), r = constantAsSigned(right);
+        comparison = (l > r) - (l < r);
+    } else {
+        comparison = (left.bits > right.bits) - (left.bits < right.bits);
+    }
+
+    switch (operator) {
+        case OP_LESS_THAN:             return newBooleanConstant(comparison < 0);
+        case OP_GREATER_THAN:          return newBooleanConstant(comparison > 0);
+        case OP_LESS_THAN_EQUALS:      return newBooleanConstant(comparison <= 0);
+        case OP_GREATER_THAN_EQUALS:   return newBooleanConstant(comparison >= 0);
+        case OP_EQUALS:                return newBooleanConstant(comparison == 0);
+        default:                       return newBooleanConstant(comparison != 0);
+    }
+}
+
+ConstValue applyBinaryOperator(OperatorType operator, ConstValue left, ConstValue right) {
+    if (!left.isConstant) return left;
+    if (!right.isConstant) return right;
+
+    if (operator == OP_AND) return newBooleanConstant(left.bits != 0 && right.bits != 0);
+    if (operator == OP_OR) return newBooleanConstant(left.bits != 0 || right.bits != 0);
+
+    left = promoteConstant(left);
+    right = promoteConstant(right);
+
+    if (operator == OP_BITWISE_SHIFT_LEFT || operator == OP_BITWISE_SHIFT_RIGHT) {
+        return evaluateShift(operator, left, right);
+    }
+
+    IntegerKind kind = commonKind(left.kind, right.kind);
+    left = convertConstant(left, kind);
+    right = convertConstant(right, kind);
+
+    switch (operator) {
+        case OP_PLUS:
+        case OP_MINUS:
+        case OP_DEREF: {
+            return evaluateArithmetic(operator, left, right, kind);
+        }
+
+        // '&' between two operands is parsed as the address-of operator
+        case OP_ADDRESS_OF:
+        case OP_BITWISE_AND: return newConstant(left.bits & right.bits, kind);
+        case OP_BITWISE_OR:  return newConstant(left.bits | right.bits, kind);
+        case OP_BITWISE_XOR: return newConstant(left.bits ^ right.bits, kind);
+
+        case OP_DIVIDE:
+        case OP_MOD: {
+            return evaluateDivision(operator, left, right, kind);
+        }
+
+        case OP_LESS_THAN:
+        case OP_GREATER_THAN:
+        case OP_LESS_THAN_EQUALS:
+        case OP_GREATER_THAN_EQUALS:
+        case OP_EQUALS:
+        case OP_NOT_EQUALS: {
+            return evaluateComparison(operator, left, right);
+        }
+
+        default: {
+            return newNonConstant();
+        }
+    }
+}
+
+static ConstValue evaluateBinary(AstExpr *expr) {
+    OperatorType operator = expr->asBinary.operator;
+
+    if (operator == OP_AS_CAST) return evaluateCast(expr);
+    if (operator == OP_AND || operator == OP_OR) return evaluateLogical(expr);
+
+    ConstValue left = evaluateConstant(expr->asBinary.left);
+    if (!left.isConstant) return left;
+
+    return applyBinaryOperator(operator, left, evaluateConstant(expr->asBinary.right));
+}
+
+ConstValue applyUnaryOperator(OperatorType operator, ConstValue right) {
+    if (!right.isConstant) return right;
+
+    switch (operator) {
+        case OP_MINUS: {
+            right = promoteConstant(right);
+            if (!right.kind.isSigned) return newConstant(0 - right.bits, right.kind);
+
+            return newSignedResult(constantAsSigned(right) == INT64_MIN, -constantAsSigned(right), right.kind);
+        }
+        case OP_BITWISE_NOT: {
+            right = promoteConstant(right);
+            return newConstant(~right.bits, right.kind);
+        }
+        case OP_NOT: {
+            return newBooleanConstant(right.bits == 0);
+        }
+        default: {
+            return newNonConstant();
+        }
+    }
+}
+
+static ConstValue evaluateUnary(AstExpr *expr) {
+    return applyUnaryOperator(expr->asUnary.operator, evaluateConstant(expr->asUnary.right));
+}
+
+static ConstValue evaluateTernary(AstExpr *expr) {
+    ConstValue condition = evaluateConstant(expr->asTernary.condition);
+    if (!condition.isConstant) return condition;
+
+    // the result takes the common type of both branches so both must be known
+    ConstValue trueValue = evaluateConstant(expr->asTernary.trueExpr);
+    ConstValue falseValue = evaluateConstant(expr->asTernary.falseExpr);
+    if (!trueValue.isConstant || !falseValue.isConstant) return newNonConstant();
+
+    bool isBoolean = trueValue.isBoolean && falseValue.isBoolean;
+
+    trueValue = promoteConstant(trueValue);
+    falseValue = promoteConstant(falseValue);
+
+    IntegerKind kind = commonKind(trueValue.kind, falseValue.kind);
+    ConstValue result = convertConstant(condition.bits != 0 ? trueValue : falseValue, kind);
+    result.isBoolean = isBoolean;
+
+    return result;
+}
+
+ConstValue evaluateConstant(AstExpr *expr) {
+    if (!expr) return newNonConstant();
+
+    switch (expr->type) {
+        case AST_INTEGER_LITERAL: {
+            long long value = expr->asInteger.value;
+            bool fitsInt = value >= INT32_MIN && value <= INT32_MAX;
+
+            return newConstant((uint64_t)value, fitsInt ? intKind : longKind);
+        }
+        case AST_BOOL_LITERAL: {
+            return newBooleanConstant(expr->asBool.value);
+        }
+        case AST_CHAR_LITERAL: {
+            uint64_t value;
+            if (!evaluateCharLiteral(expr->asChar.value, &value)) return newNonConstant();
+
+            return newConstant(value, intKind);
+        }
+        case AST_GROUPING: {
+            return evaluateConstant(expr->asGrouping.expression);
+        }
+        case AST_UNARY: {
+            return evaluateUnary(expr);
+        }
+        case AST_BINARY: {
+            return evaluateBinary(expr);
+        }
+        case AST_TERNARY: {
+            return evaluateTernary(expr);
+        }
+        default: {
+            return newNonConstant();
+        }
+    }
+}
+
+// a literal which already has the type of the value it holds, folding it again would change nothing
+static bool isFoldedLiteral(AstExpr *expr) {
+    switch (expr->type) {
+        case AST_INTEGER_LITERAL:
+        case AST_BOOL_LITERAL:
+        case AST_CHAR_LITERAL: {
+            return true;
+        }
+        case AST_BINARY: {
+            return expr->asBinary.operator == OP_AS_CAST && expr->asBinary.left->type == AST_INTEGER_LITERAL;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+// plain literals are 'int' in C so any other type is kept with a cast
+AstExpr *newConstantExpr(ConstValue value) {
+    if (value.isBoolean) return newBoolExpr(value.bits != 0);
+
+    int64_t signedValue = constantAsSigned(value);
+
+    bool isInt = value.kind.width == 32 && value.kind.isSigned;
+    if (isInt && signedValue != INT32_MIN) return newIntegerExpr(signedValue);
+
+    AstExpr *literal = newIntegerExpr(signedValue);
+    AstExpr *type = newIdentifierExpr(integerKindName(value.kind));
+
+    return newBinaryExpr(type, OP_AS_CAST, literal);
+}
+
+void replaceExpr(AstExpr *expr, AstExpr *replacement) {
+    AstExpr *old = malloc(sizeof(AstExpr));
+    if (!old) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    *old = *expr;
+    *expr = *replacement;
+
+    free(replacement);
+    freeExpr(old);
+}
+
+// keeps the operator precedence of a branch which is lifted out of a ternary
+static AstExpr *groupIfCompound(AstExpr *expr) {
+    switch (expr->type) {
+        case AST_UNARY:
+        case AST_BINARY:
+        case AST_TERNARY: {
+            return newGroupingExpr(expr);
+        }
+        default: {
+            return expr;
+        }
+    }
+}
+
+static bool containsStopVisitor(AstExpr *expr, void *context) {
+    bool *found = context;
+    if (expr->type == AST_STOP) *found = true;
+
+    return !*found;
+}
+
+MatchCaseExpr *selectMatchCase(MatchExpr match, ConstValue subject) {
+    if (!subject.isConstant) return NULL;
+
+    subject = promoteConstant(subject);
+
+    MatchCaseExpr *elseCase = NULL;
+    MatchCaseExpr *selected = NULL;
+
+    // every pattern must be known, otherwise an earlier unknown one could be the match
+    for (int i = 0; i < match.caseCount; i++) {
+        if (match.cases[i].isElseCase) {
+            elseCase = &match.cases[i];
+            continue;
+        }
+
+        ConstValue pattern = evaluateConstant(match.cases[i].pattern);
+        if (!pattern.isConstant) return NULL;
+
+        pattern = convertConstant(pattern, subject.kind);
+        if (!selected && pattern.bits == subject.bits) selected = &match.cases[i];
+    }
+
+    return selected ? selected : elseCase;
+}
+
+// replaces a match on a constant with the arm that would be taken
+static bool collapseMatch(AstExpr *expr) {
+    MatchCaseExpr *selected = selectMatchCase(expr->asMatch, evaluateConstant(expr->asMatch.expression));
+    if (!selected) return false;
+
+    // a 'stop' would break out of the emitted switch rather than the loop around it
+    bool hasStop = false;
+    walkExpr(selected->expression, containsStopVisitor, &hasStop);
+    if (hasStop) return false;
+
+    AstExpr *arm = selected->expression;
+    selected->expression = NULL;
+
+    replaceExpr(expr, arm);
+    return true;
+}
+
+static bool foldVisitor(AstExpr *expr, void *context) {
+    switch (expr->type) {
+        case AST_GROUPING:
+        case AST_UNARY:
+        case AST_BINARY:
+        case AST_TERNARY: {
+            if (isFoldedLiteral(expr)) return false;
+
+            ConstValue value = evaluateConstant(expr);
+            if (value.isConstant) {
+                replaceExpr(expr, newConstantExpr(value));
+                return false;
+            }
+
+            if (expr->type != AST_TERNARY) return true;
+
+            ConstValue condition = evaluateConstant(expr->asTernary.condition);
+            if (!condition.isConstant) return true;
+
+            AstExpr *branch;
+            if (condition.bits != 0) {
+                branch = expr->asTernary.trueExpr;
+                expr->asTernary.trueExpr = NULL;
+            } else {
+                branch = expr->asTernary.falseExpr;
+                expr->asTernary.falseExpr = NULL;
+            }
+
+            replaceExpr(expr, groupIfCompound(branch));
+            walkExpr(expr, foldVisitor, context);
+
+            return false;
+        }
+        case AST_MATCH: {
+            if (!collapseMatch(expr)) return true;
+
+            walkExpr(expr, foldVisitor, context);
+            return false;
+        }
+        default: {
+            return true;
+        }
+    }
+}
+
+void foldConstants(Ast ast) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        walkExpr(ast.exprs[i], foldVisitor, NULL);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef fold_h
+#define fold_h
+
+#include <stdint.h>
+
+#include "parse.h"
+
+// an integer type as C sees it after mapping, 'i32' is { 32, true }
+typedef struct {
+    uint8_t width;
+    bool    isSigned;
+} IntegerKind;
+
+typedef struct {
+    bool        isConstant;
+
+    // the value truncated to 'kind.width' bits
+    uint64_t    bits;
+    IntegerKind kind;
+
+    // the result of a comparison or logical operator, emitted as 'true' or 'false'
+    bool        isBoolean;
+} ConstValue;
+
+// evaluates 'expr' following C's promotion and conversion rules
+// anything which would be undefined or is not an integer expression is not constant
+ConstValue evaluateConstant(AstExpr *expr);
+
+int64_t constantAsSigned(ConstValue value);
+
+// the type 'kind' maps back to, { 32, true } is 'i32'
+char *integerKindName(IntegerKind kind);
+
+// the building blocks of 'evaluateConstant', for evaluating with values that are known some other way
+// '&&' and '||' evaluate both operands here, callers which need short circuiting must handle it first
+ConstValue applyBinaryOperator(OperatorType operator, ConstValue left, ConstValue right);
+ConstValue applyUnaryOperator(OperatorType operator, ConstValue right);
+ConstValue castConstant(ConstValue value, char *typeName);
+
+// the case taken when matching on 'subject', or null if it cannot be known
+MatchCaseExpr *selectMatchCase(MatchExpr match, ConstValue subject);
+
+AstExpr *newConstantExpr(ConstValue value);
+
+// overwrites 'expr' in place and frees what it held
+// 'replacement' may be a child of 'expr', it must be detached by the caller first
+void replaceExpr(AstExpr *expr, AstExpr *replacement);
+
+// replaces constant subtrees with literals and collapses ternaries and matches on constants
+void foldConstants(Ast ast);
+
+#endif
@@ -0,0 +1,692 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "generic.h"
+#include "atomic.h"
+#include "pool.h"
+#include "err.h"
+
+// a generic which keeps instantiating itself with ever larger types would never finish
+#define MAX_SPECIALIZATIONS 1024
+
+// what a specialization was made from, so 'Vec__i32' can be matched against 'Vec<T>'
+typedef struct {
+    char     *name;
+    char     *genericName;
+
+    TypeExpr *arguments;
+    int       argumentCount;
+} Specialization;
+
+typedef struct {
+    Analyzer       *analyzer;
+    Ast            *ast;
+
+    // the function being walked, type arguments are inferred from its variables
+    AstExpr        *function;
+
+    Specialization *specializations;
+    int             specializationCount;
+    int             specializationCapacity;
+} Instantiator;
+
+// the type parameters of one generic and what they stand for in a specialization of it
+typedef struct {
+    Analyzer *analyzer;
+    char     *name;
+
+    char    **parameters;
+    TypeExpr *arguments;
+    int       count;
+} Substitution;
+
+static bool instantiateVisitor(AstExpr *expr, void *context);
+
+static void raiseNotGeneric(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' is not generic and cannot be given type arguments\n", name
+    );
+}
+
+static void raiseTypeArgumentCount(Analyzer *analyzer, char *name, int expected, int given) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' takes %d type argument(s) but was given %d\n", name, expected, given
+    );
+}
+
+static void raiseMissingTypeArguments(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "generic struct '%s' must be given type arguments, as in '%s<i32>'\n", name, name
+    );
+}
+
+static void raiseCannotInfer(Analyzer *analyzer, char *parameter, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "cannot infer type parameter '%s' of '%s' from the arguments, give it as '%s<...>(...)'\n", parameter, name, name
+    );
+}
+
+static void raiseConflictingInference(Analyzer *analyzer, char *parameter, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "type parameter '%s' of '%s' is inferred as two different types\n", parameter, name
+    );
+}
+
+static void raiseNestedTypeArgument(Analyzer *analyzer, char *parameter, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "type parameter '%s' of '%s' is given an array or slice, which cannot be used as the element of another array, slice or pointer\n", parameter, name
+    );
+}
+
+static void raiseTypeParameterExpression(Analyzer *analyzer, char *parameter, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "type parameter '%s' of '%s' is given a pointer, array or slice, which cannot be written in an expression\n", parameter, name
+    );
+}
+
+static void raiseGenericStructFunction(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "generic struct '%s' cannot have functions, write them as generic functions taking the struct instead\n", name
+    );
+}
+
+static void raiseGenericMemberFunction(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "generic function '%s' must be declared outside of a struct\n", name
+    );
+}
+
+static void raiseTooManySpecializations(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "too many specializations while instantiating '%s', it may be instantiating itself with ever larger types\n", name
+    );
+}
+
+static bool isGeneric(AstExpr *expr) {
+    if (expr->type == AST_FUNCTION_DECLARATION) return expr->asFunction.typeParameterCount > 0;
+    if (expr->type == AST_STRUCT_DECLARATION) return expr->asStruct.typeParameterCount > 0;
+
+    return false;
+}
+
+static AstExpr *findDeclaration(Ast *ast, AstType type, char *name) {
+    for (int i = 0; i < ast->exprCount; i++) {
+        AstExpr *expr = ast->exprs[i];
+        if (expr->type != type) continue;
+
+        char *declarationName = type == AST_FUNCTION_DECLARATION ? expr->asFunction.name : expr->asStruct.name;
+        if (strcmp(declarationName, name) == 0) return expr;
+    }
+
+    return NULL;
+}
+
+static void appendDeclaration(Ast *ast, AstExpr *expr) {
+    if (ast->exprCount >= ast->exprCapacity) {
+        ast->exprCapacity *= 2;
+        ast->exprs = realloc(ast->exprs, sizeof(AstExpr *) * ast->exprCapacity);
+    }
+
+    ast->exprs[ast->exprCount++] = expr;
+}
+
+static void appendText(char **text, size_t *capacity, const char *suffix) {
+    size_t length = strlen(*text);
+    size_t suffixLength = strlen(suffix);
+
+    while (length + suffixLength + 1 > *capacity) {
+        *capacity *= 2;
+        *text = realloc(*text, *capacity);
+    }
+
+    memcpy(*text + length, suffix, suffixLength + 1);
+}
+
+// 'Vec' given '[]*u8' is 'Vec__slice_u8_ptr', following how slice structs are named
+static char *mangleName(char *name, TypeExpr *arguments, int count) {
+    size_t capacity = 32;
+    char *mangled = malloc(capacity);
+    mangled[0] = '\0';
+
+    appendText(&mangled, &capacity, name);
+
+    for (int i = 0; i < count; i++) {
+        appendText(&mangled, &capacity, "__");
+
+        if (arguments[i].arrayLength) {
+            char length[24];
+            snprintf(length, sizeof(length), "array%d_", arguments[i].arrayLength);
+            appendText(&mangled, &capacity, length);
+        }
+        if (arguments[i].isSlice) appendText(&mangled, &capacity, "slice_");
+
+        appendText(&mangled, &capacity, arguments[i].name);
+        for (int j = 0; j < arguments[i].ptrDepth; j++) appendText(&mangled, &capacity, "_ptr");
+    }
+
+    return mangled;
+}
+
+static void clearTypeArguments(TypeExpr **arguments, int *count) {
+    for (int i = 0; i < *count; i++) {
+        freeType((*arguments)[i]);
+    }
+    free(*arguments);
+
+    *arguments = NULL;
+    *count = 0;
+}
+
+static int findTypeParameter(Substitution *substitution, char *name) {
+    if (!name) return -1;
+
+    for (int i = 0; i < substitution->count; i++) {
+        if (strcmp(substitution->parameters[i], name) == 0) return i;
+    }
+
+    return -1;
+}
+
+// '[]T' given '*u8' is '[]*u8', the pointers of both are kept
+static void substituteType(Substitution *substitution, TypeExpr *type) {
+    for (int i = 0; i < type->typeArgumentCount; i++) {
+        substituteType(substitution, &type->typeArguments[i]);
+    }
+
+    int index = findTypeParameter(substitution, type->name);
+    if (index < 0) return;
+
+    TypeExpr argument = substitution->arguments[index];
+    bool isSequence = argument.arrayLength || argument.isSlice;
+
+    if (isSequence && (type->arrayLength || type->isSlice || type->ptrDepth)) {
+        raiseNestedTypeArgument(substitution->analyzer, substitution->parameters[index], substitution->name);
+        return;
+    }
+
+    free(type->name);
+    type->name = strdup(argument.name);
+    type->ptrDepth += argument.ptrDepth;
+
+    if (isSequence) {
+        type->arrayLength = argument.arrayLength;
+        type->isSlice = argument.isSlice;
+    }
+}
+
+static bool substituteVisitor(AstExpr *expr, void *context) {
+    Substitution *substitution = context;
+
+    switch (expr->type) {
+        case AST_FUNCTION_DECLARATION: {
+            substituteType(substitution, &expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                substituteType(substitution, &expr->asFunction.parameters[i].type);
+            }
+            break;
+        }
+        case AST_LET: {
+            substituteType(substitution, &expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            substituteType(substitution, &expr->asStructField.type);
+            break;
+        }
+        case AST_FOR: {
+            if (expr->asFor.type.name) substituteType(substitution, &expr->asFor.type);
+            break;
+        }
+        case AST_TYPE_EXPR: {
+            substituteType(substitution, &expr->asType);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            for (int i = 0; i < expr->asCallExpr.typeArgumentCount; i++) {
+                substituteType(substitution, &expr->asCallExpr.typeArguments[i]);
+            }
+            break;
+        }
+        case AST_IDENTIFIER: {
+            // the type of 'as' and 'sizeof' is written as an identifier
+            int index = findTypeParameter(substitution, expr->asIdentifier.name);
+            if (index < 0) break;
+
+            TypeExpr argument = substitution->arguments[index];
+            if (argument.ptrDepth || argument.arrayLength || argument.isSlice) {
+                raiseTypeParameterExpression(substitution->analyzer, substitution->parameters[index], substitution->name);
+                break;
+            }
+
+            free(expr->asIdentifier.name);
+            expr->asIdentifier.name = strdup(argument.name);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// a copy of 'generic' named 'name' with its type parameters replaced by 'arguments'
+// it is added to the program and walked like any other declaration, instantiating what it uses in turn
+static void specialize(Instantiator *instantiator, AstExpr *generic, TypeExpr *arguments, char *name) {
+    bool isFunction = generic->type == AST_FUNCTION_DECLARATION;
+    char *genericName = isFunction ? generic->asFunction.name : generic->asStruct.name;
+
+    if (instantiator->specializationCount >= MAX_SPECIALIZATIONS) {
+        if (!instantiator->analyzer->hadErr) raiseTooManySpecializations(instantiator->analyzer, genericName);
+        return;
+    }
+
+    if (instantiator->specializationCount >= instantiator->specializationCapacity) {
+        instantiator->specializationCapacity *= 2;
+        instantiator->specializations = realloc(instantiator->specializations, sizeof(Specialization) * instantiator->specializationCapacity);
+    }
+
+    AstExpr *specialization = cloneExpr(generic);
+
+    char ***parameters = isFunction ? &specialization->asFunction.typeParameters : &specialization->asStruct.typeParameters;
+    int *parameterCount = isFunction ? &specialization->asFunction.typeParameterCount : &specialization->asStruct.typeParameterCount;
+
+    Substitution substitution = {
+        .analyzer = instantiator->analyzer,
+        .name = genericName,
+        .parameters = *parameters,
+        .arguments = arguments,
+        .count = *parameterCount,
+    };
+    walkExpr(specialization, substituteVisitor, &substitution);
+
+    for (int i = 0; i < *parameterCount; i++) {
+        free((*parameters)[i]);
+    }
+    free(*parameters);
+    *parameters = NULL;
+    *parameterCount = 0;
+
+    char **specializationName = isFunction ? &specialization->asFunction.name : &specialization->asStruct.name;
+    free(*specializationName);
+    *specializationName = strdup(name);
+
+    Specialization *record = &instantiator->specializations[instantiator->specializationCount++];
+    record->name = strdup(name);
+    record->genericName = strdup(genericName);
+    record->argumentCount = substitution.count;
+    record->arguments = malloc(sizeof(TypeExpr) * substitution.count);
+
+    for (int i = 0; i < substitution.count; i++) {
+        record->arguments[i] = cloneType(arguments[i]);
+    }
+
+    appendDeclaration(instantiator->ast, specialization);
+}
+
+// 'atomic<T>' is built in, it is renamed as a generic would be but nothing is specialized
+static void resolveAtomicType(Instantiator *instantiator, TypeExpr *type) {
+    if (!type->typeArgumentCount) {
+        raiseMissingTypeArguments(instantiator->analyzer, type->name);
+        return;
+    }
+
+    if (type->typeArgumentCount != 1) {
+        raiseTypeArgumentCount(instantiator->analyzer, type->name, 1, type->typeArgumentCount);
+        return;
+    }
+
+    char *name = atomicTypeName(type->typeArguments[0]);
+
+    free(type->name);
+    type->name = name;
+
+    clearTypeArguments(&type->typeArguments, &type->typeArgumentCount);
+}
+
+// 'Pool<T>' is the builtin 'Pool' handing out '*T', unless the program declares its own 'Pool'
+static void resolvePoolType(Instantiator *instantiator, TypeExpr *type) {
+    if (type->typeArgumentCount != 1) {
+        raiseTypeArgumentCount(instantiator->analyzer, type->name, 1, type->typeArgumentCount);
+        return;
+    }
+
+    char *name = poolTypeName(type->typeArguments[0]);
+
+    free(type->name);
+    type->name = name;
+
+    clearTypeArguments(&type->typeArguments, &type->typeArgumentCount);
+}
+
+// replaces 'Vec<i32>' by the name of its specialization, 'Vec__i32'
+static void resolveType(Instantiator *instantiator, TypeExpr *type) {
+    if (!type->name) return;
+
+    for (int i = 0; i < type->typeArgumentCount; i++) {
+        resolveType(instantiator, &type->typeArguments[i]);
+    }
+
+    if (strcmp(type->name, "atomic") == 0) {
+        resolveAtomicType(instantiator, type);
+        return;
+    }
+
+    if (strcmp(type->name, "Pool") == 0 && type->typeArgumentCount && !findDeclaration(instantiator->ast, AST_STRUCT_DECLARATION, "Pool")) {
+        resolvePoolType(instantiator, type);
+        return;
+    }
+
+    AstExpr *generic = findDeclaration(instantiator->ast, AST_STRUCT_DECLARATION, type->name);
+    bool isGenericStruct = generic && isGeneric(generic);
+
+    if (!type->typeArgumentCount) {
+        if (isGenericStruct) raiseMissingTypeArguments(instantiator->analyzer, type->name);
+        return;
+    }
+
+    if (!isGenericStruct) {
+        raiseNotGeneric(instantiator->analyzer, type->name);
+        return;
+    }
+
+    if (type->typeArgumentCount != generic->asStruct.typeParameterCount) {
+        raiseTypeArgumentCount(instantiator->analyzer, type->name, generic->asStruct.typeParameterCount, type->typeArgumentCount);
+        return;
+    }
+
+    char *name = mangleName(type->name, type->typeArguments, type->typeArgumentCount);
+    if (!findDeclaration(instantiator->ast, AST_STRUCT_DECLARATION, name)) {
+        specialize(instantiator, generic, type->typeArguments, name);
+    }
+
+    free(type->name);
+    type->name = name;
+
+    clearTypeArguments(&type->typeArguments, &type->typeArgumentCount);
+}
+
+// variables and the results of calls are used first, literals only decide what nothing else did
+static bool findArgumentType(Instantiator *instantiator, AstExpr *argument, bool isLiteralPass, TypeExpr *type) {
+    switch (argument->type) {
+        case AST_GROUPING: {
+            return findArgumentType(instantiator, argument->asGrouping.expression, isLiteralPass, type);
+        }
+        case AST_IDENTIFIER: {
+            return !isLiteralPass && instantiator->function && findLocalType(instantiator->function, argument->asIdentifier.name, type);
+        }
+        case AST_UNARY: {
+            UnaryExpr unary = argument->asUnary;
+
+            if (unary.operator == OP_MINUS) return findArgumentType(instantiator, unary.right, isLiteralPass, type);
+            if (unary.operator != OP_ADDRESS_OF || !findArgumentType(instantiator, unary.right, isLiteralPass, type)) return false;
+
+            type->ptrDepth++;
+            return true;
+        }
+        case AST_CALL_EXPR: {
+            AstExpr *callee = findFunction(*instantiator->ast, argument->asCallExpr.name);
+            if (isLiteralPass || !callee || isGeneric(callee)) return false;
+
+            *type = callee->asFunction.returnType;
+            return true;
+        }
+        case AST_INTEGER_LITERAL: {
+            *type = (TypeExpr){ "i32", 0, 0, false, NULL, 0 };
+            return isLiteralPass;
+        }
+        case AST_FLOAT_LITERAL: {
+            *type = (TypeExpr){ "f64", 0, 0, false, NULL, 0 };
+            return isLiteralPass;
+        }
+        case AST_BOOL_LITERAL: {
+            *type = (TypeExpr){ "bool", 0, 0, false, NULL, 0 };
+            return isLiteralPass;
+        }
+        case AST_CHAR_LITERAL: {
+            *type = (TypeExpr){ "char", 0, 0, false, NULL, 0 };
+            return isLiteralPass;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+static bool isSameType(TypeExpr a, TypeExpr b) {
+    return strcmp(a.name, b.name) == 0 && a.ptrDepth == b.ptrDepth && a.arrayLength == b.arrayLength && a.isSlice == b.isSlice;
+}
+
+static Specialization *findSpecialization(Instantiator *instantiator, char *name) {
+    for (int i = 0; i < instantiator->specializationCount; i++) {
+        if (strcmp(instantiator->specializations[i].name, name) == 0) return &instantiator->specializations[i];
+    }
+
+    return NULL;
+}
+
+typedef struct {
+    Instantiator *instantiator;
+    Substitution  parameters;
+
+    TypeExpr     *arguments;
+    bool         *isKnown;
+
+    // a literal only decides a type parameter nothing else did
+    bool          isLiteralPass;
+} Inference;
+
+// matches a parameter written with type parameters, 'T', '*T', '[]T' or 'Vec<T>', against the type of its argument
+static void inferFromType(Inference *inference, TypeExpr parameter, TypeExpr argument) {
+    if (parameter.typeArgumentCount) {
+        Specialization *specialization = findSpecialization(inference->instantiator, argument.name);
+        if (!specialization || strcmp(specialization->genericName, parameter.name) != 0) return;
+        if (specialization->argumentCount != parameter.typeArgumentCount) return;
+
+        if (parameter.ptrDepth != argument.ptrDepth || parameter.isSlice != argument.isSlice) return;
+
+        for (int i = 0; i < parameter.typeArgumentCount; i++) {
+            inferFromType(inference, parameter.typeArguments[i], specialization->arguments[i]);
+        }
+        return;
+    }
+
+    int index = findTypeParameter(&inference->parameters, parameter.name);
+    if (index < 0) return;
+    if (inference->isLiteralPass && inference->isKnown[index]) return;
+
+    if (parameter.arrayLength || parameter.isSlice) {
+        if (!argument.arrayLength && !argument.isSlice) return;
+
+        argument.arrayLength = 0;
+        argument.isSlice = false;
+    }
+
+    if (argument.ptrDepth < parameter.ptrDepth) return;
+    argument.ptrDepth -= parameter.ptrDepth;
+
+    if (inference->isKnown[index]) {
+        if (!isSameType(inference->arguments[index], argument)) {
+            raiseConflictingInference(inference->instantiator->analyzer, inference->parameters.parameters[index], inference->parameters.name);
+        }
+        return;
+    }
+
+    inference->arguments[index] = cloneType(argument);
+    inference->isKnown[index] = true;
+}
+
+static bool inferTypeArguments(Instantiator *instantiator, FunctionDeclaration generic, CallExpr *call) {
+    int count = generic.typeParameterCount;
+
+    Inference inference = {
+        .instantiator = instantiator,
+        .parameters = { instantiator->analyzer, generic.name, generic.typeParameters, NULL, count },
+        .arguments = calloc(count, sizeof(TypeExpr)),
+        .isKnown = calloc(count, sizeof(bool)),
+        .isLiteralPass = false,
+    };
+
+    for (int pass = 0; pass < 2; pass++) {
+        inference.isLiteralPass = pass == 1;
+
+        for (int i = 0; i < generic.paramCount && i < call->argCount; i++) {
+            TypeExpr argument;
+            if (!findArgumentType(instantiator, call->arguments[i], inference.isLiteralPass, &argument)) continue;
+
+            inferFromType(&inference, generic.parameters[i].type, argument);
+        }
+    }
+
+    bool isInferred = true;
+    for (int i = 0; i < count; i++) {
+        if (inference.isKnown[i]) continue;
+
+        raiseCannotInfer(instantiator->analyzer, generic.typeParameters[i], generic.name);
+        inference.arguments[i] = (TypeExpr){ strdup("void"), 0, 0, false, NULL, 0 };
+        isInferred = false;
+    }
+
+    free(inference.isKnown);
+
+    call->typeArguments = inference.arguments;
+    call->typeArgumentCount = count;
+
+    return isInferred;
+}
+
+// replaces 'max<i32>(a, b)', or 'max(a, b)' once 'T' is inferred, by a call to 'max__i32'
+static void resolveCall(Instantiator *instantiator, CallExpr *call) {
+    // the arguments are resolved first so the result of a generic call can be inferred from
+    for (int i = 0; i < call->argCount; i++) {
+        walkExpr(call->arguments[i], instantiateVisitor, instantiator);
+    }
+
+    for (int i = 0; i < call->typeArgumentCount; i++) {
+        resolveType(instantiator, &call->typeArguments[i]);
+    }
+
+    AstExpr *generic = findDeclaration(instantiator->ast, AST_FUNCTION_DECLARATION, call->name);
+    if (!generic || !isGeneric(generic)) {
+        if (call->typeArgumentCount) raiseNotGeneric(instantiator->analyzer, call->name);
+        return;
+    }
+
+    FunctionDeclaration function = generic->asFunction;
+
+    if (!call->typeArgumentCount && !inferTypeArguments(instantiator, function, call)) return;
+
+    if (call->typeArgumentCount != function.typeParameterCount) {
+        raiseTypeArgumentCount(instantiator->analyzer, call->name, function.typeParameterCount, call->typeArgumentCount);
+        return;
+    }
+
+    char *name = mangleName(call->name, call->typeArguments, call->typeArgumentCount);
+    if (!findDeclaration(instantiator->ast, AST_FUNCTION_DECLARATION, name)) {
+        specialize(instantiator, generic, call->typeArguments, name);
+    }
+
+    free(call->name);
+    call->name = name;
+
+    clearTypeArguments(&call->typeArguments, &call->typeArgumentCount);
+}
+
+static bool instantiateVisitor(AstExpr *expr, void *context) {
+    Instantiator *instantiator = context;
+
+    switch (expr->type) {
+        case AST_FUNCTION_DECLARATION: {
+            if (isGeneric(expr)) {
+                raiseGenericMemberFunction(instantiator->analyzer, expr->asFunction.name);
+                return false;
+            }
+
+            instantiator->function = expr;
+
+            resolveType(instantiator, &expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                resolveType(instantiator, &expr->asFunction.parameters[i].type);
+            }
+            break;
+        }
+        case AST_LET: {
+            resolveType(instantiator, &expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            resolveType(instantiator, &expr->asStructField.type);
+            break;
+        }
+        case AST_FOR: {
+            resolveType(instantiator, &expr->asFor.type);
+            break;
+        }
+        case AST_TYPE_EXPR: {
+            resolveType(instantiator, &expr->asType);
+            break;
+        }
+        case AST_CALL_EXPR: {
+            resolveCall(instantiator, &expr->asCallExpr);
+            return false;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+void instantiateGenerics(Analyzer *analyzer) {
+    Instantiator instantiator = {
+        .analyzer = analyzer,
+        .ast = &analyzer->parser->ast,
+        .function = NULL,
+        .specializations = malloc(sizeof(Specialization)),
+        .specializationCount = 0,
+        .specializationCapacity = 1,
+    };
+    Ast *ast = instantiator.ast;
+
+    // specializations are appended as they are found, so this also walks each of them
+    for (int i = 0; i < ast->exprCount; i++) {
+        AstExpr *expr = ast->exprs[i];
+
+        if (!isGeneric(expr)) {
+            instantiator.function = NULL;
+            walkExpr(expr, instantiateVisitor, &instantiator);
+            continue;
+        }
+
+        if (expr->type != AST_STRUCT_DECLARATION) continue;
+
+        for (int j = 0; j < expr->asStruct.memberCount; j++) {
+            if (expr->asStruct.members[j]->type == AST_FUNCTION_DECLARATION) {
+                raiseGenericStructFunction(analyzer, expr->asStruct.name);
+                break;
+            }
+        }
+    }
+
+    int count = 0;
+    for (int i = 0; i < ast->exprCount; i++) {
+        if (isGeneric(ast->exprs[i])) {
+            freeExpr(ast->exprs[i]);
+            continue;
+        }
+
+        ast->exprs[count++] = ast->exprs[i];
+    }
+    ast->exprCount = count;
+
+    for (int i = 0; i < instantiator.specializationCount; i++) {
+        Specialization specialization = instantiator.specializations[i];
+
+        free(specialization.name);
+        free(specialization.genericName);
+        clearTypeArguments(&specialization.arguments, &specialization.argumentCount);
+    }
+    free(instantiator.specializations);
+}
@@ -0,0 +1,10 @@
+#ifndef generic_h
+#define generic_h
+
+#include "analyze.h"
+
+// gives every generic function and struct a specialization per set of type arguments it is used with
+// uses are renamed to the specialization, 'max<i32>' becomes 'max__i32', and the generic declarations are removed
+void instantiateGenerics(Analyzer *analyzer);
+
+#endif
@@ -0,0 +1,305 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "inline.h"
+#include "analyze.h"
+#include "fold.h"
+#include "err.h"
+
+static bool inlineVisitor(AstExpr *expr, void *context);
+
+Inliner newInliner(Ast ast, int maxNodes, int maxDepth) {
+    Inliner inliner;
+    inliner.ast = ast;
+
+    inliner.maxNodes = maxNodes;
+    inliner.maxDepth = maxDepth;
+
+    inliner.depth = 0;
+    inliner.tempCount = 0;
+    inliner.caller = NULL;
+
+    return inliner;
+}
+
+static bool countVisitor(AstExpr *expr, void *context) {
+    int *count = context;
+    (*count)++;
+
+    // prevent compiler warning
+    return expr != NULL;
+}
+
+static int countNodes(AstExpr *expr) {
+    int count = 0;
+    walkExpr(expr, countVisitor, &count);
+
+    return count;
+}
+
+static bool isSameType(TypeExpr left, TypeExpr right) {
+    if (!left.name || !right.name || strcmp(left.name, right.name) != 0) return false;
+    if (left.typeArgumentCount || right.typeArgumentCount) return false;
+
+    return left.ptrDepth == right.ptrDepth && left.arrayLength == right.arrayLength && left.isSlice == right.isSlice;
+}
+
+// a local or parameter of the caller, otherwise a global
+static bool findVariableType(Inliner *inliner, char *name, TypeExpr *type) {
+    if (inliner->caller && findLocalType(inliner->caller, name, type)) return true;
+
+    for (int i = 0; i < inliner->ast.exprCount; i++) {
+        AstExpr *expr = inliner->ast.exprs[i];
+        if (expr->type != AST_LET || strcmp(expr->asLet.name, name) != 0) continue;
+
+        *type = expr->asLet.type;
+        return true;
+    }
+
+    return false;
+}
+
+// arguments which can be substituted directly without changing how often they are evaluated,
+// a call converts each argument to the type of its parameter so only those which already have it qualify
+static bool isTrivialArgument(Inliner *inliner, AstExpr *expr, TypeExpr parameter) {
+    switch (expr->type) {
+        case AST_INTEGER_LITERAL:
+        case AST_CHAR_LITERAL:
+        case AST_BOOL_LITERAL: {
+            ConstValue value = evaluateConstant(expr);
+            if (!value.isConstant || parameter.ptrDepth || parameter.arrayLength || parameter.isSlice) return false;
+
+            return strcmp(value.isBoolean ? "bool" : integerKindName(value.kind), parameter.name) == 0;
+        }
+        case AST_IDENTIFIER: {
+            TypeExpr type;
+            return findVariableType(inliner, expr->asIdentifier.name, &type) && isSameType(type, parameter);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+static bool isInlineCandidate(Inliner *inliner, AstExpr *function) {
+    FunctionDeclaration declaration = function->asFunction;
+
+    if (!declaration.isLambda) return false;
+    if (hasTag(declaration.tags, TAG_NOINLINE)) return false;
+
+    // cold functions stay out of line, away from the code of their callers
+    if (hasTag(declaration.tags, TAG_COLD)) return false;
+
+    // array parameters cannot be bound to temporaries, C arrays are not copied
+    for (int i = 0; i < declaration.paramCount; i++) {
+        if (declaration.parameters[i].type.arrayLength) return false;
+    }
+    if (countNodes(declaration.lambdaExpr) > inliner->maxNodes) return false;
+
+    return !isRecursive(inliner->ast, function);
+}
+
+typedef struct {
+    char *name;
+    bool  isFound;
+} DeclarationSearch;
+
+static bool findDeclarationVisitor(AstExpr *expr, void *context) {
+    DeclarationSearch *search = context;
+
+    if (expr->type == AST_LET && strcmp(expr->asLet.name, search->name) == 0) search->isFound = true;
+    if (expr->type == AST_FOR && strcmp(expr->asFor.variable, search->name) == 0) search->isFound = true;
+
+    return !search->isFound;
+}
+
+// whether 'name' is a parameter or local anywhere in 'function'
+static bool declaresName(AstExpr *function, char *name) {
+    for (int i = 0; i < function->asFunction.paramCount; i++) {
+        if (strcmp(function->asFunction.parameters[i].name, name) == 0) return true;
+    }
+
+    DeclarationSearch search = { name, false };
+    walkExpr(function, findDeclarationVisitor, &search);
+
+    return search.isFound;
+}
+
+typedef struct {
+    AstExpr             *caller;
+    FunctionDeclaration *function;
+    bool                 isCaptured;
+} CaptureSearch;
+
+static bool isParameterOf(FunctionDeclaration *function, char *name) {
+    for (int i = 0; i < function->paramCount; i++) {
+        if (strcmp(function->parameters[i].name, name) == 0) return true;
+    }
+
+    return false;
+}
+
+static bool captureVisitor(AstExpr *expr, void *context) {
+    CaptureSearch *search = context;
+
+    switch (expr->type) {
+        // a variable of the body could capture an argument substituted into it
+        case AST_LET: {
+            search->isCaptured = true;
+            break;
+        }
+        case AST_IDENTIFIER: {
+            char *name = expr->asIdentifier.name;
+            if (!isParameterOf(search->function, name) && declaresName(search->caller, name)) search->isCaptured = true;
+            break;
+        }
+        case AST_CALL_EXPR: {
+            if (declaresName(search->caller, expr->asCallExpr.name)) search->isCaptured = true;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return !search->isCaptured;
+}
+
+// the body is pasted into the caller as it is, so a global or function it names would
+// instead refer to a local of the caller with the same name
+static bool isCapturedByCaller(Inliner *inliner, AstExpr *function) {
+    if (!inliner->caller) return false;
+
+    CaptureSearch search = { inliner->caller, &function->asFunction, false };
+    walkExpr(function->asFunction.lambdaExpr, captureVisitor, &search);
+
+    return search.isCaptured;
+}
+
+typedef struct {
+    FunctionDeclaration *function;
+    AstExpr            **replacements;
+} Substitution;
+
+static bool substituteVisitor(AstExpr *expr, void *context) {
+    Substitution *substitution = context;
+    if (expr->type != AST_IDENTIFIER) return true;
+
+    for (int i = 0; i < substitution->function->paramCount; i++) {
+        if (strcmp(expr->asIdentifier.name, substitution->function->parameters[i].name) != 0) continue;
+
+        AstExpr *replacement = cloneExpr(substitution->replacements[i]);
+        free(expr->asIdentifier.name);
+
+        *expr = *replacement;
+        free(replacement);
+
+        return false;
+    }
+
+    return true;
+}
+
+static void inlineCall(Inliner *inliner, AstExpr *callExpr, AstExpr *functionExpr) {
+    CallExpr call = callExpr->asCallExpr;
+    FunctionDeclaration function = functionExpr->asFunction;
+
+    int id = inliner->tempCount++;
+
+    AstExpr **replacements = malloc(sizeof(AstExpr *) * (function.paramCount + 1));
+    AstExpr **temps = malloc(sizeof(AstExpr *) * (function.paramCount + 1));
+    if (!replacements || !temps) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    int tempCount = 0;
+
+    for (int i = 0; i < function.paramCount; i++) {
+        FunctionParameter parameter = function.parameters[i];
+
+        if (isTrivialArgument(inliner, call.arguments[i], parameter.type)) {
+            replacements[i] = call.arguments[i];
+            continue;
+        }
+
+        char name[256];
+        snprintf(name, sizeof(name), "__inline%d_%s", id, parameter.name);
+
+        AstExpr type = { .type = AST_TYPE_EXPR, .asType = cloneType(parameter.type) };
+        temps[tempCount++] = newLetDeclaration(name, &type, call.arguments[i], false);
+
+        replacements[i] = newIdentifierExpr(name);
+    }
+
+    AstExpr *body = cloneExpr(function.lambdaExpr);
+
+    Substitution substitution = { .function = &function, .replacements = replacements };
+    walkExpr(body, substituteVisitor, &substitution);
+
+    AstExpr *inlined = newInlinedCallExpr(
+        function.name, cloneType(function.returnType), temps, tempCount, function.paramCount + 1, body
+    );
+
+    free(call.name);
+    free(call.arguments);
+    free(replacements);
+
+    *callExpr = *inlined;
+    free(inlined);
+}
+
+static bool inlineVisitor(AstExpr *expr, void *context) {
+    Inliner *inliner = context;
+
+    if (expr->type == AST_FUNCTION_DECLARATION) {
+        AstExpr *enclosing = inliner->caller;
+        inliner->caller = expr;
+
+        if (expr->asFunction.isLambda) {
+            walkExpr(expr->asFunction.lambdaExpr, inlineVisitor, inliner);
+        } else {
+            for (int i = 0; i < expr->asFunction.block.count; i++) {
+                walkExpr(expr->asFunction.block.body[i], inlineVisitor, inliner);
+            }
+        }
+
+        inliner->caller = enclosing;
+        return false;
+    }
+
+    if (expr->type != AST_CALL_EXPR) return true;
+
+    // arguments are handled first so nested calls are inlined before being bound to temporaries
+    for (int i = 0; i < expr->asCallExpr.argCount; i++) {
+        walkExpr(expr->asCallExpr.arguments[i], inlineVisitor, inliner);
+    }
+
+    // a spawned call runs as a task so it stays a call
+    if (expr->asCallExpr.isSpawned) return false;
+
+    if (inliner->depth >= inliner->maxDepth) return false;
+
+    AstExpr *function = findFunction(inliner->ast, expr->asCallExpr.name);
+    if (!function || !isInlineCandidate(inliner, function)) return false;
+    if (isCapturedByCaller(inliner, function)) return false;
+
+    // arity is not checked by the analyzer yet, leave mismatched calls for the C compiler to report
+    if (function->asFunction.paramCount != expr->asCallExpr.argCount) return false;
+
+    inlineCall(inliner, expr, function);
+
+    inliner->depth++;
+    walkExpr(expr->asInlinedCall.body, inlineVisitor, inliner);
+    inliner->depth--;
+
+    return false;
+}
+
+void inlineFunctions(Inliner *inliner) {
+    if (inliner->maxDepth <= 0 || inliner->maxNodes <= 0) return;
+
+    for (int i = 0; i < inliner->ast.exprCount; i++) {
+        walkExpr(inliner->ast.exprs[i], inlineVisitor, inliner);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef inline_h
+#define inline_h
+
+#include "parse.h"
+
+typedef struct {
+    Ast  ast;
+
+    // arrow functions with more expression nodes than this are never inlined
+    int  maxNodes;
+
+    // how many levels of inlined calls may be nested inside one another
+    int  maxDepth;
+
+    int  depth;
+    int  tempCount;
+
+    // the function whose body calls are being inlined into, null for top level statements
+    AstExpr *caller;
+} Inliner;
+
+Inliner newInliner(Ast ast, int maxNodes, int maxDepth);
+
+// substitutes calls to small, non-recursive arrow functions into their callers
+void inlineFunctions(Inliner *inliner);
+
+#endif
@@ -0,0 +1,513 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "layout.h"
+#include "err.h"
+
+typedef struct {
+    Analyzer *analyzer;
+    Ast      *ast;
+
+    // the function being walked, receivers are looked up among its variables
+    AstExpr  *function;
+} MethodResolver;
+
+static bool methodCallVisitor(AstExpr *expr, void *context);
+
+static void raiseNotInterface(Analyzer *analyzer, char *structName, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' is declared 'with %s', but '%s' is not an interface\n", structName, name, name
+    );
+}
+
+static void raiseInterfaceField(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "interface '%s' can only declare functions\n", name
+    );
+}
+
+static void raiseInterfaceSelf(Analyzer *analyzer, char *interface, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "function '%s' of interface '%s' must take 'self: *%s' first\n", name, interface, interface
+    );
+}
+
+static void raiseMissingImplementation(Analyzer *analyzer, char *structName, char *interface, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' is declared 'with %s' but does not implement '%s'\n", structName, interface, name
+    );
+}
+
+static void raiseImplementationSelf(Analyzer *analyzer, char *structName, char *interface, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' of '%s' must take 'self: *%s' first to implement '%s'\n", name, structName, structName, interface
+    );
+}
+
+static void raiseImplementationSignature(Analyzer *analyzer, char *structName, char *interface, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' of '%s' does not match its signature in interface '%s'\n", name, structName, interface
+    );
+}
+
+static void raiseUnknownReceiver(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "cannot tell the type of the value '%s' is called on\n", name
+    );
+}
+
+static void raiseNotStructReceiver(Analyzer *analyzer, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' is called on a value which is not a struct, or a pointer to one\n", name
+    );
+}
+
+static void raiseNoMethod(Analyzer *analyzer, char *structName, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' has no function '%s' taking 'self'\n", structName, name
+    );
+}
+
+static void raiseNoFunction(Analyzer *analyzer, char *structName, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' has no function '%s'\n", structName, name
+    );
+}
+
+static void raiseSelfOnType(Analyzer *analyzer, char *structName, char *name) {
+    compileErrFromAnalyzer(analyzer,
+        "'%s' of '%s' takes 'self', so it must be called on a value rather than on '%s'\n", name, structName, structName
+    );
+}
+
+static void raiseNotImplemented(Analyzer *analyzer, char *interface) {
+    compileErrFromAnalyzer(analyzer,
+        "only a pointer to a struct implementing '%s' can be used as one\n", interface
+    );
+}
+
+char *methodName(char *structName, char *name) {
+    size_t length = strlen(structName) + strlen(name) + 3;
+    char *mangled = malloc(length);
+    snprintf(mangled, length, "%s__%s", structName, name);
+
+    return mangled;
+}
+
+char *conversionName(char *interface, char *structName) {
+    size_t length = strlen(interface) + strlen(structName) + 9;
+    char *mangled = malloc(length);
+    snprintf(mangled, length, "%s__from__%s", interface, structName);
+
+    return mangled;
+}
+
+bool implementsInterface(StructDeclaration *declaration, char *interface) {
+    for (int i = 0; i < declaration->interfaceCount; i++) {
+        if (strcmp(declaration->interfaces[i], interface) == 0) return true;
+    }
+
+    return false;
+}
+
+StructDeclaration *soleImplementor(Ast ast, char *interface) {
+    StructDeclaration *implementor = NULL;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+        if (expr->type != AST_STRUCT_DECLARATION || !implementsInterface(&expr->asStruct, interface)) continue;
+
+        if (implementor) return NULL;
+        implementor = &expr->asStruct;
+    }
+
+    return implementor;
+}
+
+static bool isMethod(FunctionDeclaration function) {
+    return function.paramCount > 0 && strcmp(function.parameters[0].name, "self") == 0;
+}
+
+static AstExpr *findMember(StructDeclaration *declaration, char *name) {
+    for (int i = 0; i < declaration->memberCount; i++) {
+        AstExpr *member = declaration->members[i];
+        if (member->type == AST_FUNCTION_DECLARATION && strcmp(member->asFunction.name, name) == 0) return member;
+    }
+
+    return NULL;
+}
+
+static bool isSameType(TypeExpr a, TypeExpr b) {
+    return strcmp(a.name, b.name) == 0 && a.ptrDepth == b.ptrDepth && a.arrayLength == b.arrayLength && a.isSlice == b.isSlice;
+}
+
+static bool isSelfPointer(FunctionDeclaration function, char *structName) {
+    TypeExpr self = function.parameters[0].type;
+    return self.ptrDepth == 1 && !self.arrayLength && !self.isSlice && strcmp(self.name, structName) == 0;
+}
+
+// everything but 'self' has to match, as the vtable calls the implementation in place of the signature
+static bool matchesSignature(FunctionDeclaration implementation, FunctionDeclaration signature) {
+    if (implementation.paramCount != signature.paramCount) return false;
+    if (!isSameType(implementation.returnType, signature.returnType)) return false;
+
+    for (int i = 1; i < signature.paramCount; i++) {
+        if (!isSameType(implementation.parameters[i].type, signature.parameters[i].type)) return false;
+    }
+
+    return true;
+}
+
+static void checkInterface(Analyzer *analyzer, StructDeclaration interface) {
+    for (int i = 0; i < interface.memberCount; i++) {
+        AstExpr *member = interface.members[i];
+
+        if (member->type != AST_FUNCTION_DECLARATION) {
+            raiseInterfaceField(analyzer, interface.name);
+            continue;
+        }
+
+        if (!isMethod(member->asFunction) || !isSelfPointer(member->asFunction, interface.name)) {
+            raiseInterfaceSelf(analyzer, interface.name, member->asFunction.name);
+        }
+    }
+}
+
+static void checkImplementation(Analyzer *analyzer, StructDeclaration declaration, StructDeclaration interface) {
+    for (int i = 0; i < interface.memberCount; i++) {
+        if (interface.members[i]->type != AST_FUNCTION_DECLARATION) continue;
+        FunctionDeclaration signature = interface.members[i]->asFunction;
+
+        AstExpr *implementation = findMember(&declaration, signature.name);
+        if (!implementation) {
+            raiseMissingImplementation(analyzer, declaration.name, interface.name, signature.name);
+            continue;
+        }
+
+        if (!isMethod(implementation->asFunction) || !isSelfPointer(implementation->asFunction, declaration.name)) {
+            raiseImplementationSelf(analyzer, declaration.name, interface.name, signature.name);
+            continue;
+        }
+
+        if (!matchesSignature(implementation->asFunction, signature)) {
+            raiseImplementationSignature(analyzer, declaration.name, interface.name, signature.name);
+        }
+    }
+}
+
+static void checkInterfaces(Analyzer *analyzer) {
+    Ast ast = analyzer->parser->ast;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type != AST_STRUCT_DECLARATION) continue;
+        StructDeclaration declaration = ast.exprs[i]->asStruct;
+
+        if (declaration.isInterface) checkInterface(analyzer, declaration);
+
+        for (int j = 0; j < declaration.interfaceCount; j++) {
+            StructDeclaration *interface = lookupStruct(ast, declaration.interfaces[j]);
+
+            if (!interface || !interface->isInterface) {
+                raiseNotInterface(analyzer, declaration.name, declaration.interfaces[j]);
+                continue;
+            }
+
+            checkImplementation(analyzer, declaration, *interface);
+        }
+    }
+}
+
+// the type of a value a function is called on or an interface is made from, as far as it can be known here
+static bool findValueType(MethodResolver *resolver, AstExpr *value, TypeExpr *type) {
+    switch (value->type) {
+        case AST_GROUPING: {
+            return findValueType(resolver, value->asGrouping.expression, type);
+        }
+        case AST_IDENTIFIER: {
+            return resolver->function && findLocalType(resolver->function, value->asIdentifier.name, type);
+        }
+        case AST_UNARY: {
+            OperatorType operator = value->asUnary.operator;
+            if (operator != OP_ADDRESS_OF && operator != OP_DEREF) return false;
+            if (!findValueType(resolver, value->asUnary.right, type)) return false;
+
+            if (operator == OP_ADDRESS_OF) {
+                type->ptrDepth++;
+                return true;
+            }
+
+            if (type->ptrDepth == 0) return false;
+            type->ptrDepth--;
+            return true;
+        }
+        case AST_CALL_EXPR: {
+            AstExpr *callee = findFunction(*resolver->ast, value->asCallExpr.name);
+            if (value->asCallExpr.receiver || !callee) return false;
+
+            *type = callee->asFunction.returnType;
+            return true;
+        }
+        case AST_PROPERTY_ACCESS: {
+            TypeExpr objectType;
+            if (!findValueType(resolver, value->asProperty.object, &objectType)) return false;
+            if (objectType.ptrDepth > 1 || objectType.arrayLength || objectType.isSlice) return false;
+
+            StructDeclaration *declaration = lookupStruct(*resolver->ast, objectType.name);
+            if (!declaration) return false;
+
+            for (int i = 0; i < declaration->memberCount; i++) {
+                AstExpr *member = declaration->members[i];
+
+                if (member->type == AST_STRUCT_FIELD && strcmp(member->asStructField.name, value->asProperty.property) == 0) {
+                    *type = member->asStructField.type;
+                    return true;
+                }
+            }
+            return false;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+static void prependArgument(CallExpr *call, AstExpr *argument) {
+    if (call->argCount >= call->argCapacity) {
+        call->argCapacity = call->argCount + 1;
+        call->arguments = realloc(call->arguments, sizeof(AstExpr *) * call->argCapacity);
+    }
+
+    memmove(call->arguments + 1, call->arguments, sizeof(AstExpr *) * call->argCount);
+    call->arguments[0] = argument;
+    call->argCount++;
+}
+
+static void renameCall(CallExpr *call, char *name) {
+    free(call->name);
+    call->name = name;
+}
+
+// 'Point.new(1, 2)' is a call to a function of 'Point' which does not take 'self'
+static bool resolveTypeCall(MethodResolver *resolver, CallExpr *call) {
+    AstExpr *receiver = call->receiver;
+    if (receiver->type != AST_IDENTIFIER) return false;
+
+    TypeExpr local;
+    if (resolver->function && findLocalType(resolver->function, receiver->asIdentifier.name, &local)) return false;
+
+    StructDeclaration *declaration = lookupStruct(*resolver->ast, receiver->asIdentifier.name);
+    if (!declaration) return false;
+
+    AstExpr *function = findMember(declaration, call->name);
+    if (!function) {
+        raiseNoFunction(resolver->analyzer, declaration->name, call->name);
+        return true;
+    }
+
+    if (isMethod(function->asFunction)) {
+        raiseSelfOnType(resolver->analyzer, declaration->name, call->name);
+        return true;
+    }
+
+    call->receiver = NULL;
+    freeExpr(receiver);
+
+    return true;
+}
+
+static void resolveMethodCall(MethodResolver *resolver, CallExpr *call) {
+    if (resolveTypeCall(resolver, call)) return;
+
+    AstExpr *receiver = call->receiver;
+
+    TypeExpr type;
+    if (!findValueType(resolver, receiver, &type)) {
+        raiseUnknownReceiver(resolver->analyzer, call->name);
+        return;
+    }
+
+    StructDeclaration *declaration = lookupStruct(*resolver->ast, type.name);
+    if (!declaration || type.arrayLength || type.isSlice || type.ptrDepth > 1) {
+        raiseNotStructReceiver(resolver->analyzer, call->name);
+        return;
+    }
+
+    AstExpr *method = findMember(declaration, call->name);
+    if (!method || !isMethod(method->asFunction)) {
+        raiseNoMethod(resolver->analyzer, declaration->name, call->name);
+        return;
+    }
+
+    call->receiver = NULL;
+
+    if (!declaration->isInterface) {
+        // 'self' is given as the function declares it, taking the address of the value or loading through the pointer
+        int selfDepth = method->asFunction.parameters[0].type.ptrDepth;
+
+        if (selfDepth > type.ptrDepth) receiver = newUnaryExpr(receiver, OP_ADDRESS_OF);
+        if (selfDepth < type.ptrDepth) receiver = newUnaryExpr(receiver, OP_DEREF);
+
+        prependArgument(call, receiver);
+        renameCall(call, methodName(declaration->name, call->name));
+        return;
+    }
+
+    if (type.ptrDepth) receiver = newGroupingExpr(newUnaryExpr(receiver, OP_DEREF));
+
+    // with one implementor every interface value holds one, so it is called directly and can be inlined
+    StructDeclaration *implementor = soleImplementor(*resolver->ast, declaration->name);
+    if (implementor) {
+        prependArgument(call, newPropertyAccessExpr(receiver, "self"));
+        renameCall(call, methodName(implementor->name, call->name));
+        return;
+    }
+
+    prependArgument(call, receiver);
+    renameCall(call, methodName(declaration->name, call->name));
+}
+
+static bool methodCallVisitor(AstExpr *expr, void *context) {
+    MethodResolver *resolver = context;
+
+    if (expr->type == AST_FUNCTION_DECLARATION) {
+        resolver->function = expr;
+        return true;
+    }
+
+    if (expr->type != AST_CALL_EXPR || !expr->asCallExpr.receiver) return true;
+    CallExpr *call = &expr->asCallExpr;
+
+    // the receiver and arguments are resolved first so calls on the result of a call can be typed
+    walkExpr(call->receiver, methodCallVisitor, resolver);
+    for (int i = 0; i < call->argCount; i++) {
+        walkExpr(call->arguments[i], methodCallVisitor, resolver);
+    }
+
+    resolveMethodCall(resolver, call);
+
+    return false;
+}
+
+// wraps a pointer to a struct given where 'target' is expected in a conversion, when 'target' is an interface
+static void convertToInterface(MethodResolver *resolver, TypeExpr target, AstExpr **value) {
+    if (!target.name || target.ptrDepth || target.arrayLength || target.isSlice) return;
+
+    StructDeclaration *interface = lookupStruct(*resolver->ast, target.name);
+    if (!interface || !interface->isInterface) return;
+
+    // left for the C compiler to check when it cannot be known here
+    TypeExpr type;
+    if (!findValueType(resolver, *value, &type)) return;
+    if (isSameType(type, target)) return;
+
+    StructDeclaration *implementor = lookupStruct(*resolver->ast, type.name);
+    if (type.ptrDepth != 1 || type.arrayLength || type.isSlice || !implementor || !implementsInterface(implementor, interface->name)) {
+        raiseNotImplemented(resolver->analyzer, interface->name);
+        return;
+    }
+
+    AstExpr **arguments = malloc(sizeof(AstExpr *));
+    arguments[0] = *value;
+
+    char *name = conversionName(interface->name, implementor->name);
+    *value = newCallExpr(name, 1, 1, arguments);
+    free(name);
+}
+
+// a field read through a pointer to a struct, 'self.r', loads through it
+static void dereferenceObject(MethodResolver *resolver, PropertyAccessExpr *property) {
+    TypeExpr type;
+    if (!findValueType(resolver, property->object, &type)) return;
+    if (type.ptrDepth != 1 || type.arrayLength || type.isSlice || !lookupStruct(*resolver->ast, type.name)) return;
+
+    property->object = newGroupingExpr(newUnaryExpr(property->object, OP_DEREF));
+}
+
+static bool conversionVisitor(AstExpr *expr, void *context) {
+    MethodResolver *resolver = context;
+
+    switch (expr->type) {
+        case AST_PROPERTY_ACCESS: {
+            dereferenceObject(resolver, &expr->asProperty);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            resolver->function = expr;
+            break;
+        }
+        case AST_LET: {
+            convertToInterface(resolver, expr->asLet.type, &expr->asLet.value);
+            break;
+        }
+        case AST_ASSIGN_EXPR: {
+            AssignmentExpr assign = expr->asAssign;
+            if (assign.target || assign.ptrDepth || !resolver->function) break;
+
+            TypeExpr type;
+            if (findLocalType(resolver->function, assign.name, &type)) convertToInterface(resolver, type, &expr->asAssign.value);
+            break;
+        }
+        case AST_RETURN: {
+            if (resolver->function && expr->asReturn.value) {
+                convertToInterface(resolver, resolver->function->asFunction.returnType, &expr->asReturn.value);
+            }
+            break;
+        }
+        case AST_CALL_EXPR: {
+            AstExpr *callee = findFunction(*resolver->ast, expr->asCallExpr.name);
+            if (!callee) break;
+
+            FunctionDeclaration function = callee->asFunction;
+            for (int i = 0; i < function.paramCount && i < expr->asCallExpr.argCount; i++) {
+                convertToInterface(resolver, function.parameters[i].type, &expr->asCallExpr.arguments[i]);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+// functions taking 'self' are emitted under the name of their struct, so structs implementing one interface do not collide
+static void renameMethods(Ast ast) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type != AST_STRUCT_DECLARATION) continue;
+
+        StructDeclaration declaration = ast.exprs[i]->asStruct;
+        if (declaration.isInterface) continue;
+
+        for (int j = 0; j < declaration.memberCount; j++) {
+            AstExpr *member = declaration.members[j];
+            if (member->type != AST_FUNCTION_DECLARATION || !isMethod(member->asFunction)) continue;
+
+            char *name = methodName(declaration.name, member->asFunction.name);
+            free(member->asFunction.name);
+            member->asFunction.name = name;
+        }
+    }
+}
+
+void resolveMethodCalls(Analyzer *analyzer) {
+    checkInterfaces(analyzer);
+    if (analyzer->hadErr) return;
+
+    MethodResolver resolver = { analyzer, &analyzer->parser->ast, NULL };
+    Ast ast = analyzer->parser->ast;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        resolver.function = NULL;
+        walkExpr(ast.exprs[i], methodCallVisitor, &resolver);
+    }
+
+    renameMethods(ast);
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        resolver.function = NULL;
+        walkExpr(ast.exprs[i], conversionVisitor, &resolver);
+    }
+}
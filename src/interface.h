@@ -0,0 +1,25 @@
+#ifndef interface_h
+#define interface_h
+
+#include "analyze.h"
+
+// the C name of function 'name' of a struct when it takes 'self', 'Circle__area'
+char *methodName(char *structName, char *name);
+
+// the function making an 'interface' out of a pointer to 'structName', 'Shape__from__Circle'
+char *conversionName(char *interface, char *structName);
+
+// whether 'declaration' names 'interface' after 'with'
+bool implementsInterface(StructDeclaration *declaration, char *interface);
+
+// the only struct implementing 'interface', or null when there are none or several
+StructDeclaration *soleImplementor(Ast ast, char *interface);
+
+// checks that structs implement the interfaces they name and rewrites 'value.name(...)' into plain calls
+//
+// a call on a struct, or a pointer to one, calls its function directly with the value as 'self'
+// a call on an interface goes through its vtable, unless one struct implements it and it can be called directly
+// a pointer to a struct given where an interface is expected is converted to one
+void resolveMethodCalls(Analyzer *analyzer);
+
+#endif
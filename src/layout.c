@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "layout.h"
+#include "simd.h"
+#include "atomic.h"
+
+#define strEq(a, b) strcmp(a, b) == 0
+
+// by value structs cannot contain themselves, this only stops malformed programs recursing forever
+#define MAX_LAYOUT_DEPTH 64
+
+static StructLayout layoutStructAtDepth(Ast ast, StructDeclaration declaration, int depth);
+
+static TypeLayout primitiveLayout(char *name) {
+    if (strEq(name, "u0")) return (TypeLayout){ 0, 1, true };
+    if (strEq(name, "bool") || strEq(name, "i8") || strEq(name, "u8")) return (TypeLayout){ 1, 1, true };
+    if (strEq(name, "i16") || strEq(name, "u16")) return (TypeLayout){ 2, 2, true };
+    if (strEq(name, "i32") || strEq(name, "u32") || strEq(name, "f32")) return (TypeLayout){ 4, 4, true };
+    if (strEq(name, "i64") || strEq(name, "u64") || strEq(name, "f64")) return (TypeLayout){ 8, 8, true };
+    if (strEq(name, "size") || strEq(name, "rawptr")) return (TypeLayout){ 8, 8, true };
+
+    return (TypeLayout){ 0, 0, false };
+}
+
+static TypeLayout layoutOfTypeAtDepth(Ast ast, TypeExpr type, int depth) {
+    if (type.ptrDepth || type.isSlice) {
+        TypeLayout pointer = { 8, 8, true };
+        if (type.isSlice) pointer.size = 16;
+
+        return pointer;
+    }
+
+    TypeLayout layout = primitiveLayout(type.name);
+
+    VectorType vector;
+    if (!layout.isKnown && lookupVectorType(type.name, &vector)) {
+        int size = vector.lanes * vector.elementSize;
+        layout = (TypeLayout){ size, size, true };
+    }
+
+    // the atomics that are supported are lock free, so they are laid out as the type they hold
+    TypeExpr element;
+    if (!layout.isKnown && lookupAtomicType(type.name, &element)) {
+        layout = layoutOfTypeAtDepth(ast, element, depth);
+        free(element.name);
+    }
+
+    for (int i = 0; !layout.isKnown && i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        // enumerators are emitted as plain ints
+        if (expr->type == AST_ENUM && strEq(expr->asEnum.name, type.name)) {
+            layout = (TypeLayout){ 4, 4, true };
+        }
+
+        if (expr->type == AST_STRUCT_DECLARATION && strEq(expr->asStruct.name, type.name) && depth < MAX_LAYOUT_DEPTH) {
+            StructLayout structLayout = layoutStructAtDepth(ast, expr->asStruct, depth + 1);
+            layout = (TypeLayout){ structLayout.size, structLayout.alignment, structLayout.isKnown };
+
+            freeStructLayout(structLayout);
+            break;
+        }
+    }
+
+    // assume the worst alignment for C types so they are still sorted ahead of smaller fields
+    if (!layout.isKnown) layout = (TypeLayout){ 8, 8, false };
+
+    if (type.arrayLength) layout.size *= type.arrayLength;
+
+    return layout;
+}
+
+TypeLayout layoutOfType(Ast ast, TypeExpr type) {
+    return layoutOfTypeAtDepth(ast, type, 0);
+}
+
+static int alignUp(int offset, int alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static int max(int a, int b) {
+    return a > b ? a : b;
+}
+
+// a stable sort, so fields with the same alignment keep their declared order
+static void sortByAlignment(FieldLayout *fields, int count) {
+    for (int i = 1; i < count; i++) {
+        FieldLayout field = fields[i];
+
+        int j = i - 1;
+        while (j >= 0 && fields[j].alignment < field.alignment) {
+            fields[j + 1] = fields[j];
+            j--;
+        }
+        fields[j + 1] = field;
+    }
+}
+
+static StructLayout layoutStructAtDepth(Ast ast, StructDeclaration declaration, int depth) {
+    bool isPacked = hasTag(declaration.tags, TAG_PACKED);
+    bool canReorder = !declaration.isPublic && !hasTag(declaration.tags, TAG_REPR_C | TAG_PACKED);
+
+    StructLayout layout = {
+        .fields = malloc(sizeof(FieldLayout) * (declaration.memberCount + 1)),
+        .fieldCount = 0,
+        .size = 0,
+        .alignment = 1,
+        .padding = 0,
+        .isReordered = false,
+        .isKnown = true,
+    };
+
+    for (int i = 0; i < declaration.memberCount; i++) {
+        if (declaration.members[i]->type != AST_STRUCT_FIELD) continue;
+        StructField *field = &declaration.members[i]->asStructField;
+
+        TypeLayout type = layoutOfTypeAtDepth(ast, field->type, depth);
+        if (!type.isKnown) layout.isKnown = false;
+
+        int explicitAlignment = field->alignment;
+        if (hasTag(field->tags, TAG_CACHELINE)) explicitAlignment = max(explicitAlignment, CACHE_LINE_SIZE);
+
+        int alignment = isPacked ? 1 : type.alignment;
+
+        layout.fields[layout.fieldCount] = (FieldLayout){
+            .field = field,
+            .declaredIndex = layout.fieldCount,
+            .offset = 0,
+            .size = type.size,
+            .alignment = max(alignment, explicitAlignment),
+            .explicitAlignment = explicitAlignment,
+        };
+        layout.fieldCount++;
+    }
+
+    if (canReorder) sortByAlignment(layout.fields, layout.fieldCount);
+
+    for (int i = 0; i < layout.fieldCount; i++) {
+        if (layout.fields[i].declaredIndex != i) layout.isReordered = true;
+    }
+
+    // the field after a '@cacheline' field starts a new line, so the two never share one
+    for (int i = 1; i < layout.fieldCount; i++) {
+        if (!hasTag(layout.fields[i - 1].field->tags, TAG_CACHELINE)) continue;
+
+        layout.fields[i].explicitAlignment = max(layout.fields[i].explicitAlignment, CACHE_LINE_SIZE);
+        layout.fields[i].alignment = max(layout.fields[i].alignment, CACHE_LINE_SIZE);
+    }
+
+    int offset = 0;
+    for (int i = 0; i < layout.fieldCount; i++) {
+        FieldLayout *field = &layout.fields[i];
+
+        int aligned = alignUp(offset, field->alignment);
+        layout.padding += aligned - offset;
+
+        field->offset = aligned;
+        offset = aligned + field->size;
+
+        layout.alignment = max(layout.alignment, field->alignment);
+    }
+
+    // an empty struct is given a placeholder byte
+    if (layout.fieldCount == 0) offset = 1;
+
+    layout.alignment = max(layout.alignment, declaration.alignment);
+    if (hasTag(declaration.tags, TAG_CACHELINE)) layout.alignment = max(layout.alignment, CACHE_LINE_SIZE);
+
+    layout.size = alignUp(offset, layout.alignment);
+    layout.padding += layout.size - offset;
+
+    return layout;
+}
+
+StructLayout layoutStruct(Ast ast, StructDeclaration declaration) {
+    return layoutStructAtDepth(ast, declaration, 0);
+}
+
+void freeStructLayout(StructLayout layout) {
+    free(layout.fields);
+}
+
+StructDeclaration *lookupStruct(Ast ast, char *name) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+        if (expr->type == AST_STRUCT_DECLARATION && strEq(expr->asStruct.name, name)) return &expr->asStruct;
+    }
+
+    return NULL;
+}
+
+bool isSoaType(Ast ast, TypeExpr type) {
+    if (!type.name || type.ptrDepth || (!type.arrayLength && !type.isSlice)) return false;
+
+    StructDeclaration *declaration = lookupStruct(ast, type.name);
+    return declaration && hasTag(declaration->tags, TAG_SOA);
+}
@@ -0,0 +1,62 @@
+#ifndef layout_h
+#define layout_h
+
+#include "parse.h"
+
+// the size of a cache line on the targets we care about, used by '@cacheline'
+#define CACHE_LINE_SIZE 64
+
+typedef struct {
+    int  size;
+    int  alignment;
+
+    // false for types only C knows about, such as those brought in by 'embed'
+    bool isKnown;
+} TypeLayout;
+
+typedef struct {
+    StructField *field;
+    int          declaredIndex;
+
+    int          offset;
+    int          size;
+    int          alignment;
+
+    // emitted with '_Alignas', either '@align(N)' or the start of a '@cacheline' line
+    int          explicitAlignment;
+} FieldLayout;
+
+typedef struct {
+    // the fields in the order they are emitted
+    FieldLayout *fields;
+    int          fieldCount;
+
+    int          size;
+    int          alignment;
+
+    // bytes lost between and after fields
+    int          padding;
+
+    // whether the fields were moved from the order they are declared in
+    bool         isReordered;
+    bool         isKnown;
+} StructLayout;
+
+// sizes and alignments follow the x86-64 and aarch64 ABIs
+TypeLayout layoutOfType(Ast ast, TypeExpr type);
+
+// orders the fields of a struct as the transpiler emits them and works out where each one lands
+//
+// fields of structs which are not 'pub', '@repr(C)' or '@packed' are sorted by descending
+// alignment, which leaves the least padding between them
+StructLayout layoutStruct(Ast ast, StructDeclaration declaration);
+
+void freeStructLayout(StructLayout layout);
+
+// the struct called 'name', or null when there is none
+StructDeclaration *lookupStruct(Ast ast, char *name);
+
+// whether 'type' is a fixed array or slice of an '@soa' struct, which is stored as one array per field
+bool isSoaType(Ast ast, TypeExpr type);
+
+#endif
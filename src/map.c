@@ -4,6 +4,8 @@
 
 #include "map.h"
 #include "err.h"
+#include "atomic.h"
+#include "pool.h"
 
 #define strEq(a, b) strcmp(a, b) == 0
 
@@ -28,6 +30,26 @@ char *mapPrimitiveTypeToC(char *type) {
 
     else if (strEq(type, "size")) return "size_t";
 
+    TypeExpr element;
+    if (lookupAtomicType(type, &element)) {
+        char *elementType = mapPrimitiveTypeToC(element.name);
+
+        char *atomic = malloc(strlen("_Atomic()") + strlen(elementType) + element.ptrDepth + 1);
+        strcpy(atomic, "_Atomic(");
+        strcat(atomic, elementType);
+        for (int i = 0; i < element.ptrDepth; i++) strcat(atomic, "*");
+        strcat(atomic, ")");
+
+        free(element.name);
+        return atomic;
+    }
+
+    // a typed pool is the same pool, only the slots it hands out are checked
+    if (lookupPoolType(type, &element)) {
+        free(element.name);
+        return "Pool";
+    }
+
     return type;
 }
 
@@ -12,6 +12,9 @@ static AstExpr *parseExpr(Parser *p);
 static AstExpr *parseCallExpression(Parser *p);
 static AstExpr *parseMatch(Parser *p);
 static AstExpr *parseStructField(Parser *p);
+static AstExpr *parseRange(Parser *p, AstExpr *start);
+static AstExpr *parseType(Parser *p);
+static uint32_t mapTagName(char *name);
 
 static AstExpr *error(Parser *p, char *err) {
     compileErrFromParse(p, err);
@@ -40,12 +43,15 @@ Parser newParser(char *filePath, Token *tokens, int tokenCount, bool debug) {
     p.hadErr = false;
     p.debug = debug;
 
-    p.isInlineTagState = false;
+    p.tagState = 0;
+    p.unrollCount = 0;
+    p.alignment = 0;
+    p.isParsingInterface = false;
 
     return p;
 }
 
-static void freeExpr(AstExpr *expr) {
+void freeExpr(AstExpr *expr) {
     if (!expr) return;
 
     switch (expr->type) {
@@ -55,6 +61,9 @@ static void freeExpr(AstExpr *expr) {
         case AST_STOP: {
             break;
         }
+        case AST_SYNC: {
+            break;
+        }
         case AST_INTEGER_LITERAL: {
             break;
         }
@@ -83,6 +92,16 @@ static void freeExpr(AstExpr *expr) {
             free(expr->asEmbed.embedSource);
             break;
         }
+        case AST_INLINED_CALL: {
+            for (int i = 0; i < expr->asInlinedCall.tempCount; i++) {
+                freeExpr(expr->asInlinedCall.temps[i]);
+            }
+            free(expr->asInlinedCall.temps);
+            free(expr->asInlinedCall.name);
+            freeType(expr->asInlinedCall.returnType);
+            freeExpr(expr->asInlinedCall.body);
+            break;
+        }
         case AST_TERNARY: {
             freeExpr(expr->asTernary.condition);
             freeExpr(expr->asTernary.trueExpr);
@@ -90,7 +109,7 @@ static void freeExpr(AstExpr *expr) {
             break;
         }
         case AST_STRUCT_FIELD: {
-            free(expr->asStructField.type.name);
+            freeType(expr->asStructField.type);
             free(expr->asStructField.name);
             break;
         }
@@ -99,6 +118,13 @@ static void freeExpr(AstExpr *expr) {
                 freeExpr(expr->asCallExpr.arguments[i]);
             }
             free(expr->asCallExpr.name);
+
+            for (int i = 0; i < expr->asCallExpr.typeArgumentCount; i++) {
+                freeType(expr->asCallExpr.typeArguments[i]);
+            }
+            free(expr->asCallExpr.typeArguments);
+
+            freeExpr(expr->asCallExpr.receiver);
             break;
         }
         case AST_STRUCT_INITIALIZER: {
@@ -136,12 +162,13 @@ static void freeExpr(AstExpr *expr) {
             break;
         }
         case AST_TYPE_EXPR: {
-            free(expr->asType.name);
+            freeType(expr->asType);
             break;
         }
         case AST_ASSIGN_EXPR: {
             free(expr->asAssign.name);    
             freeExpr(expr->asAssign.value);
+            freeExpr(expr->asAssign.target);
             break;
         }
         case AST_UNARY: {
@@ -155,11 +182,19 @@ static void freeExpr(AstExpr *expr) {
         }
         case AST_MATCH: {
             freeExpr(expr->asMatch.expression);
+            free(expr->asMatch.enumName);
+            break;
+        }
+        case AST_BLOCK: {
+            for (int i = 0; i < expr->asBlock.count; i++) {
+                freeExpr(expr->asBlock.body[i]);
+            }
+            free(expr->asBlock.body);
             break;
         }
         case AST_FUNCTION_DECLARATION: {
             free(expr->asFunction.name);
-            free(expr->asFunction.returnType.name);
+            freeType(expr->asFunction.returnType);
 
             if (!expr->asFunction.isLambda) {
                 for (int i = 0; i < expr->asFunction.block.count; i++) {
@@ -172,9 +207,14 @@ static void freeExpr(AstExpr *expr) {
 
             for (int i = 0; i < expr->asFunction.paramCount; i++) {
                 free(expr->asFunction.parameters[i].name);
-                free(expr->asFunction.parameters[i].type.name);
+                freeType(expr->asFunction.parameters[i].type);
             }
             free(expr->asFunction.parameters);
+
+            for (int i = 0; i < expr->asFunction.typeParameterCount; i++) {
+                free(expr->asFunction.typeParameters[i]);
+            }
+            free(expr->asFunction.typeParameters);
             break;
         }
         case AST_STRUCT_DECLARATION: {
@@ -182,6 +222,16 @@ static void freeExpr(AstExpr *expr) {
             for (int i = 0; i < expr->asStruct.memberCount; i++) {
                 freeExpr(expr->asStruct.members[i]);
             }
+
+            for (int i = 0; i < expr->asStruct.typeParameterCount; i++) {
+                free(expr->asStruct.typeParameters[i]);
+            }
+            free(expr->asStruct.typeParameters);
+
+            for (int i = 0; i < expr->asStruct.interfaceCount; i++) {
+                free(expr->asStruct.interfaces[i]);
+            }
+            free(expr->asStruct.interfaces);
             break;
         }
         case AST_RETURN: {
@@ -202,13 +252,39 @@ static void freeExpr(AstExpr *expr) {
             }
             break;
         }
+        case AST_INDEX: {
+            freeExpr(expr->asIndex.object);
+            freeExpr(expr->asIndex.index);
+            freeType(expr->asIndex.objectType);
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            for (int i = 0; i < expr->asArray.elementCount; i++) {
+                freeExpr(expr->asArray.elements[i]);
+            }
+            free(expr->asArray.elements);
+            freeType(expr->asArray.type);
+            break;
+        }
+        case AST_RANGE: {
+            freeExpr(expr->asRange.start);
+            freeExpr(expr->asRange.end);
+            freeExpr(expr->asRange.step);
+            break;
+        }
         case AST_FOR: {
             freeExpr(expr->asFor.iterator);
             free(expr->asFor.variable);
+            freeType(expr->asFor.type);
             
             for (int i = 0; i < expr->asFor.block.count; i++) {
                 freeExpr(expr->asFor.block.body[i]);
             }
+
+            for (int i = 0; i < expr->asFor.reductionCount; i++) {
+                free(expr->asFor.reductions[i].name);
+            }
+            free(expr->asFor.reductions);
             break;
         }
         default: {
@@ -275,6 +351,17 @@ static void printExpr(AstExpr expr, int indent) {
             printf("stop statement\n");
             break;
         }
+        case AST_SYNC: {
+            printf("sync statement\n");
+            break;
+        }
+        case AST_BLOCK: {
+            printf("block (%d):\n", expr.asBlock.count);
+            for (int i = 0; i < expr.asBlock.count; i++) {
+                printExpr(*expr.asBlock.body[i], indent + 2);
+            }
+            break;
+        }
         case AST_GROUPING: {
             printf("group expression\n");
 
@@ -511,6 +598,11 @@ static void printExpr(AstExpr expr, int indent) {
             printf("iterator:\n");
             printExpr(*expr.asFor.iterator, indent + 4);
 
+            if (expr.asFor.unrollCount) {
+                printIndent(indent + 2);
+                printf("unroll: %d\n", expr.asFor.unrollCount);
+            }
+
             printIndent(indent + 2);
             printf("body (%d):\n", expr.asFor.block.count);
             for (int i = 0; i < expr.asFor.block.count; i++) {
@@ -574,6 +666,44 @@ static void printExpr(AstExpr expr, int indent) {
             printExpr(*expr.asTernary.falseExpr, indent + 4);
             break;
         }
+        case AST_INDEX: {
+            printf("index expression:\n");
+
+            printIndent(indent + 2);
+            printf("object:\n");
+            printExpr(*expr.asIndex.object, indent + 4);
+
+            printIndent(indent + 2);
+            printf("index:\n");
+            printExpr(*expr.asIndex.index, indent + 4);
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            printf("array literal (%d):\n", expr.asArray.elementCount);
+
+            for (int i = 0; i < expr.asArray.elementCount; i++) {
+                printExpr(*expr.asArray.elements[i], indent + 4);
+            }
+            break;
+        }
+        case AST_RANGE: {
+            printf("range expression (%s):\n", expr.asRange.isInclusive ? "inclusive" : "exclusive");
+
+            printIndent(indent + 2);
+            printf("start:\n");
+            printExpr(*expr.asRange.start, indent + 4);
+
+            printIndent(indent + 2);
+            printf("end:\n");
+            printExpr(*expr.asRange.end, indent + 4);
+
+            if (expr.asRange.step) {
+                printIndent(indent + 2);
+                printf("step:\n");
+                printExpr(*expr.asRange.step, indent + 4);
+            }
+            break;
+        }
         default: {
             exitWithInternalCompilerError("unknown ast expression type in 'printExpr'");
         }
@@ -623,6 +753,51 @@ static inline bool isEnd(Parser *p) {
     return false;
 }
 
+static inline Token peekToken(Parser *p) {
+    if (p->position + 1 >= p->tokenCount) return currentToken(p);
+    return p->tokens[p->position + 1];
+}
+
+static inline uint32_t takeTags(Parser *p) {
+    uint32_t tags = p->tagState;
+    p->tagState = 0;
+
+    return tags;
+}
+
+static AstExpr *parseArrayLiteral(Parser *p) {
+    int elementCount = 0;
+    int elementCapacity = 1;
+    AstExpr **elements = malloc(sizeof(AstExpr *));
+    if (!elements) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    if (match(p, TOKEN_RIGHT_BRACKET)) {
+        return error(p, "array literal cannot be empty");
+    }
+
+    while (true) {
+        AstExpr *element = parseExpr(p);
+        if (isErr(element)) return element;
+
+        if (elementCount >= elementCapacity) {
+            elementCapacity *= 2;
+            elements = realloc(elements, sizeof(AstExpr *) * elementCapacity);
+        }
+        elements[elementCount++] = element;
+
+        if (!match(p, TOKEN_COMMA)) break;
+        advance(p);
+    }
+
+    if (!expect(p, TOKEN_RIGHT_BRACKET)) {
+        return error(p, "expected ']' after array elements");
+    }
+
+    return newArrayLiteral(elements, elementCount, elementCapacity);
+}
+
 static AstExpr *parseStructFieldInit(Parser *p) {
     int fieldCount = 0;
     int fieldCapacity = 1;
@@ -669,6 +844,113 @@ static AstExpr *parseStructFieldInit(Parser *p) {
     return newStructInitializer(fields, fieldCount, fieldCapacity);
 }
 
+// whether the '<' at the current token opens the type arguments of a call, as in 'max<i32>(a, b)'
+// rather than being a comparison, the list must be made only of types and be followed by '('
+static bool isCallTypeArguments(Parser *p) {
+    int depth = 0;
+
+    for (int i = p->position; i < p->tokenCount; i++) {
+        switch (p->tokens[i].type) {
+            case TOKEN_LESS_THAN: {
+                depth++;
+                break;
+            }
+            case TOKEN_GREATER_THAN: {
+                depth--;
+                break;
+            }
+            case TOKEN_SHIFT_RIGHT: {
+                depth -= 2;
+                break;
+            }
+            case TOKEN_IDENTIFIER:
+            case TOKEN_STAR:
+            case TOKEN_LEFT_BRACKET:
+            case TOKEN_RIGHT_BRACKET:
+            case TOKEN_INTEGER:
+            case TOKEN_COMMA: {
+                break;
+            }
+            default: {
+                return false;
+            }
+        }
+
+        if (depth == 0) return i + 1 < p->tokenCount && p->tokens[i + 1].type == TOKEN_LEFT_PAREN;
+        if (depth < 0) return false;
+    }
+
+    return false;
+}
+
+// parses '<T, U>' into 'arguments', returning an error expression or null
+static AstExpr *parseTypeArguments(Parser *p, TypeExpr **arguments, int *argumentCount) {
+    advance(p);
+
+    int count = 0;
+    int capacity = 1;
+    TypeExpr *types = malloc(sizeof(TypeExpr));
+
+    do {
+        if (count > 0) advance(p);
+
+        AstExpr *type = parseType(p);
+        if (isErr(type)) return type;
+
+        if (count >= capacity) {
+            capacity *= 2;
+            types = realloc(types, sizeof(TypeExpr) * capacity);
+        }
+        types[count++] = type->asType;
+        free(type);
+    } while (match(p, TOKEN_COMMA));
+
+    // the '>>' closing 'Vec<Vec<i32>>' is split, leaving one '>' for the outer list
+    if (match(p, TOKEN_SHIFT_RIGHT)) {
+        p->tokens[p->position].type = TOKEN_GREATER_THAN;
+    } else if (!expect(p, TOKEN_GREATER_THAN)) {
+        return error(p, "expected '>' after type arguments");
+    }
+
+    *arguments = types;
+    *argumentCount = count;
+
+    return NULL;
+}
+
+// parses '<T, U>' after the name of a generic function or struct
+static AstExpr *parseTypeParameters(Parser *p, char ***parameters, int *parameterCount) {
+    if (!match(p, TOKEN_LESS_THAN)) return NULL;
+
+    int count = 0;
+    int capacity = 1;
+    char **names = malloc(sizeof(char *));
+
+    do {
+        advance(p);
+
+        Token name = currentToken(p);
+        if (!expect(p, TOKEN_IDENTIFIER)) {
+            return error(p, "expected a type parameter name");
+        }
+
+        if (count >= capacity) {
+            capacity *= 2;
+            names = realloc(names, sizeof(char *) * capacity);
+        }
+        names[count++] = strdup(name.lexeme);
+    } while (match(p, TOKEN_COMMA));
+
+    if (!expect(p, TOKEN_GREATER_THAN)) {
+        return error(p, "expected '>' after type parameters");
+    }
+
+    *parameters = names;
+    *parameterCount = count;
+
+    return NULL;
+}
+
 static AstExpr *parsePrimary(Parser *p) {
     Token token = currentToken(p);
     advance(p);
@@ -691,8 +973,19 @@ static AstExpr *parsePrimary(Parser *p) {
         case TOKEN_FLOAT: {
             return newFloatExpr(atof(token.lexeme));
         }
+        case TOKEN_SPAWN: {
+            AstExpr *call = parsePrimary(p);
+            if (isErr(call)) return call;
+
+            if (call->type != AST_CALL_EXPR) {
+                return error(p, "expected a function call after 'spawn'");
+            }
+
+            call->asCallExpr.isSpawned = true;
+            return call;
+        }
         case TOKEN_IDENTIFIER: {
-            if (match(p, TOKEN_LEFT_PAREN)) {
+            if (match(p, TOKEN_LEFT_PAREN) || (match(p, TOKEN_LESS_THAN) && isCallTypeArguments(p))) {
                 recede(p);
 
                 return parseCallExpression(p);
@@ -715,6 +1008,9 @@ static AstExpr *parsePrimary(Parser *p) {
         case TOKEN_LEFT_BRACE: {
             return parseStructFieldInit(p);
         }
+        case TOKEN_LEFT_BRACKET: {
+            return parseArrayLiteral(p);
+        }
         default: {
             compileErrFromParse(p, "expected expression");
             return newErrExpr();
@@ -736,7 +1032,35 @@ static AstExpr *parsePostfix(Parser *p) {
             char *property = currentToken(p).lexeme;
             advance(p);
 
+            // 'object.name(...)' calls a function of the object's struct
+            if (match(p, TOKEN_LEFT_PAREN)) {
+                recede(p);
+
+                AstExpr *call = parseCallExpression(p);
+                if (isErr(call)) return call;
+
+                call->asCallExpr.receiver = expr;
+                expr = call;
+                continue;
+            }
+
             expr = newPropertyAccessExpr(expr, property);
+        } else if (match(p, TOKEN_LEFT_BRACKET)) {
+            advance(p);
+
+            AstExpr *index = parseExpr(p);
+            if (isErr(index)) return index;
+
+            if (match(p, TOKEN_DOT_DOT) || match(p, TOKEN_DOT_DOT_EQUALS)) {
+                index = parseRange(p, index);
+                if (isErr(index)) return index;
+            }
+
+            if (!expect(p, TOKEN_RIGHT_BRACKET)) {
+                return error(p, "expected ']' after index");
+            }
+
+            expr = newIndexExpr(expr, index);
         } else {
             break;
         }
@@ -977,6 +1301,36 @@ static AstExpr *parseExpr(Parser *p) {
 }
 
 static AstExpr *parseType(Parser *p) {
+    int arrayLength = 0;
+    bool isSlice = false;
+
+    if (match(p, TOKEN_LEFT_BRACKET)) {
+        advance(p);
+
+        if (match(p, TOKEN_RIGHT_BRACKET)) {
+            isSlice = true;
+        } else {
+            Token length = currentToken(p);
+            if (!expect(p, TOKEN_INTEGER)) {
+                return error(p, "expected an array length or ']'");
+            }
+
+            long long value = strtoll(length.lexeme, NULL, 10);
+            if (value <= 0 || value > INT32_MAX) {
+                return error(p, "array length must be a positive integer");
+            }
+            arrayLength = (int)value;
+        }
+
+        if (!expect(p, TOKEN_RIGHT_BRACKET)) {
+            return error(p, "expected ']'");
+        }
+
+        if (match(p, TOKEN_LEFT_BRACKET)) {
+            return error(p, "arrays of arrays are not supported");
+        }
+    }
+
     uint8_t ptrDepth = 0;
     while (match(p, TOKEN_STAR)) {
         advance(p);
@@ -992,7 +1346,16 @@ static AstExpr *parseType(Parser *p) {
         return error(p, "expected type specifier");
     }
 
-    return newTypeExpr(name.lexeme, ptrDepth);
+    AstExpr *type = newTypeExpr(name.lexeme, ptrDepth);
+    type->asType.arrayLength = arrayLength;
+    type->asType.isSlice = isSlice;
+
+    if (match(p, TOKEN_LESS_THAN)) {
+        AstExpr *err = parseTypeArguments(p, &type->asType.typeArguments, &type->asType.typeArgumentCount);
+        if (err) return err;
+    }
+
+    return type;
 }
 
 static AstExpr *parseLet(Parser *p) {
@@ -1084,6 +1447,11 @@ static AstExpr *parseBlock(Parser *p) {
 }
 
 static AstExpr *parseFunction(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~FUNCTION_TAGS) {
+        return error(p, "tag cannot be applied to a function declaration");
+    }
+
     bool isPublic = false;
 
     if (match(p, TOKEN_PUB)) {
@@ -1091,6 +1459,11 @@ static AstExpr *parseFunction(Parser *p) {
         advance(p);
     }
 
+    if (match(p, TOKEN_CONST)) {
+        tags |= TAG_COMPTIME;
+        advance(p);
+    }
+
     advance(p);
 
     Token name = currentToken(p);
@@ -1098,6 +1471,12 @@ static AstExpr *parseFunction(Parser *p) {
         return error(p, "expected identifier after 'fn'");
     }
 
+    char **typeParameters = NULL;
+    int typeParameterCount = 0;
+
+    AstExpr *typeParametersErr = parseTypeParameters(p, &typeParameters, &typeParameterCount);
+    if (typeParametersErr) return typeParametersErr;
+
     FunctionParameter *parameters = malloc(sizeof(FunctionParameter));
     if (!parameters) {
         exitWithInternalCompilerError("memory allocation failed");
@@ -1118,6 +1497,26 @@ static AstExpr *parseFunction(Parser *p) {
             do {
                 advance(p);
 
+                // tags on a parameter come before its name, '@noalias dst: *u8'
+                uint32_t parameterTags = 0;
+                while (match(p, TOKEN_AT)) {
+                    advance(p);
+
+                    uint32_t tag = mapTagName(currentToken(p).lexeme);
+                    if (tag == 0) {
+                        return error(p, "unknown tag");
+                    }
+                    if (!hasTag(PARAM_TAGS, tag)) {
+                        return error(p, "tag cannot be applied to a parameter");
+                    }
+                    if (hasTag(parameterTags, tag)) {
+                        return error(p, "duplicate tag");
+                    }
+
+                    parameterTags |= tag;
+                    advance(p);
+                }
+
                 Token name = currentToken(p);
                 if (!expect(p, TOKEN_IDENTIFIER)) {
                     return error(p, "expected identifier");
@@ -1131,6 +1530,7 @@ static AstExpr *parseFunction(Parser *p) {
                 if (isErr(type)) return type;
 
                 AstExpr *parameter = newFunctionParameter(name.lexeme, type);
+                parameter->asParameter.tags = parameterTags;
 
                 if (paramCount >= paramCapacity) {
                     paramCapacity *= 2;
@@ -1165,12 +1565,14 @@ static AstExpr *parseFunction(Parser *p) {
         isLambda = true;
     }
 
-    if (!isLambda && !expect(p, TOKEN_LEFT_BRACE)) {
+    bool isSignature = p->isParsingInterface && !isLambda && !match(p, TOKEN_LEFT_BRACE);
+
+    if (!isLambda && !isSignature && !expect(p, TOKEN_LEFT_BRACE)) {
         return error(p, "expected '{'");
     }
 
     AstExpr *body = NULL;
-    if (!isLambda) {
+    if (!isLambda && !isSignature) {
         body = parseBlock(p);
         if (isErr(body)) return body;
 
@@ -1183,9 +1585,12 @@ static AstExpr *parseFunction(Parser *p) {
 
     AstExpr* functionDeclaration = newFunctionDeclaration(
         name.lexeme, returnType->asType, block, paramCount, paramCapacity, 
-        parameters, isLambda, lambdaExpr, isPublic, p->isInlineTagState
+        parameters, isLambda, lambdaExpr, isPublic, tags
     );
 
+    functionDeclaration->asFunction.typeParameters = typeParameters;
+    functionDeclaration->asFunction.typeParameterCount = typeParameterCount;
+
     free(returnType);
     if (body) free(body);
 
@@ -1207,6 +1612,13 @@ static AstExpr *parseReturn(Parser *p) {
 }
 
 static AstExpr *parseStruct(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~STRUCT_TAGS) {
+        return error(p, "tag cannot be applied to a struct");
+    }
+
+    int alignment = hasTag(tags, TAG_ALIGN) ? p->alignment : 0;
+
     bool isPublic = false;
     bool isInterface = false;
 
@@ -1226,10 +1638,42 @@ static AstExpr *parseStruct(Parser *p) {
         return error(p, "expected identifier after 'struct'");
     }
 
+    char **typeParameters = NULL;
+    int typeParameterCount = 0;
+
+    AstExpr *typeParametersErr = parseTypeParameters(p, &typeParameters, &typeParameterCount);
+    if (typeParametersErr) return typeParametersErr;
+
+    char **interfaces = NULL;
+    int interfaceCount = 0;
+    int interfaceCapacity = 1;
+
+    if (match(p, TOKEN_WITH)) {
+        interfaces = malloc(sizeof(char *));
+
+        do {
+            advance(p);
+
+            Token interface = currentToken(p);
+            if (!expect(p, TOKEN_IDENTIFIER)) {
+                return error(p, "expected an interface name after 'with'");
+            }
+
+            if (interfaceCount >= interfaceCapacity) {
+                interfaceCapacity *= 2;
+                interfaces = realloc(interfaces, sizeof(char *) * interfaceCapacity);
+            }
+            interfaces[interfaceCount++] = strdup(interface.lexeme);
+        } while (match(p, TOKEN_COMMA));
+    }
+
     if (!expect(p, TOKEN_LEFT_BRACE)) {
         return error(p, "expected '{'");
     }
 
+    bool wasParsingInterface = p->isParsingInterface;
+    p->isParsingInterface = isInterface;
+
     AstExpr **members = malloc(sizeof(AstExpr *));
     if (!members) {
         exitWithInternalCompilerError("memory allocation failed");
@@ -1277,11 +1721,19 @@ static AstExpr *parseStruct(Parser *p) {
         } while (!match(p, TOKEN_RIGHT_BRACE));
     }
 
+    p->isParsingInterface = wasParsingInterface;
+
     if (!expect(p, TOKEN_RIGHT_BRACE)) {
         return error(p, "expected '}'");
     }
 
-    return newStructDeclaration(name.lexeme, members, memberCount, memberCapacity, isInterface, isPublic);
+    AstExpr *structDeclaration = newStructDeclaration(name.lexeme, members, memberCount, memberCapacity, isInterface, isPublic, tags, alignment);
+    structDeclaration->asStruct.typeParameters = typeParameters;
+    structDeclaration->asStruct.typeParameterCount = typeParameterCount;
+    structDeclaration->asStruct.interfaces = interfaces;
+    structDeclaration->asStruct.interfaceCount = interfaceCount;
+
+    return structDeclaration;
 }
 
 static AstExpr *parseInterface(Parser *p) {
@@ -1309,7 +1761,22 @@ static AstExpr *parseStop(Parser *p) {
     return newStopStatement();
 }
 
+static AstExpr *parseSync(Parser *p) {
+    advance(p);
+
+    return newSyncStatement();
+}
+
 static AstExpr *parseWhile(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~(BRANCH_TAGS | TAG_DISPATCH | TAG_SIMD)) {
+        return error(p, "tag cannot be applied to a while statement");
+    }
+
+    if (hasTag(tags, TAG_LIKELY) && hasTag(tags, TAG_UNLIKELY)) {
+        return error(p, "a branch cannot be both '@likely' and '@unlikely'");
+    }
+
     advance(p);
 
     AstExpr *condition = parseExpr(p);
@@ -1334,13 +1801,21 @@ static AstExpr *parseWhile(Parser *p) {
         return error(p, "expected '}'");
     }
 
-    return newWhileStatement(condition, block, alteration);
+    return newWhileStatement(condition, block, alteration, tags);
 }
 
 static AstExpr *parseCallExpression(Parser *p) {
     Token name = currentToken(p);
     advance(p);
 
+    TypeExpr *typeArguments = NULL;
+    int typeArgumentCount = 0;
+
+    if (match(p, TOKEN_LESS_THAN)) {
+        AstExpr *err = parseTypeArguments(p, &typeArguments, &typeArgumentCount);
+        if (err) return err;
+    }
+
     if (!expect(p, TOKEN_LEFT_PAREN)) {
         return error(p, "expected '(' in call expression");
     }
@@ -1375,10 +1850,21 @@ static AstExpr *parseCallExpression(Parser *p) {
         return error(p, "expected '(' in call expression");
     }
 
-    return newCallExpr(name.lexeme, count, capacity, arguments);
+    AstExpr *call = newCallExpr(name.lexeme, count, capacity, arguments);
+    call->asCallExpr.typeArguments = typeArguments;
+    call->asCallExpr.typeArgumentCount = typeArgumentCount;
+
+    return call;
 }
 
 static AstExpr *parseStructField(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~FIELD_TAGS) {
+        return error(p, "tag cannot be applied to a struct field");
+    }
+
+    int alignment = hasTag(tags, TAG_ALIGN) ? p->alignment : 0;
+
     bool isPublic = false;
 
     if (match(p, TOKEN_PUB)) {
@@ -1402,13 +1888,41 @@ static AstExpr *parseStructField(Parser *p) {
         advance(p);
     }
 
-    return newStructField(name.lexeme, type, isPublic);
+    return newStructField(name.lexeme, type, isPublic, tags, alignment);
+}
+
+// 'name[index] = value' or 'name[index].field = value', or just an expression starting with 'name[index]'
+static AstExpr *parseElementAssignment(Parser *p) {
+    Token name = currentToken(p);
+
+    AstExpr *target = parseExpr(p);
+    if (isErr(target)) return target;
+
+    if (!match(p, TOKEN_SINGLE_EQUALS)) return target;
+    advance(p);
+
+    AstExpr *element = target->type == AST_PROPERTY_ACCESS ? target->asProperty.object : target;
+    if (element->type != AST_INDEX || element->asIndex.object->type != AST_IDENTIFIER) {
+        return error(p, "only an element of a named array or slice, or a field of one, can be assigned");
+    }
+
+    AstExpr *value = parseExpr(p);
+    if (isErr(value)) return value;
+
+    AstExpr *assign = newAssignExpr(name.lexeme, value, 0);
+    assign->asAssign.target = target;
+
+    return assign;
 }
 
 static AstExpr *parseIdentifier(Parser *p) {
     advance(p);
 
-    if (match(p, TOKEN_SINGLE_EQUALS)) {
+    if (match(p, TOKEN_LEFT_BRACKET)) {
+        recede(p);
+
+        return parseElementAssignment(p);
+    } else if (match(p, TOKEN_SINGLE_EQUALS)) {
         recede(p);
 
         return parseAssignment(p);
@@ -1481,7 +1995,7 @@ static AstExpr *parseEnum(Parser *p) {
 static AstExpr *parsePub(Parser *p) {
     advance(p);
 
-    if (match(p, TOKEN_FN)) {
+    if (match(p, TOKEN_FN) || (match(p, TOKEN_CONST) && peekToken(p).type == TOKEN_FN)) {
         recede(p);
 
         return parseFunction(p);
@@ -1502,7 +2016,38 @@ static AstExpr *parsePub(Parser *p) {
     return parseExpr(p);
 }
 
+static AstExpr *parseRange(Parser *p, AstExpr *start) {
+    bool isInclusive = match(p, TOKEN_DOT_DOT_EQUALS);
+    advance(p);
+
+    AstExpr *end = parseExpr(p);
+    if (isErr(end)) return end;
+
+    // 'step' is only a keyword here so it can still be used as a name elsewhere
+    AstExpr *step = NULL;
+    if (match(p, TOKEN_IDENTIFIER) && strcmp(currentToken(p).lexeme, "step") == 0) {
+        advance(p);
+
+        step = parseExpr(p);
+        if (isErr(step)) return step;
+    }
+
+    return newRangeExpr(start, end, step, isInclusive);
+}
+
 static AstExpr *parseFor(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~(TAG_UNROLL | TAG_SIMD | TAG_PARALLEL)) {
+        return error(p, "tag cannot be applied to a for statement");
+    }
+
+    // gcc only accepts one loop pragma before a for loop
+    if (hasTag(tags, TAG_UNROLL) && hasTag(tags, TAG_SIMD | TAG_PARALLEL)) {
+        return error(p, "'@unroll' cannot be combined with '@simd' or '@parallel'");
+    }
+
+    int unrollCount = hasTag(tags, TAG_UNROLL) ? p->unrollCount : 0;
+
     advance(p);
     
     Token name = currentToken(p);
@@ -1510,6 +2055,16 @@ static AstExpr *parseFor(Parser *p) {
         return error(p, "expected identifier after 'for'");
     }
 
+    TypeExpr type = { NULL, 0, 0, false, NULL, 0 };
+    if (match(p, TOKEN_COLON)) {
+        advance(p);
+
+        AstExpr *typeExpr = parseType(p);
+        if (isErr(typeExpr)) return typeExpr;
+
+        type = typeExpr->asType;
+    }
+
     if (!expect(p, TOKEN_IN)) {
         return error(p, "expected 'in' after for loop condition");
     }
@@ -1517,6 +2072,11 @@ static AstExpr *parseFor(Parser *p) {
     AstExpr *iterator = parseExpr(p);
     if (isErr(iterator)) return iterator;
 
+    if (match(p, TOKEN_DOT_DOT) || match(p, TOKEN_DOT_DOT_EQUALS)) {
+        iterator = parseRange(p, iterator);
+        if (isErr(iterator)) return iterator;
+    }
+
     if (!expect(p, TOKEN_LEFT_BRACE)) {
         return error(p, "expected '{'");
     }
@@ -1528,10 +2088,19 @@ static AstExpr *parseFor(Parser *p) {
         return error(p, "expected '}'");
     }
 
-    return newForStatement(name.lexeme, iterator, block->asBlock);
+    return newForStatement(name.lexeme, type, iterator, block->asBlock, tags, unrollCount);
 }
 
 static AstExpr *parseIf(Parser *p) {
+    uint32_t tags = takeTags(p);
+    if (tags & ~BRANCH_TAGS) {
+        return error(p, "tag cannot be applied to an if statement");
+    }
+
+    if (hasTag(tags, TAG_LIKELY) && hasTag(tags, TAG_UNLIKELY)) {
+        return error(p, "a branch cannot be both '@likely' and '@unlikely'");
+    }
+
     advance(p);
 
     AstExpr *condition = parseExpr(p);
@@ -1548,10 +2117,16 @@ static AstExpr *parseIf(Parser *p) {
         return error(p, "expected '}'");
     }
 
-    return newIfStatement(condition, block->asBlock);
+    return newIfStatement(condition, block->asBlock, tags);
 }
 
 static AstExpr *parseMatch(Parser *p) {
+    // only '@likely' is meaningful here, it marks the first case as the expected one
+    uint32_t tags = takeTags(p);
+    if (tags & ~TAG_LIKELY) {
+        return error(p, "tag cannot be applied to a match statement");
+    }
+
     advance(p);
 
     AstExpr *expression = parseExpr(p);
@@ -1630,7 +2205,81 @@ static AstExpr *parseMatch(Parser *p) {
         return error(p, "expected '}' or ',' on match case");
     }
 
-    return newMatchExpr(expression, cases, caseCount, caseCapacity);
+    return newMatchExpr(expression, cases, caseCount, caseCapacity, tags);
+}
+
+// 'with arena a { .. }' is a block starting with 'let a: Arena = arenaNew(0)' and 'defer arenaFree(&a)'
+// so the arena is released however the block is left, a chunk size can be given as 'with arena a(4096)'
+static AstExpr *parseWithArena(Parser *p) {
+    advance(p);
+
+    Token kind = currentToken(p);
+    if (!expect(p, TOKEN_IDENTIFIER) || strcmp(kind.lexeme, "arena") != 0) {
+        return error(p, "expected 'arena' after 'with'");
+    }
+
+    Token name = currentToken(p);
+    if (!expect(p, TOKEN_IDENTIFIER)) {
+        return error(p, "expected arena name");
+    }
+
+    AstExpr *chunkSize = NULL;
+    if (match(p, TOKEN_LEFT_PAREN)) {
+        advance(p);
+
+        chunkSize = parseExpr(p);
+        if (isErr(chunkSize)) return chunkSize;
+
+        if (!expect(p, TOKEN_RIGHT_PAREN)) {
+            return error(p, "expected ')'");
+        }
+    } else {
+        chunkSize = newIntegerExpr(0);
+    }
+
+    if (!expect(p, TOKEN_LEFT_BRACE)) {
+        return error(p, "expected '{'");
+    }
+
+    AstExpr *block = parseBlock(p);
+    if (isErr(block)) return block;
+
+    if (!expect(p, TOKEN_RIGHT_BRACE)) {
+        return error(p, "expected '}'");
+    }
+
+    AstExpr **newArguments = malloc(sizeof(AstExpr *));
+    AstExpr **freeArguments = malloc(sizeof(AstExpr *));
+    if (!newArguments || !freeArguments) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    newArguments[0] = chunkSize;
+    freeArguments[0] = newUnaryExpr(newIdentifierExpr(name.lexeme), OP_ADDRESS_OF);
+
+    AstExpr *declaration = newLetDeclaration(name.lexeme,
+        newTypeExpr("Arena", 0), newCallExpr("arenaNew", 1, 1, newArguments), false
+    );
+    AstExpr *release = newDeferStatement(newCallExpr("arenaFree", 1, 1, freeArguments));
+
+    BlockExpr body = block->asBlock;
+    int count = body.count + 2;
+
+    AstExpr **statements = malloc(sizeof(AstExpr *) * count);
+    if (!statements) {
+        exitWithInternalCompilerError("memory allocation failed");
+    }
+
+    statements[0] = declaration;
+    statements[1] = release;
+    for (int i = 0; i < body.count; i++) {
+        statements[i + 2] = body.body[i];
+    }
+
+    free(body.body);
+    free(block);
+
+    return newBlockExpr(statements, count, count);
 }
 
 static AstExpr *parseDefer(Parser *p) {
@@ -1642,19 +2291,108 @@ static AstExpr *parseDefer(Parser *p) {
     return newDeferStatement(statement);
 }
 
+static uint32_t mapTagName(char *name) {
+    if (strcmp("inline", name) == 0) return TAG_INLINE;
+    if (strcmp("noinline", name) == 0) return TAG_NOINLINE;
+    if (strcmp("hot", name) == 0) return TAG_HOT;
+    if (strcmp("cold", name) == 0) return TAG_COLD;
+    if (strcmp("pure", name) == 0) return TAG_PURE;
+    if (strcmp("likely", name) == 0) return TAG_LIKELY;
+    if (strcmp("unlikely", name) == 0) return TAG_UNLIKELY;
+    if (strcmp("comptime", name) == 0) return TAG_COMPTIME;
+    if (strcmp("dispatch", name) == 0) return TAG_DISPATCH;
+    if (strcmp("unroll", name) == 0) return TAG_UNROLL;
+    if (strcmp("simd", name) == 0) return TAG_SIMD;
+    if (strcmp("parallel", name) == 0) return TAG_PARALLEL;
+    if (strcmp("packed", name) == 0) return TAG_PACKED;
+    if (strcmp("align", name) == 0) return TAG_ALIGN;
+    if (strcmp("cacheline", name) == 0) return TAG_CACHELINE;
+    if (strcmp("repr", name) == 0) return TAG_REPR_C;
+    if (strcmp("soa", name) == 0) return TAG_SOA;
+    if (strcmp("noalias", name) == 0) return TAG_NOALIAS;
+
+    return 0;
+}
+
 static AstExpr *parseAt(Parser *p) {
     advance(p);
 
+    // 'const' is lexed as a keyword so it is matched by token type
     Token atToken = currentToken(p);
-    if (strcmp("inline", atToken.lexeme) == 0) {
-        advance(p);
-        p->isInlineTagState = true;
-    } else {
+    uint32_t tag = atToken.type == TOKEN_CONST ? TAG_CONST : mapTagName(atToken.lexeme);
+    
+    if (tag == 0) {
         return error(p, "unknown tag");
     }
+    advance(p);
+
+    if (hasTag(p->tagState, tag)) {
+        return error(p, "duplicate tag");
+    }
+    p->tagState |= tag;
+
+    if (tag == TAG_UNROLL) {
+        if (!expect(p, TOKEN_LEFT_PAREN)) {
+            return error(p, "expected '(' and then an unroll factor");
+        }
+
+        Token factor = currentToken(p);
+        if (!expect(p, TOKEN_INTEGER)) {
+            return error(p, "expected an integer unroll factor");
+        }
+
+        p->unrollCount = atoi(factor.lexeme);
+        if (p->unrollCount < 1 || p->unrollCount > 65535) {
+            return error(p, "unroll factor must be between 1 and 65535");
+        }
+
+        if (!expect(p, TOKEN_RIGHT_PAREN)) {
+            return error(p, "expected ')'");
+        }
+    }
+
+    if (tag == TAG_ALIGN) {
+        if (!expect(p, TOKEN_LEFT_PAREN)) {
+            return error(p, "expected '(' and then an alignment");
+        }
+
+        Token alignment = currentToken(p);
+        if (!expect(p, TOKEN_INTEGER)) {
+            return error(p, "expected an integer alignment");
+        }
+
+        p->alignment = atoi(alignment.lexeme);
+        if (p->alignment < 1 || p->alignment > 4096 || (p->alignment & (p->alignment - 1)) != 0) {
+            return error(p, "alignment must be a power of two no greater than 4096");
+        }
+
+        if (!expect(p, TOKEN_RIGHT_PAREN)) {
+            return error(p, "expected ')'");
+        }
+    }
+
+    // 'C' is the only representation there is
+    if (tag == TAG_REPR_C) {
+        if (!expect(p, TOKEN_LEFT_PAREN)) {
+            return error(p, "expected '(' and then a representation");
+        }
+
+        Token representation = currentToken(p);
+        if (!expect(p, TOKEN_IDENTIFIER) || strcmp(representation.lexeme, "C") != 0) {
+            return error(p, "expected 'C' representation");
+        }
+
+        if (!expect(p, TOKEN_RIGHT_PAREN)) {
+            return error(p, "expected ')'");
+        }
+    }
 
     AstExpr *expr = parseStatement(p);
-    p->isInlineTagState = false;
+    if (isErr(expr)) return expr;
+
+    if (takeTags(p) != 0) {
+        return error(p, "tag cannot be applied to this statement");
+    }
 
     return expr;
 }
@@ -1735,6 +2473,10 @@ static AstExpr *parseStatement(Parser *p) {
             return parseAt(p);
         }
         case TOKEN_CONST: {
+            if (peekToken(p).type == TOKEN_FN) {
+                return parseFunction(p);
+            }
+
             return parseLet(p);
         }
         case TOKEN_MATCH: {
@@ -1785,6 +2527,12 @@ static AstExpr *parseStatement(Parser *p) {
         case TOKEN_EMBED: {
             return parseEmbed(p);
         }
+        case TOKEN_WITH: {
+            return parseWithArena(p);
+        }
+        case TOKEN_SYNC: {
+            return parseSync(p);
+        }
         default: {
             return parseExpr(p);
         }
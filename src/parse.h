@@ -22,14 +22,22 @@ typedef struct {
     bool   hadErr;
     bool   debug;
 
-    // whether the following declaration expression has been preceeded by a '@inline'
-    // set back to false after the applying expression finishes parsing
-    bool   isInlineTagState;
+    // the tags (see 'TagType') preceeding the declaration or statement being parsed
+    // taken and cleared by the construct they apply to as soon as it starts parsing
+    uint32_t tagState;
+
+    // the factor given to '@unroll(N)' and the alignment given to '@align(N)', read along with the tags
+    int      unrollCount;
+    int      alignment;
+
+    // functions in an interface are only signatures, they have no body
+    bool     isParsingInterface;
 } Parser;
 
 Parser newParser(char *filePath, Token *tokens, int tokenCount, bool debug);
 void freeParser(Parser *parser);
 
 void parse(Parser *parser);
+void freeExpr(AstExpr *expr);
 
 #endif
\ No newline at end of file
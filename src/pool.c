@@ -0,0 +1,67 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+
+#define POOL_PREFIX "pool__"
+#define POINTER_SUFFIX "_ptr"
+
+typedef struct {
+    char *name;
+    int   argCount;
+} PoolBuiltinInfo;
+
+// indexed by 'PoolBuiltin'
+static PoolBuiltinInfo builtins[] = {
+    { "poolNew", 2 },
+    { "poolAlloc", 1 },
+    { "poolFree", 2 },
+    { "poolDestroy", 1 },
+};
+
+#define builtinCount (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+char *poolTypeName(TypeExpr element) {
+    size_t length = strlen(POOL_PREFIX) + strlen(element.name) + strlen(POINTER_SUFFIX) * element.ptrDepth + 1;
+
+    char *name = malloc(length);
+    strcpy(name, POOL_PREFIX);
+    strcat(name, element.name);
+    for (int i = 0; i < element.ptrDepth; i++) strcat(name, POINTER_SUFFIX);
+
+    return name;
+}
+
+bool lookupPoolType(char *name, TypeExpr *element) {
+    size_t prefixLength = strlen(POOL_PREFIX);
+    if (!name || strncmp(name, POOL_PREFIX, prefixLength) != 0) return false;
+
+    char *elementName = strdup(name + prefixLength);
+    size_t length = strlen(elementName);
+    size_t suffixLength = strlen(POINTER_SUFFIX);
+
+    uint8_t ptrDepth = 0;
+    while (length > suffixLength && strcmp(elementName + length - suffixLength, POINTER_SUFFIX) == 0) {
+        length -= suffixLength;
+        elementName[length] = '\0';
+        ptrDepth++;
+    }
+
+    *element = (TypeExpr){ .name = elementName, .ptrDepth = ptrDepth };
+    return true;
+}
+
+bool lookupPoolBuiltin(char *name, PoolBuiltin *builtin) {
+    for (int i = 0; i < builtinCount; i++) {
+        if (strcmp(name, builtins[i].name) != 0) continue;
+
+        *builtin = (PoolBuiltin)i;
+        return true;
+    }
+
+    return false;
+}
+
+int poolBuiltinArgCount(PoolBuiltin builtin) {
+    return builtins[builtin].argCount;
+}
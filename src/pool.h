@@ -0,0 +1,35 @@
+#ifndef pool_h
+#define pool_h
+
+#include <stdbool.h>
+
+#include "parse.h"
+
+// the slots in each slab of a pool made with 'poolNew(size, 0)'
+#define POOL_DEFAULT_SLAB_SLOTS 256
+
+// the byte written over a slot past its free list link when it is freed, outside of release builds
+#define POOL_POISON 0xdd
+
+// the byte written over a reused slot when it is handed out again, outside of release builds
+#define POOL_UNINITIALIZED 0xcd
+
+typedef enum {
+    POOL_NEW,
+    POOL_ALLOC,
+    POOL_FREE,
+    POOL_DESTROY,
+} PoolBuiltin;
+
+// the name 'Pool<T>' is given once resolved, 'pool__Node' or 'pool__Node_ptr' for 'Pool<*Node>'
+char *poolTypeName(TypeExpr element);
+
+// whether 'name' is that of a typed pool, and the type of the slots it hands out a pointer to
+bool lookupPoolType(char *name, TypeExpr *element);
+
+// whether 'name' is one of the builtins working on a 'Pool', such as 'poolAlloc'
+bool lookupPoolBuiltin(char *name, PoolBuiltin *builtin);
+
+int poolBuiltinArgCount(PoolBuiltin builtin);
+
+#endif
@@ -0,0 +1,239 @@
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "reach.h"
+#include "analyze.h"
+#include "interface.h"
+#include "layout.h"
+
+static void markName(Reachability *reach, char *name);
+
+Reachability newReachability(Ast ast, bool isLibrary) {
+    Reachability reach;
+    reach.ast = ast;
+    reach.isLibrary = isLibrary;
+
+    return reach;
+}
+
+static void markType(Reachability *reach, TypeExpr type) {
+    if (type.name) markName(reach, type.name);
+}
+
+static bool reachVisitor(AstExpr *expr, void *context) {
+    Reachability *reach = context;
+
+    switch (expr->type) {
+        case AST_CALL_EXPR: {
+            markName(reach, expr->asCallExpr.name);
+            break;
+        }
+        case AST_IDENTIFIER: {
+            markName(reach, expr->asIdentifier.name);
+            break;
+        }
+        case AST_PROPERTY_ACCESS: {
+            markName(reach, expr->asProperty.property);
+            break;
+        }
+        case AST_LET: {
+            markType(reach, expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            markType(reach, expr->asStructField.type);
+            break;
+        }
+        case AST_INLINED_CALL: {
+            markType(reach, expr->asInlinedCall.returnType);
+            break;
+        }
+        case AST_EMBED: {
+            // embedded C is opaque, so any identifier in it is treated as a use
+            char *source = expr->asEmbed.embedSource;
+
+            for (int i = 0; source[i];) {
+                if (!isalpha((unsigned char)source[i]) && source[i] != '_') {
+                    i++;
+                    continue;
+                }
+
+                int start = i;
+                while (isalnum((unsigned char)source[i]) || source[i] == '_') i++;
+
+                char *name = strndup(source + start, i - start);
+                markName(reach, name);
+                free(name);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return true;
+}
+
+static void markFunction(Reachability *reach, AstExpr *function) {
+    if (function->asFunction.isReachable) return;
+    function->asFunction.isReachable = true;
+
+    markType(reach, function->asFunction.returnType);
+    for (int i = 0; i < function->asFunction.paramCount; i++) {
+        markType(reach, function->asFunction.parameters[i].type);
+    }
+
+    walkExpr(function, reachVisitor, reach);
+}
+
+static void markStruct(Reachability *reach, AstExpr *structure) {
+    if (structure->asStruct.isReachable) return;
+    structure->asStruct.isReachable = true;
+
+    // member functions are only kept if they are used themselves
+    for (int i = 0; i < structure->asStruct.memberCount; i++) {
+        AstExpr *member = structure->asStruct.members[i];
+        if (member->type == AST_STRUCT_FIELD) walkExpr(member, reachVisitor, reach);
+    }
+
+    // the vtables of its interfaces are emitted with it, and they point at its functions
+    for (int i = 0; i < structure->asStruct.interfaceCount; i++) {
+        char *interfaceName = structure->asStruct.interfaces[i];
+        markName(reach, interfaceName);
+
+        StructDeclaration *interface = lookupStruct(reach->ast, interfaceName);
+        if (!interface) continue;
+
+        for (int j = 0; j < interface->memberCount; j++) {
+            if (interface->members[j]->type != AST_FUNCTION_DECLARATION) continue;
+
+            char *name = methodName(structure->asStruct.name, interface->members[j]->asFunction.name);
+            markName(reach, name);
+            free(name);
+        }
+    }
+}
+
+static bool hasEnumValue(EnumDeclaration enumeration, char *name) {
+    for (int i = 0; i < enumeration.valueCount; i++) {
+        if (strcmp(enumeration.values[i], name) == 0) return true;
+    }
+
+    return false;
+}
+
+// names are resolved by plain lookup, so anything a name could refer to is kept
+static void markName(Reachability *reach, char *name) {
+    AstExpr *function = findFunction(reach->ast, name);
+    if (function) markFunction(reach, function);
+
+    for (int i = 0; i < reach->ast.exprCount; i++) {
+        AstExpr *expr = reach->ast.exprs[i];
+
+        if (expr->type == AST_STRUCT_DECLARATION && strcmp(expr->asStruct.name, name) == 0) {
+            markStruct(reach, expr);
+        }
+
+        if (expr->type == AST_ENUM && !expr->asEnum.isReachable) {
+            if (strcmp(expr->asEnum.name, name) == 0 || hasEnumValue(expr->asEnum, name)) {
+                expr->asEnum.isReachable = true;
+            }
+        }
+    }
+}
+
+static void clearReachable(Ast ast) {
+    for (int i = 0; i < ast.exprCount; i++) {
+        AstExpr *expr = ast.exprs[i];
+
+        switch (expr->type) {
+            case AST_FUNCTION_DECLARATION: {
+                expr->asFunction.isReachable = false;
+                break;
+            }
+            case AST_ENUM: {
+                expr->asEnum.isReachable = false;
+                break;
+            }
+            case AST_STRUCT_DECLARATION: {
+                expr->asStruct.isReachable = false;
+
+                for (int j = 0; j < expr->asStruct.memberCount; j++) {
+                    AstExpr *member = expr->asStruct.members[j];
+                    if (member->type == AST_FUNCTION_DECLARATION) member->asFunction.isReachable = false;
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+static void markPublic(Reachability *reach) {
+    for (int i = 0; i < reach->ast.exprCount; i++) {
+        AstExpr *expr = reach->ast.exprs[i];
+
+        switch (expr->type) {
+            case AST_FUNCTION_DECLARATION: {
+                if (expr->asFunction.isPublic) markFunction(reach, expr);
+                break;
+            }
+            case AST_ENUM: {
+                if (expr->asEnum.isPublic) expr->asEnum.isReachable = true;
+                break;
+            }
+            case AST_STRUCT_DECLARATION: {
+                if (!expr->asStruct.isPublic) break;
+                markStruct(reach, expr);
+
+                for (int j = 0; j < expr->asStruct.memberCount; j++) {
+                    AstExpr *member = expr->asStruct.members[j];
+
+                    if (member->type == AST_FUNCTION_DECLARATION && member->asFunction.isPublic) {
+                        markFunction(reach, member);
+                    }
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+}
+
+void markReachable(Reachability *reach) {
+    AstExpr *main = findFunction(reach->ast, "main");
+
+    // without an entry point there is nothing to root the program at, so keep the public interface
+    bool isLibrary = reach->isLibrary || !main;
+
+    clearReachable(reach->ast);
+
+    if (isLibrary) {
+        markPublic(reach);
+    } else {
+        markFunction(reach, main);
+    }
+
+    // top level statements which are not declarations are always emitted
+    for (int i = 0; i < reach->ast.exprCount; i++) {
+        AstExpr *expr = reach->ast.exprs[i];
+
+        switch (expr->type) {
+            case AST_FUNCTION_DECLARATION:
+            case AST_STRUCT_DECLARATION:
+            case AST_ENUM: {
+                break;
+            }
+            default: {
+                walkExpr(expr, reachVisitor, reach);
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef reach_h
+#define reach_h
+
+#include "parse.h"
+
+typedef struct {
+    Ast  ast;
+
+    // library builds are rooted at every 'pub' symbol rather than at 'main'
+    bool isLibrary;
+} Reachability;
+
+Reachability newReachability(Ast ast, bool isLibrary);
+
+// clears 'isReachable' on every function, struct and enum that cannot be reached from a root
+void markReachable(Reachability *reach);
+
+#endif
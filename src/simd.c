@@ -0,0 +1,129 @@
+#include <string.h>
+#include <ctype.h>
+
+#include "simd.h"
+
+typedef struct {
+    char *name;
+    int   size;
+    bool  isFloat;
+} VectorElement;
+
+static VectorElement elements[] = {
+    { "i8", 1, false }, { "u8", 1, false },
+    { "i16", 2, false }, { "u16", 2, false },
+    { "i32", 4, false }, { "u32", 4, false },
+    { "i64", 8, false }, { "u64", 8, false },
+    { "f32", 4, true }, { "f64", 8, true },
+};
+
+// each parameter is a letter, 'v' a vector, 'm' its mask, 'p' a pointer to elements and 'e' an element
+typedef struct {
+    char *suffix;
+    char *parameters;
+} VectorBuiltinInfo;
+
+// indexed by 'VectorBuiltin'
+static VectorBuiltinInfo builtins[] = {
+    { "Load", "p" },
+    { "LoadAligned", "p" },
+    { "Store", "pv" },
+    { "StoreAligned", "pv" },
+    { "Splat", "e" },
+    { "Shuffle", "vm" },
+    { "Select", "mvv" },
+    { "Min", "vv" },
+    { "Max", "vv" },
+    { "ReduceAdd", "v" },
+    { "ReduceMin", "v" },
+    { "ReduceMax", "v" },
+    { "Bitmask", "m" },
+};
+
+#define elementCount (int)(sizeof(elements) / sizeof(elements[0]))
+#define builtinCount (int)(sizeof(builtins) / sizeof(builtins[0]))
+
+// reads 'v<lanes><element>' from the start of 'name' and returns what follows it
+static char *parseVectorPrefix(char *name, VectorType *vector) {
+    if (name[0] != 'v' || !isdigit((unsigned char)name[1]) || name[1] == '0') return NULL;
+
+    char *cursor = name + 1;
+    int lanes = 0;
+
+    while (isdigit((unsigned char)*cursor)) {
+        lanes = lanes * 10 + (*cursor - '0');
+        if (lanes > 64) return NULL;
+
+        cursor++;
+    }
+
+    for (int i = 0; i < elementCount; i++) {
+        size_t length = strlen(elements[i].name);
+        if (strncmp(cursor, elements[i].name, length) != 0) continue;
+
+        vector->lanes = lanes;
+        vector->element = elements[i].name;
+        vector->elementSize = elements[i].size;
+        vector->isFloat = elements[i].isFloat;
+
+        return cursor + length;
+    }
+
+    return NULL;
+}
+
+bool isVectorSizeSupported(VectorType vector) {
+    int size = vector.lanes * vector.elementSize;
+    return vector.lanes >= 2 && (size == 8 || size == 16 || size == 32 || size == 64);
+}
+
+bool looksLikeVectorType(char *name) {
+    VectorType vector;
+    char *rest = parseVectorPrefix(name, &vector);
+
+    return rest && *rest == '\0';
+}
+
+bool lookupVectorType(char *name, VectorType *vector) {
+    return looksLikeVectorType(name) && parseVectorPrefix(name, vector) && isVectorSizeSupported(*vector);
+}
+
+bool lookupVectorBuiltin(char *name, VectorType *vector, VectorBuiltin *builtin) {
+    char *rest = parseVectorPrefix(name, vector);
+    if (!rest || !isVectorSizeSupported(*vector)) return false;
+
+    for (int i = 0; i < builtinCount; i++) {
+        if (strcmp(rest, builtins[i].suffix) != 0) continue;
+
+        *builtin = (VectorBuiltin)i;
+        return true;
+    }
+
+    return false;
+}
+
+int vectorBuiltinArgCount(VectorBuiltin builtin) {
+    return (int)strlen(builtins[builtin].parameters);
+}
+
+VectorParameter vectorBuiltinParameter(VectorBuiltin builtin, int index) {
+    switch (builtins[builtin].parameters[index]) {
+        case 'v': return VECTOR_PARAMETER_VECTOR;
+        case 'm': return VECTOR_PARAMETER_MASK;
+        case 'p': return VECTOR_PARAMETER_POINTER;
+        default: return VECTOR_PARAMETER_ELEMENT;
+    }
+}
+
+VectorType vectorMaskType(VectorType vector) {
+    for (int i = 0; i < elementCount; i++) {
+        VectorElement element = elements[i];
+        if (element.isFloat || element.name[0] != 'i' || element.size != vector.elementSize) continue;
+
+        vector.element = element.name;
+        vector.isFloat = false;
+        break;
+    }
+
+    return vector;
+}
@@ -0,0 +1,60 @@
+#ifndef simd_h
+#define simd_h
+
+#include <stdbool.h>
+
+// a vector type such as 'v4f32', four lanes of 'f32'
+typedef struct {
+    int   lanes;
+    char *element;
+
+    // the size of one lane in bytes
+    int   elementSize;
+    bool  isFloat;
+} VectorType;
+
+typedef enum {
+    VECTOR_LOAD,
+    VECTOR_LOAD_ALIGNED,
+    VECTOR_STORE,
+    VECTOR_STORE_ALIGNED,
+    VECTOR_SPLAT,
+    VECTOR_SHUFFLE,
+    VECTOR_SELECT,
+    VECTOR_MIN,
+    VECTOR_MAX,
+    VECTOR_REDUCE_ADD,
+    VECTOR_REDUCE_MIN,
+    VECTOR_REDUCE_MAX,
+    VECTOR_BITMASK,
+} VectorBuiltin;
+
+// whether 'name' spells a vector type, 'v' then the lane count then an element type
+// returns false for sizes that are not supported, see 'isVectorSizeSupported'
+bool lookupVectorType(char *name, VectorType *vector);
+
+// whether 'name' spells a vector type whatever its size, so the analyzer can reject 'v3f32'
+bool looksLikeVectorType(char *name);
+
+// a vector must be 8, 16, 32 or 64 bytes and have at least two lanes
+bool isVectorSizeSupported(VectorType vector);
+
+// splits a call such as 'v4f32Load' into the vector it works on and the builtin
+bool lookupVectorBuiltin(char *name, VectorType *vector, VectorBuiltin *builtin);
+
+int vectorBuiltinArgCount(VectorBuiltin builtin);
+
+typedef enum {
+    VECTOR_PARAMETER_VECTOR,
+    VECTOR_PARAMETER_MASK,
+    VECTOR_PARAMETER_POINTER,
+    VECTOR_PARAMETER_ELEMENT,
+} VectorParameter;
+
+// what argument 'index' of 'builtin' is, a vector, its mask, a pointer to elements or a single element
+VectorParameter vectorBuiltinParameter(VectorBuiltin builtin, int index);
+
+// the integer vector that comparing two 'vector's produces, 'v4i32' for 'v4f32'
+VectorType vectorMaskType(VectorType vector);
+
+#endif
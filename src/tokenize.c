@@ -42,6 +42,7 @@ static void initKeywords(Lexer *l) {
     newKeyword(l, "return", TOKEN_RETURN);
     newKeyword(l, "struct", TOKEN_STRUCT);
     newKeyword(l, "interface", TOKEN_INTERFACE);
+    newKeyword(l, "with", TOKEN_WITH);
     newKeyword(l, "true", TOKEN_TRUE);
     newKeyword(l, "false", TOKEN_FALSE);
     newKeyword(l, "while", TOKEN_WHILE);
@@ -65,6 +66,8 @@ static void initKeywords(Lexer *l) {
     newKeyword(l, "const", TOKEN_CONST);
     newKeyword(l, "defer", TOKEN_DEFER);
     newKeyword(l, "embed", TOKEN_EMBED);
+    newKeyword(l, "spawn", TOKEN_SPAWN);
+    newKeyword(l, "sync", TOKEN_SYNC);
 }
 
 Lexer newLexer(char *filePath, char *source, bool debug) {
@@ -115,6 +118,10 @@ static inline char currentChar(Lexer *l) {
     return isEnd(l) ? '\0' : l->source[l->position];
 }
 
+static inline char nextChar(Lexer *l) {
+    return l->position + 1 >= l->sourceLength ? '\0' : l->source[l->position + 1];
+}
+
 static inline bool shouldPeek(Lexer *l, bool (*predicate)(char)) {
     return !isEnd(l) && predicate(currentChar(l));
 }
@@ -152,6 +159,9 @@ static Token tokenizeNumber(Lexer *l) {
 
     bool hasDecimal = false;
     while (shouldPeek(l, tokenizeNumberPredicate)) {
+        // '0..10' is a range, not a number
+        if (currentChar(l) == '.' && nextChar(l) == '.') break;
+
         if (!hasDecimal && currentChar(l) == '.') {
             hasDecimal = true;
         } else if (currentChar(l) == '.') {
@@ -225,6 +235,8 @@ static Token tokenizeSymbol(Lexer *l) {
         case '*': return newToken("*", TOKEN_STAR, l);
         case '(': return newToken("(", TOKEN_LEFT_PAREN, l);
         case ')': return newToken(")", TOKEN_RIGHT_PAREN, l);
+        case '[': return newToken("[", TOKEN_LEFT_BRACKET, l);
+        case ']': return newToken("]", TOKEN_RIGHT_BRACKET, l);
         case '{': return newToken("{", TOKEN_LEFT_BRACE, l);
         case '}': return newToken("}", TOKEN_RIGHT_BRACE, l);
         case ',': return newToken(",", TOKEN_COMMA, l);
@@ -253,7 +265,17 @@ static Token tokenizeSymbol(Lexer *l) {
         case '-': return newToken("-", TOKEN_MINUS, l);
         case '/': return newToken("/", TOKEN_SLASH, l);
         case '%': return newToken("%", TOKEN_MODULO, l);
-        case '.': return newToken(".", TOKEN_DOT, l);
+        case '.': {
+            if (currentChar(l) != '.') return newToken(".", TOKEN_DOT, l);
+            advance(l);
+
+            if (currentChar(l) == '=') {
+                advance(l);
+                return newToken("..=", TOKEN_DOT_DOT_EQUALS, l);
+            }
+
+            return newToken("..", TOKEN_DOT_DOT, l);
+        }
         case '>': {
             if (currentChar(l) == '=') {
                 advance(l);
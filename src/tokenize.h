@@ -10,6 +10,7 @@ typedef enum {
     TOKEN_RETURN,
     TOKEN_STRUCT,
     TOKEN_INTERFACE,
+    TOKEN_WITH,
     TOKEN_NEXT,
     TOKEN_STOP,
     TOKEN_WHILE,
@@ -31,6 +32,8 @@ typedef enum {
     TOKEN_MODULE,
     TOKEN_CONST,
     TOKEN_DEFER,
+    TOKEN_SPAWN,
+    TOKEN_SYNC,
 
     TOKEN_SINGLE_EQUALS,
     TOKEN_COLON,
@@ -39,6 +42,8 @@ typedef enum {
     TOKEN_COMMA,
     TOKEN_LEFT_PAREN,
     TOKEN_RIGHT_PAREN,
+    TOKEN_LEFT_BRACKET,
+    TOKEN_RIGHT_BRACKET,
     TOKEN_SEMICOLON,
     TOKEN_AT,
     TOKEN_EMBED,
@@ -62,6 +67,8 @@ typedef enum {
     TOKEN_SHIFT_LEFT,
     TOKEN_SHIFT_RIGHT,
     TOKEN_DOT,
+    TOKEN_DOT_DOT,
+    TOKEN_DOT_DOT_EQUALS,
     TOKEN_DOUBLE_QUOTE,
 
     TOKEN_INTEGER,
@@ -1,18 +1,51 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <ctype.h>
 
 #include "transpile.h"
 #include "map.h"
 #include "err.h"
+#include "fold.h"
+#include "simd.h"
+#include "arena.h"
+#include "pool.h"
+#include "atomic.h"
+#include "layout.h"
+#include "interface.h"
 
 static void emitExpr(Transpiler *t, AstExpr *expr);
+static void emitCallInto(Transpiler *t, CallExpr call, AstExpr *callee, char *result);
+static void emitCallExpr(Transpiler *t, CallExpr call);
 
-Transpiler newTranspiler(FILE *fptr, Ast ast) {
+Transpiler newTranspiler(FILE *fptr, Ast ast, bool isRelease) {
     Transpiler transpiler;
     transpiler.ast = ast;
     transpiler.fptr = fptr;
 
     transpiler.isEmittingExpression = false;
+    transpiler.isRelease = isRelease;
+
+    transpiler.currentFunction = NULL;
+    transpiler.byReference = NULL;
+    transpiler.isReturningByReference = false;
+
+    transpiler.deferScopes = malloc(sizeof(DeferScope));
+    transpiler.deferScopeCount = 0;
+    transpiler.deferScopeCapacity = 1;
+
+    transpiler.functionScope = -1;
+    transpiler.loopScope = -1;
+    transpiler.hasDefers = false;
+    transpiler.hasSpawns = false;
+    transpiler.uniqueCount = 0;
+    transpiler.dispatchLoop = -1;
+    transpiler.nextLabel = -1;
+
+    transpiler.usesOpenMP = false;
+    transpiler.usesOpenMPSimd = false;
+    transpiler.usesThreads = false;
 
     return transpiler;
 }
@@ -57,551 +90,2346 @@ static inline void emitSemicolon(Transpiler *t) {
     emit(t, ";");
 }
 
+// emits an expression whose result is used, rather than a statement
+static void emitValue(Transpiler *t, AstExpr *expr) {
+    bool wasEmittingExpression = t->isEmittingExpression;
+    t->isEmittingExpression = true;
+
+    emitExpr(t, expr);
+
+    t->isEmittingExpression = wasEmittingExpression;
+}
+
+// the '@soa' struct whose arrays back 'type', or null if it is an ordinary array
+static StructDeclaration *soaStructOf(Transpiler *t, TypeExpr type) {
+    if (!isSoaType(t->ast, type)) return NULL;
+
+    return lookupStruct(t->ast, type.name);
+}
+
+// each element type gets its own slice struct, '[]*u8' is '__slice_u8_ptr'
+// a slice of an '@soa' struct holds a pointer per field instead, '[]Particle' is '__soa_slice_Particle'
+static void emitSliceTypeName(Transpiler *t, TypeExpr element) {
+    element.isSlice = true;
+    if (soaStructOf(t, element)) {
+        emit(t, "__soa_slice_");
+        emit(t, element.name);
+        return;
+    }
+
+    emit(t, "__slice_");
+    emit(t, element.name);
+    for (int i = 0; i < element.ptrDepth; i++) emit(t, "_ptr");
+}
+
+// the element type of a fixed array, its length follows the name (see 'emitArrayLength')
+static void emitSoaArrayType(Transpiler *t, StructDeclaration *soa, int length);
+
 static void emitTypeExpression(Transpiler *t, TypeExpr type) {
+    StructDeclaration *soa = soaStructOf(t, type);
+    if (soa && type.arrayLength) {
+        emitSoaArrayType(t, soa, type.arrayLength);
+        emitSpace(t);
+        return;
+    }
+
+    if (type.isSlice) {
+        emitSliceTypeName(t, type);
+        emitSpace(t);
+        return;
+    }
+
     emit(t, mapPrimitiveTypeToC(type.name));
     for (int i = 0; i < type.ptrDepth; i++) emitStar(t);
     
     emitSpace(t);
 }
 
-static void emitFunctionDeclaration(Transpiler *t, FunctionDeclaration function) {
-    emitNewline(t);
+static void emitArrayLength(Transpiler *t, TypeExpr type) {
+    if (type.arrayLength && !soaStructOf(t, type)) fprintf(t->fptr, "[%d]", type.arrayLength);
+}
 
-    if (function.isInline) {
-        emit(t, "inline");
+// non-pub functions get internal linkage so the C compiler is free to inline
+// or discard them, the entry point is always kept external
+//
+// '@inline' is forced rather than hinted, only the definition of a 'pub' function says 'inline'
+// so the forward declaration without it still gives C99 an external definition to link against
+static void emitFunctionSpecifiers(Transpiler *t, FunctionDeclaration function, bool isDefinition) {
+    bool isExternal = function.isPublic || strcmp(function.name, "main") == 0;
+
+    if (!isExternal) {
+        emit(t, "static");
         emitSpace(t);
     }
 
-    emitTypeExpression(t, function.returnType);
-    emit(t, function.name);
-
-    emitLeftParen(t);
-
-    for (int i = 0; i < function.paramCount; i++) {
-        emitTypeExpression(t, function.parameters[i].type);
-        emit(t, function.parameters[i].name);
+    if (hasTag(function.tags, TAG_INLINE) && (!isExternal || isDefinition)) {
+        emit(t, "inline");
+        emitSpace(t);
+    }
 
-        if (i != function.paramCount - 1) {
-            emitComma(t);
-            emitSpace(t);
-        }
+    // hot and cold functions are also grouped into their own text sections by gcc
+    static const struct { TagType tag; char *attribute; } attributes[] = {
+        { TAG_INLINE,   "always_inline" },
+        { TAG_NOINLINE, "noinline" },
+        { TAG_HOT,      "hot" },
+        { TAG_COLD,     "cold" },
+        { TAG_PURE,     "pure" },
+        { TAG_CONST,    "const" },
+    };
+
+    bool isFirst = true;
+    for (size_t i = 0; i < sizeof(attributes) / sizeof(attributes[0]); i++) {
+        if (!hasTag(function.tags, attributes[i].tag)) continue;
+
+        emit(t, isFirst ? "__attribute__((" : ", ");
+        emit(t, attributes[i].attribute);
+        isFirst = false;
     }
 
-    emitRightParen(t);
-    emitSpace(t);
-    emitLeftBrace(t);
-    emitNewline(t);
+    if (!isFirst) {
+        emit(t, "))");
+        emitSpace(t);
+    }
+}
 
-    int *deferIndexes = malloc(sizeof(int));
-    int deferIndexesCount = 0;
-    int deferIndexesCapacity = 1;
+// wraps a branch condition in '__builtin_expect' when it is tagged '@likely' or '@unlikely'
+static void emitCondition(Transpiler *t, AstExpr *condition, uint32_t tags) {
+    if (!hasTag(tags, TAG_LIKELY) && !hasTag(tags, TAG_UNLIKELY)) {
+        emitExpr(t, condition);
+        return;
+    }
 
-    if (!function.isLambda) {
-        for (int i = 0; i < function.block.count; i++) {
-            if (function.block.body[i]->type == AST_DEFER_STATEMENT) {
-                if (deferIndexesCount >= deferIndexesCapacity) {
-                    deferIndexesCapacity *= 2;
-                    deferIndexes = realloc(deferIndexes, deferIndexesCapacity * sizeof(int));
-                }
-                deferIndexes[deferIndexesCount++] = i;
+    emit(t, "__builtin_expect(!!(");
+    emitExpr(t, condition);
+    emit(t, hasTag(tags, TAG_LIKELY) ? "), 1)" : "), 0)");
+}
 
-                continue;
-            }
+// a '@likely' match expects its first case to be taken
+static void emitMatchSubject(Transpiler *t, MatchExpr match) {
+    if (!hasTag(match.tags, TAG_LIKELY) || match.caseCount == 0 || match.cases[0].isElseCase) {
+        emitValue(t, match.expression);
+        return;
+    }
 
-            emitExpr(t, function.block.body[i]);
-        }
+    emit(t, "__builtin_expect((long)(");
+    emitValue(t, match.expression);
+    emit(t, "), (long)(");
+    emitExpr(t, match.cases[0].pattern);
+    emit(t, "))");
+}
 
-        emit(t, "\n// deferred\n");
-        for (int i = 0; i < deferIndexesCount; i++) {
-            emitExpr(t, function.block.body[deferIndexes[i]]);
-        }
-    } else {
-        emit(t, "return");
-        emitSpace(t);
-        emitExpr(t, function.lambdaExpr);
-        
-        emitSemicolon(t);
-        emitNewline(t);
+static void pushDeferScope(Transpiler *t) {
+    if (t->deferScopeCount >= t->deferScopeCapacity) {
+        t->deferScopeCapacity *= 2;
+        t->deferScopes = realloc(t->deferScopes, sizeof(DeferScope) * t->deferScopeCapacity);
     }
 
+    t->deferScopes[t->deferScopeCount++] = (DeferScope){ malloc(sizeof(AstExpr *)), 0, 1 };
+}
 
-
-    emitRightBrace(t);
-    emitNewline(t);
+static void popDeferScope(Transpiler *t) {
+    free(t->deferScopes[--t->deferScopeCount].defers);
 }
 
-static void emitReturnMatch(Transpiler *t, MatchExpr match) {
-    emit(t, "switch");
-    emitSpace(t);
+static void registerDefer(Transpiler *t, AstExpr *defer) {
+    DeferScope *scope = &t->deferScopes[t->deferScopeCount - 1];
 
-    emitLeftParen(t);
-    emitExpr(t, match.expression);
-    emitRightParen(t);
-    emitSpace(t);
+    if (scope->count >= scope->capacity) {
+        scope->capacity *= 2;
+        scope->defers = realloc(scope->defers, sizeof(AstExpr *) * scope->capacity);
+    }
+    scope->defers[scope->count++] = defer;
+}
 
-    emitLeftBrace(t);
-    emitNewline(t);
+// runs the defers registered in the innermost scopes down to 'outermost', latest first
+static void emitScopeExit(Transpiler *t, int outermost) {
+    for (int i = t->deferScopeCount - 1; i >= outermost && i >= 0; i--) {
+        DeferScope scope = t->deferScopes[i];
 
-    for (int i = 0; i < match.caseCount; i++) {
-        if (match.cases[i].isElseCase) {
-            emit(t, "default");
-            emit(t, ":");
-            emitNewline(t);
+        for (int j = scope.count - 1; j >= 0; j--) {
+            emitExpr(t, scope.defers[j]->asDefer.statement);
+        }
+    }
+}
 
-            emit(t, "return");
-            emitSpace(t);
-            emitExpr(t, match.cases[i].expression);
-            emitSemicolon(t);
+// the statements of a block, a defer runs when the block is left rather than where it is written
+static void emitScope(Transpiler *t, BlockExpr block) {
+    pushDeferScope(t);
+
+    for (int i = 0; i < block.count; i++) {
+        if (block.body[i]->type == AST_DEFER_STATEMENT) {
+            registerDefer(t, block.body[i]);
             continue;
         }
 
-        emit(t, "case");
-        emitSpace(t);
-        emitExpr(t, match.cases[i].pattern);
-
-        emit(t, ":");
-        emitNewline(t);
+        emitExpr(t, block.body[i]);
+    }
 
-        emit(t, "return");
-        emitSpace(t);
-        emitExpr(t, match.cases[i].expression);
-        emitSemicolon(t);
+    // a block ending in a jump has already run its defers on the way out
+    AstType last = block.count ? block.body[block.count - 1]->type : AST_BLOCK;
+    if (last != AST_RETURN && last != AST_STOP && last != AST_NEXT) emitScopeExit(t, t->deferScopeCount - 1);
 
-        emitNewline(t);
-        emit(t, "break");
-        emitSemicolon(t);
+    popDeferScope(t);
+}
 
-        emitNewline(t);
-    }
+static bool deferVisitor(AstExpr *expr, void *context) {
+    bool *hasDefers = context;
+    if (expr->type == AST_DEFER_STATEMENT) *hasDefers = true;
 
-    emitRightBrace(t);
-    emitNewline(t);
+    return !*hasDefers;
 }
 
-static void emitReturnStatement(Transpiler *t, ReturnStatement returnStatement) {
-    if (returnStatement.value->type == AST_MATCH) {
-        emitReturnMatch(t, returnStatement.value->asMatch);
-        return;
-    }
+static bool spawnVisitor(AstExpr *expr, void *context) {
+    bool *hasSpawns = context;
+    if (expr->type == AST_CALL_EXPR && expr->asCallExpr.isSpawned) *hasSpawns = true;
 
-    emit(t, "return");
-    emitSpace(t);
+    return !*hasSpawns;
+}
 
-    emitExpr(t, returnStatement.value);
-    emitSemicolon(t);
+// 'sync', and the implicit one before a function which spawns returns, a function which
+// spawns nothing has nothing to wait for
+static void emitTaskWait(Transpiler *t) {
+    if (!t->hasSpawns) return;
 
+    emit(t, "__aster_sync(&__spawned);");
     emitNewline(t);
 }
 
-static void emitWhileStatement(Transpiler *t, WhileStatement whileStatement) {
-    emit(t, "while");
-    emitSpace(t);
+// the name shared by the record of a spawned call and the function running it, 'fib' for a call whose
+// result is not kept and 'fib__i64' for one whose result is written to an 'i64'
+static char *taskRecordName(char *callee, TypeExpr *result) {
+    size_t length = strlen(callee) + 1;
+    if (result) length += strlen("__") + strlen(result->name) + strlen("_ptr") * result->ptrDepth;
 
-    emitLeftParen(t);
-    emitExpr(t, whileStatement.condition);
-    emitRightParen(t);
+    char *name = malloc(length);
+    strcpy(name, callee);
+    if (!result) return name;
 
-    emitSpace(t);
+    strcat(name, "__");
+    strcat(name, result->name);
+    for (int i = 0; i < result->ptrDepth; i++) strcat(name, "_ptr");
 
-    emitLeftBrace(t);
-    emitNewline(t);
+    return name;
+}
 
-    for (int i = 0; i < whileStatement.block.count; i++) {
-        emitExpr(t, whileStatement.block.body[i]);
-    }
+// the type of the variable the result of a spawned call is written to
+static bool findSpawnResultType(Transpiler *t, AstExpr *function, char *name, TypeExpr *type) {
+    if (function && findLocalType(function, name, type)) return true;
 
-    if (whileStatement.alteration) emitExpr(t, whileStatement.alteration);
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        if (t->ast.exprs[i]->type != AST_LET || strcmp(t->ast.exprs[i]->asLet.name, name) != 0) continue;
 
-    emitRightBrace(t);
-    emitNewline(t);
-}
+        *type = t->ast.exprs[i]->asLet.type;
+        return true;
+    }
 
-static void emitForStatement(Transpiler *t, ForStatement forStatement) {
-    if (!t) return;
-    if (!forStatement.iterator) return;
+    return false;
 }
 
-// block cases (x => { ... }) are not allowed for assignment, must be: x => <expr>
-static void emitLetMatchAssignment(Transpiler *t, LetDeclaration let, MatchExpr match) {
-    emitTypeExpression(t, let.type);
-    emit(t, let.name);
+// a spawned call runs where it is spawned when there is no function declaration to build its record from,
+// or when it is not in a function which waits for its tasks
+static void emitSpawnedCallInPlace(Transpiler *t, CallExpr call, char *result) {
+    if (result) fprintf(t->fptr, "%s = ", result);
+
+    call.isSpawned = false;
+    emitValue(t, &(AstExpr){ .type = AST_CALL_EXPR, .asCallExpr = call });
+
     emitSemicolon(t);
     emitNewline(t);
+}
 
-    emit(t, "switch");
-    emitSpace(t);
+// a spawned call is a task record holding its arguments and where its result goes, which is pushed
+// onto the spawning worker's deque for it or a thief to run, see 'emitTaskSupport'
+static void emitSpawn(Transpiler *t, CallExpr call, char *result, TypeExpr *resultType) {
+    AstExpr *callee = findFunction(t->ast, call.name);
+    if (!callee || (result && !resultType) || !t->hasSpawns) {
+        emitSpawnedCallInPlace(t, call, result);
+        return;
+    }
 
-    emitLeftParen(t);
-    emitExpr(t, match.expression);
-    emitRightParen(t);
-    emitSpace(t);
+    int id = t->uniqueCount++;
+    char *name = taskRecordName(call.name, result ? resultType : NULL);
 
     emitLeftBrace(t);
     emitNewline(t);
 
-    for (int i = 0; i < match.caseCount; i++) {
-        if (match.cases[i].isElseCase) {
-            emit(t, "default");
-            emit(t, ":");
-            emitNewline(t); 
-
-            emit(t, let.name);
-            emit(t, "=");
-            emitExpr(t, match.cases[i].expression);
-            emitSemicolon(t);
-            emitNewline(t);
-
-            emit(t, "break");
-            emitSemicolon(t);
-
-            emitNewline(t);
-            continue;
-        }
-
-        emit(t, "case");
-        emitSpace(t);
-        emitExpr(t, match.cases[i].pattern);
+    fprintf(t->fptr, "__AsterTask_%s *__task%d = __aster_task_new(sizeof(__AsterTask_%s), __aster_run_%s, &__spawned);", name, id, name, name);
+    emitNewline(t);
 
-        emit(t, ":");
+    if (result) {
+        fprintf(t->fptr, "__task%d->result = &%s;", id, result);
         emitNewline(t);
+    }
 
-        emit(t, let.name);
-        emit(t, "=");
-        emitExpr(t, match.cases[i].expression);
-        emitSemicolon(t);
-
-        emitNewline(t);
-        emit(t, "break");
+    // the arguments are evaluated here, the task is only given their values
+    for (int i = 0; i < call.argCount; i++) {
+        fprintf(t->fptr, "__task%d->a%d = ", id, i);
+        emitValue(t, call.arguments[i]);
         emitSemicolon(t);
-
         emitNewline(t);
     }
 
+    fprintf(t->fptr, "__aster_spawn(&__task%d->task);", id);
+    emitNewline(t);
     emitRightBrace(t);
     emitNewline(t);
+
+    free(name);
 }
 
-static void emitLetDeclaration(Transpiler *t, LetDeclaration let) {
-    if (let.value->type == AST_MATCH) {
-        emitLetMatchAssignment(t, let, let.value->asMatch);
-        return;
+typedef struct {
+    Transpiler *t;
+    AstExpr    *function;
+
+    // the records emitted so far
+    char      **names;
+    int         count;
+    int         capacity;
+} TaskRecords;
+
+// the record of a call to 'callee' keeps its arguments, converted to the parameter types, and a pointer
+// to the variable its result is written to, the record is freed once it has run
+static void emitTaskRecord(TaskRecords *records, CallExpr call, TypeExpr *result) {
+    Transpiler *t = records->t;
+
+    AstExpr *callee = findFunction(t->ast, call.name);
+    if (!callee) return;
+
+    char *name = taskRecordName(call.name, result);
+    for (int i = 0; i < records->count; i++) {
+        if (strcmp(records->names[i], name) == 0) {
+            free(name);
+            return;
+        }
     }
 
-    emitTypeExpression(t, let.type);
-    emit(t, let.name);
+    if (records->count == records->capacity) {
+        records->capacity *= 2;
+        records->names = realloc(records->names, sizeof(char *) * records->capacity);
+    }
+    records->names[records->count++] = name;
 
-    emitSpace(t);
-    emit(t, "=");
-    emitSpace(t);
+    FunctionDeclaration function = callee->asFunction;
 
-    emitExpr(t, let.value);
-    emitSemicolon(t);
-    
     emitNewline(t);
-}
+    emit(t, "typedef struct {\n");
+    emit(t, "__AsterTask task;\n");
 
-static void emitStructDeclaration(Transpiler *t, StructDeclaration structDeclaration) {
-    emit(t, "typedef");
-    emitSpace(t);
-    emit(t, "struct");
-    emitSpace(t);
+    if (result) {
+        emitTypeExpression(t, *result);
+        emit(t, "*result;\n");
+    }
 
-    emitLeftBrace(t);
-    emitNewline(t);
+    // a fixed array parameter is a pointer in C, so the record keeps the pointer too
+    for (int i = 0; i < function.paramCount; i++) {
+        TypeExpr type = function.parameters[i].type;
 
-    int fieldCount = 0;
-    for (int i = 0; i < structDeclaration.memberCount; i++) {
-        if (structDeclaration.members[i]->type == AST_STRUCT_FIELD) fieldCount++;
+        emitTypeExpression(t, type);
+        if (type.arrayLength && !soaStructOf(t, type)) emitStar(t);
+        fprintf(t->fptr, "a%d;\n", i);
     }
-    if (fieldCount == 0) {
-        emit(t, "char dummy;");
+    fprintf(t->fptr, "} __AsterTask_%s;\n\n", name);
+
+    fprintf(t->fptr, "static void __aster_run_%s(__AsterTask *task) {\n", name);
+    fprintf(t->fptr, "__AsterTask_%s *__record = (__AsterTask_%s *)task;\n", name, name);
+
+    AstExpr **arguments = malloc(sizeof(AstExpr *) * (call.argCount + 1));
+    for (int i = 0; i < call.argCount; i++) {
+        char argument[32];
+        snprintf(argument, sizeof(argument), "__record->a%d", i);
+        arguments[i] = newIdentifierExpr(argument);
     }
 
-    int *fnIndexs = malloc(sizeof(int));
-    int fnIndexCapacity = 1;
-    int fnIndexCount = 0;
+    CallExpr task = call;
+    task.arguments = arguments;
+    task.isSpawned = false;
 
-    for (int i = 0; i < structDeclaration.memberCount; i++) {
-        if (structDeclaration.members[i]->type == AST_FUNCTION_DECLARATION) {            
-            if (fnIndexCount >= fnIndexCapacity) {
-                fnIndexCapacity *= 2;
-                fnIndexs = realloc(fnIndexs, sizeof(int) * fnIndexCapacity);
-            }
+    bool wasEmittingExpression = t->isEmittingExpression;
+    t->isEmittingExpression = result != NULL;
 
-            fnIndexs[fnIndexCount++] = i;
-            continue;
-        }
+    if (result) emit(t, "*__record->result = ");
+    emitCallExpr(t, task);
+    if (result) emitSemicolon(t);
 
-        emitExpr(t, structDeclaration.members[i]);
+    t->isEmittingExpression = wasEmittingExpression;
 
-        // emitSemicolon(t);
-        emitNewline(t);
+    emit(t, "\n}\n");
+
+    for (int i = 0; i < call.argCount; i++) {
+        freeExpr(arguments[i]);
     }
+    free(arguments);
+}
 
-    emitNewline(t);
-    emitRightBrace(t);
-    emitSpace(t);
-    emit(t, structDeclaration.name);
-    emitSemicolon(t);
+static bool taskRecordVisitor(AstExpr *expr, void *context) {
+    TaskRecords *records = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            LetDeclaration let = expr->asLet;
+            if (!let.value || let.value->type != AST_CALL_EXPR || !let.value->asCallExpr.isSpawned) return true;
+
+            emitTaskRecord(records, let.value->asCallExpr, &let.type);
+            return false;
+        }
+        case AST_ASSIGN_EXPR: {
+            AssignmentExpr assign = expr->asAssign;
+            if (assign.value->type != AST_CALL_EXPR || !assign.value->asCallExpr.isSpawned) return true;
 
-    for (int i = 0; i < fnIndexCount; i++) {
-        emitExpr(t, structDeclaration.members[fnIndexs[i]]);
+            TypeExpr type;
+            if (findSpawnResultType(records->t, records->function, assign.name, &type)) {
+                emitTaskRecord(records, assign.value->asCallExpr, &type);
+            }
+            return false;
+        }
+        case AST_CALL_EXPR: {
+            if (expr->asCallExpr.isSpawned) emitTaskRecord(records, expr->asCallExpr, NULL);
+            return true;
+        }
+        default: {
+            return true;
+        }
     }
+}
 
-    free(fnIndexs);
+static void emitFunctionTaskRecords(TaskRecords *records, AstExpr *function) {
+    if (!function->asFunction.isReachable || function->asFunction.isLambda) return;
 
-    emitNewline(t);
+    records->function = function;
+    for (int i = 0; i < function->asFunction.block.count; i++) {
+        walkExpr(function->asFunction.block.body[i], taskRecordVisitor, records);
+    }
 }
 
-static void emitIfStatement(Transpiler *t, IfStatement ifStatement) {
-    emit(t, "if");
-    emitSpace(t);
-    emitLeftParen(t);
-    emitExpr(t, ifStatement.condition);
-    emitRightParen(t);
-    emitSpace(t);
+// a record and a function running it for each function spawned, and each type its result is written to
+static void emitTaskRecords(Transpiler *t) {
+    TaskRecords records = { t, NULL, malloc(sizeof(char *)), 0, 1 };
 
-    emitLeftBrace(t);
-        emitNewline(t);
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type == AST_FUNCTION_DECLARATION) emitFunctionTaskRecords(&records, expr);
+
+        if (expr->type != AST_STRUCT_DECLARATION || expr->asStruct.isInterface) continue;
 
-    for (int i = 0; i < ifStatement.block.count; i++) {
-        emitExpr(t, ifStatement.block.body[i]);
+        for (int j = 0; j < expr->asStruct.memberCount; j++) {
+            if (expr->asStruct.members[j]->type == AST_FUNCTION_DECLARATION) {
+                emitFunctionTaskRecords(&records, expr->asStruct.members[j]);
+            }
+        }
     }
 
-    emitRightBrace(t);
-    emitNewline(t);
+    for (int i = 0; i < records.count; i++) {
+        free(records.names[i]);
+    }
+    free(records.names);
 }
 
-static void emitAssignExpression(Transpiler *t, AssignmentExpr assign) {
-    for (int i = 0; i < assign.ptrDepth; i++) emitStar(t);
-    emit(t, assign.name);
-    emitSpace(t);
-    emit(t, "=");
-    emitSpace(t);
+// private functions take and return structs larger than this through pointers, the C ABI
+// would pass them through memory anyway, only after copying them
+#define BY_REFERENCE_MIN_SIZE 16
 
-    emitExpr(t, assign.value);
-    emitSemicolon(t);
-    emitNewline(t);
-}
+static bool isLargeStruct(Transpiler *t, TypeExpr type) {
+    if (type.ptrDepth || type.arrayLength || type.isSlice) return false;
 
-static void emitIntegerLiteral(Transpiler *t, IntegerLiteralExpr integer) {
-    fprintf(t->fptr, "%lld", integer.value);
-}
+    StructDeclaration *declaration = lookupStruct(t->ast, type.name);
+    if (!declaration || declaration->isInterface) return false;
 
-static void emitFloatLiteral(Transpiler *t, FloatLiteralExpr floatLiteral) {
-    fprintf(t->fptr, "%f", floatLiteral.value);
+    TypeLayout layout = layoutOfType(t->ast, type);
+    return layout.isKnown && layout.size > BY_REFERENCE_MIN_SIZE;
 }
 
-static void emitStringLiteral(Transpiler *t, StringLiteralExpr string) {
-    fprintf(t->fptr, "%s", string.value);
+typedef struct {
+    char *name;
+    bool  isFound;
+} EmbedSearch;
+
+static bool embedSearchVisitor(AstExpr *expr, void *context) {
+    EmbedSearch *search = context;
+    if (search->isFound) return false;
+    if (expr->type != AST_EMBED) return true;
+
+    char *source = expr->asEmbed.embedSource;
+    size_t length = strlen(search->name);
+
+    for (char *found = strstr(source, search->name); found; found = strstr(found + 1, search->name)) {
+        bool isStart = found == source || !(isalnum((unsigned char)found[-1]) || found[-1] == '_');
+        bool isEnd = !(isalnum((unsigned char)found[length]) || found[length] == '_');
+        if (isStart && isEnd) search->isFound = true;
+    }
+
+    return false;
 }
 
-static void emitCharLiteral(Transpiler *t, CharLiteralExpr charLiteral) {
-    fprintf(t->fptr, "\'%s\'", charLiteral.value);
+// whether 'name' appears as a whole identifier in embedded C anywhere in the program,
+// which calls functions with their declared signature
+static bool isNamedInEmbed(Transpiler *t, char *name) {
+    EmbedSearch search = { name, false };
+
+    for (int i = 0; i < t->ast.exprCount && !search.isFound; i++) {
+        walkExpr(t->ast.exprs[i], embedSearchVisitor, &search);
+    }
+
+    return search.isFound;
 }
 
-static void emitBoolLiteral(Transpiler *t, BoolLiteralExpr boolLiteral) {
-    fprintf(t->fptr, "%s", boolLiteral.value ? "true" : "false");
+// the functions behind an interface vtable are called through it with their declared signature
+static bool implementsInterfaceFunction(Transpiler *t, char *name) {
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type != AST_STRUCT_DECLARATION) continue;
+
+        for (int j = 0; j < expr->asStruct.interfaceCount; j++) {
+            StructDeclaration *interface = lookupStruct(t->ast, expr->asStruct.interfaces[j]);
+            if (!interface) continue;
+
+            for (int k = 0; k < interface->memberCount; k++) {
+                if (interface->members[k]->type != AST_FUNCTION_DECLARATION) continue;
+
+                char *method = methodName(expr->asStruct.name, interface->members[k]->asFunction.name);
+                bool isMatch = strcmp(method, name) == 0;
+                free(method);
+
+                if (isMatch) return true;
+            }
+        }
+    }
+
+    return false;
 }
 
-static void emitIdentifier(Transpiler *t, IdentifierExpr identifier) {
-    emit(t, identifier.name);
+// 'pub' functions, the entry point and anything C calls by name keep the plain C ABI, as do
+// '@pure' and '@const' functions, which gcc may not let read or write through pointers
+static bool hasPrivateAbi(Transpiler *t, FunctionDeclaration function) {
+    if (function.isPublic || function.isLambda || strcmp(function.name, "main") == 0) return false;
+    if (hasTag(function.tags, TAG_PURE) || hasTag(function.tags, TAG_CONST)) return false;
+
+    return !isNamedInEmbed(t, function.name) && !implementsInterfaceFunction(t, function.name);
 }
 
-static void emitTernary(Transpiler *t, TernaryExpression ternary) {
-    emitExpr(t, ternary.condition);
-    emit(t, " ? ");
-    emitExpr(t, ternary.trueExpr);
-    emit(t, " : ");
-    emitExpr(t, ternary.falseExpr);
-    emitSemicolon(t);
+static bool returnsByReference(Transpiler *t, FunctionDeclaration function) {
+    return hasPrivateAbi(t, function) && isLargeStruct(t, function.returnType);
 }
 
-static void emitNext(Transpiler *t, NextStatement next) {
-    emit(t, "continue;");
-    emitNewline(t);
+typedef struct {
+    char *name;
+    bool  isWritten;
+} ParameterWrites;
 
-    // prevent compiler warning
-    if (next.dummy == ' ') return;
+// the variable an lvalue such as 'p.field' or '(*p)' is part of
+static AstExpr *rootOf(AstExpr *expr) {
+    switch (expr->type) {
+        case AST_GROUPING: return rootOf(expr->asGrouping.expression);
+        case AST_PROPERTY_ACCESS: return rootOf(expr->asProperty.object);
+        case AST_INDEX: return rootOf(expr->asIndex.object);
+        default: return expr;
+    }
 }
 
-static void emitStop(Transpiler *t, StopStatement stop) {
-    emit(t, "break;");
-    emitNewline(t);
+static bool parameterWriteVisitor(AstExpr *expr, void *context) {
+    ParameterWrites *writes = context;
 
-    // prevent compiler warning
-    if (stop.dummy == ' ') return;
-}
+    if (expr->type == AST_ASSIGN_EXPR && strcmp(expr->asAssign.name, writes->name) == 0) {
+        writes->isWritten = true;
+    }
 
-static void emitUnary(Transpiler *t, UnaryExpr unary) {
-    if (unary.operator == OP_SIZEOF) {
-        emit(t, mapOperatorType(unary.operator));
-        emitLeftParen(t);
-        emitExpr(t, unary.right);
-        emitRightParen(t);
-    } else {
-        emit(t, mapOperatorType(unary.operator));
-        emitExpr(t, unary.right);
+    if (expr->type == AST_UNARY && expr->asUnary.operator == OP_ADDRESS_OF) {
+        AstExpr *root = rootOf(expr->asUnary.right);
+        if (root->type == AST_IDENTIFIER && strcmp(root->asIdentifier.name, writes->name) == 0) writes->isWritten = true;
     }
+
+    // embedded C sees the parameter by name and may do anything with it
+    if (expr->type == AST_EMBED) writes->isWritten = true;
+
+    return !writes->isWritten;
 }
 
-static void emitBinary(Transpiler *t, BinaryExpr binary) {
-    if (binary.operator == OP_AS_CAST) {
-        emitLeftParen(t);
-        emit(t, mapPrimitiveTypeToC(binary.right->asIdentifier.name));
-        emitRightParen(t);
-        emitExpr(t, binary.left);
-    } else {
-        emitExpr(t, binary.left);
-        emit(t, mapOperatorType(binary.operator));
-        emitExpr(t, binary.right);
+// a parameter is passed as 'const T *restrict' when the function only ever reads it
+//
+// the caller's copy is then shared rather than copied, which is only the same when nothing can write to it
+// during the call, the caller may pass it again through a pointer or it may be global, so the function
+// must not write anything but its own locals
+static bool isParameterByReference(Transpiler *t, FunctionDeclaration function, int index) {
+    if (!hasPrivateAbi(t, function) || !isLargeStruct(t, function.parameters[index].type)) return false;
+    if (!function.writesOnlyLocals) return false;
+
+    ParameterWrites writes = { function.parameters[index].name, false };
+    for (int i = 0; i < function.block.count && !writes.isWritten; i++) {
+        walkExpr(function.block.body[i], parameterWriteVisitor, &writes);
     }
+
+    return !writes.isWritten;
 }
 
-static void emitCallExpr(Transpiler *t, CallExpr call) {
-    emit(t, call.name);
+// the return type and parameters, a struct returned by reference is written through '__ret' instead
+static void emitSignature(Transpiler *t, FunctionDeclaration function) {
+    bool isReturnByReference = returnsByReference(t, function);
+
+    if (isReturnByReference) {
+        emit(t, "void ");
+    } else {
+        emitTypeExpression(t, function.returnType);
+    }
+    emit(t, function.name);
 
     emitLeftParen(t);
-    for (int i = 0; i < call.argCount; i++) {
-        emitExpr(t, call.arguments[i]);
-        
-        if (i != call.argCount - 1) {
+
+    if (isReturnByReference) {
+        emitTypeExpression(t, function.returnType);
+        emit(t, "*restrict __ret");
+        if (function.paramCount) emit(t, ", ");
+    }
+
+    for (int i = 0; i < function.paramCount; i++) {
+        if (isParameterByReference(t, function, i)) emit(t, "const ");
+        emitTypeExpression(t, function.parameters[i].type);
+        if (isParameterByReference(t, function, i)) emit(t, "*restrict ");
+        if (hasTag(function.parameters[i].tags, TAG_NOALIAS)) emit(t, "restrict ");
+        emit(t, function.parameters[i].name);
+        emitArrayLength(t, function.parameters[i].type);
+
+        if (i != function.paramCount - 1) {
             emitComma(t);
             emitSpace(t);
         }
     }
+
     emitRightParen(t);
+}
 
-    if (!t->isEmittingExpression) {
-        emitSemicolon(t);
+static bool isVoidType(TypeExpr type);
+
+// the value a function with defers returns is kept here until they have run
+static void emitEpilogueStart(Transpiler *t, FunctionDeclaration function) {
+    if (t->isReturningByReference || isVoidType(function.returnType)) return;
+
+    emitTypeExpression(t, function.returnType);
+    emit(t, "__return_value;");
+    emitNewline(t);
+}
+
+// a function's defers run once at its end, in reverse, and a return jumps to the label after the last
+// defer registered where it is, so every path out shares the one copy of each defer
+static void emitEpilogue(Transpiler *t, FunctionDeclaration function) {
+    DeferScope scope = t->deferScopes[t->functionScope];
+
+    // a return has already waited before jumping to its label
+    if (t->hasSpawns) emitTaskWait(t);
+
+    for (int i = scope.count; i >= 0; i--) {
+        fprintf(t->fptr, "__defer%d: __attribute__((unused));", i);
+        emitNewline(t);
+
+        if (i > 0) emitExpr(t, scope.defers[i - 1]->asDefer.statement);
+    }
+
+    if (!t->isReturningByReference && !isVoidType(function.returnType)) {
+        emit(t, "return __return_value;");
+        emitNewline(t);
     }
 }
 
-static void emitMatchExpression(Transpiler *t, MatchExpr match) {
-    emit(t, "switch");
-    emitSpace(t);
+// spawned tasks are counted down as they finish, and the function waits for the count to reach zero
+static void emitTaskCounter(Transpiler *t) {
+    emit(t, "atomic_size_t __spawned = 0;");
+    emitNewline(t);
+}
 
-    emitLeftParen(t);
-    emitExpr(t, match.expression);
-    emitRightParen(t);
-    emitSpace(t);
+// a function returning a fixed array only runs at compile time, every call to it has been replaced
+static bool isEmittedFunction(FunctionDeclaration function) {
+    return function.isReachable && !function.returnType.arrayLength;
+}
+
+static void emitFunctionDeclaration(Transpiler *t, FunctionDeclaration function) {
+    if (!isEmittedFunction(function)) return;
 
+    emitNewline(t);
+
+    emitFunctionSpecifiers(t, function, true);
+    emitSignature(t, function);
+
+    emitSpace(t);
     emitLeftBrace(t);
     emitNewline(t);
 
-    for (int i = 0; i < match.caseCount; i++) {
-        if (match.cases[i].isElseCase) {
-            emit(t, "default");
-            emit(t, ":");
-            emitNewline(t); 
+    FunctionDeclaration *enclosingFunction = t->currentFunction;
+    bool *enclosingByReference = t->byReference;
+    bool wasReturningByReference = t->isReturningByReference;
 
-            if (match.cases[i].expression->type == AST_BLOCK) {
-                for (int j = 0; j < match.cases[i].expression->asBlock.count; j++) {
-                    emitExpr(t, match.cases[i].expression->asBlock.body[j]);
-                }
-            } else {
-                emitExpr(t, match.cases[i].expression);
-            }
+    t->currentFunction = &function;
+    t->byReference = malloc(sizeof(bool) * (function.paramCount + 1));
+    for (int i = 0; i < function.paramCount; i++) {
+        t->byReference[i] = isParameterByReference(t, function, i);
+    }
+    t->isReturningByReference = returnsByReference(t, function);
 
-            emit(t, "break");
-            emitSemicolon(t);
+    int enclosingFunctionScope = t->functionScope;
+    int enclosingLoopScope = t->loopScope;
+    bool hadDefers = t->hasDefers;
+    bool hadSpawns = t->hasSpawns;
 
-            emitNewline(t);
-            continue;
-        }
+    t->functionScope = t->deferScopeCount;
+    t->loopScope = -1;
+    t->hasDefers = false;
+    t->hasSpawns = false;
 
-        emit(t, "case");
-        emitSpace(t);
-        emitExpr(t, match.cases[i].pattern);
+    if (!function.isLambda) {
+        for (int i = 0; i < function.block.count && !t->hasDefers; i++) {
+            walkExpr(function.block.body[i], deferVisitor, &t->hasDefers);
+        }
+        for (int i = 0; i < function.block.count && !t->hasSpawns; i++) {
+            walkExpr(function.block.body[i], spawnVisitor, &t->hasSpawns);
+        }
+        if (t->hasSpawns) t->hasDefers = true;
 
-        emit(t, ":");
-        emitNewline(t);
+        if (t->hasDefers) emitEpilogueStart(t, function);
+        if (t->hasSpawns) emitTaskCounter(t);
 
-        if (match.cases[i].expression->type == AST_BLOCK) {
-            for (int j = 0; j < match.cases[i].expression->asBlock.count; j++) {
-                emitExpr(t, match.cases[i].expression->asBlock.body[j]);
+        pushDeferScope(t);
+        for (int i = 0; i < function.block.count; i++) {
+            if (function.block.body[i]->type == AST_DEFER_STATEMENT) {
+                registerDefer(t, function.block.body[i]);
+                continue;
             }
-        } else {
-            emitExpr(t, match.cases[i].expression);
+
+            emitExpr(t, function.block.body[i]);
         }
 
-        emit(t, "break");
+        if (t->hasDefers) emitEpilogue(t, function);
+        popDeferScope(t);
+    } else {
+        emit(t, "return");
+        emitSpace(t);
+        emitExpr(t, function.lambdaExpr);
+        
         emitSemicolon(t);
-
         emitNewline(t);
     }
 
+    t->functionScope = enclosingFunctionScope;
+    t->loopScope = enclosingLoopScope;
+    t->hasDefers = hadDefers;
+    t->hasSpawns = hadSpawns;
+
+    free(t->byReference);
+
+    t->currentFunction = enclosingFunction;
+    t->byReference = enclosingByReference;
+    t->isReturningByReference = wasReturningByReference;
+
     emitRightBrace(t);
     emitNewline(t);
 }
 
-static void emitEnumDeclaration(Transpiler *t, EnumDeclaration enumDeclaration) {
-    emit(t, "enum");
-    emitSpace(t);
+// a table is only worth building with a few cases, below this the switch is as good
+#define MATCH_TABLE_MIN_CASES 3
 
-    emit(t, enumDeclaration.name);
-    emitSpace(t);
+// dense tables are indexed directly, they may be up to half holes before a sorted table is used
+#define MATCH_TABLE_MAX_RANGE 4096
 
-    emitLeftBrace(t);
-    emitNewline(t);
-    
-    for (int i = 0; i < enumDeclaration.valueCount; i++) {
-        emit(t, enumDeclaration.values[i]);
-        emitComma(t);
-        emitNewline(t);
+typedef struct {
+    long long key;
+    AstExpr  *value;
+} MatchTableEntry;
+
+typedef struct {
+    MatchTableEntry *entries;
+    int              count;
+
+    // the else case, or null when unmatched subjects are left undefined like a switch would
+    AstExpr         *fallback;
+
+    bool             isDense;
+    long long        min;
+    long long        range;
+} MatchTable;
+
+// the position of an enum value, which is also its value as enumerators are never assigned
+//
+// the value is looked for in 'enumName' when it is known, otherwise it must belong to just one enum
+static bool findEnumValue(Ast ast, char *enumName, char *name, long long *index) {
+    bool isFound = false;
+
+    for (int i = 0; i < ast.exprCount; i++) {
+        if (ast.exprs[i]->type != AST_ENUM) continue;
+
+        EnumDeclaration enumeration = ast.exprs[i]->asEnum;
+        if (enumName && strcmp(enumeration.name, enumName) != 0) continue;
+
+        for (int j = 0; j < enumeration.valueCount; j++) {
+            if (strcmp(enumeration.values[j], name) != 0) continue;
+            if (isFound) return false;
+
+            *index = j;
+            isFound = true;
+        }
     }
 
-    emitRightBrace(t);
-    emitSemicolon(t);
+    return isFound;
 }
 
-static void emitGrouping(Transpiler *t, GroupingExpression groupExpression) {
-    emitLeftParen(t);
-    emitExpr(t, groupExpression.expression);
-    emitRightParen(t);
+static bool matchKey(Transpiler *t, MatchExpr match, AstExpr *pattern, long long *key) {
+    if (pattern->type == AST_IDENTIFIER) return findEnumValue(t->ast, match.enumName, pattern->asIdentifier.name, key);
+
+    ConstValue value = evaluateConstant(pattern);
+    if (!value.isConstant) return false;
+
+    *key = constantAsSigned(value);
+    return true;
 }
 
-static void emitPropertyAccess(Transpiler *t, PropertyAccessExpr property) {
-    emitExpr(t, property.object);
-    emit(t, ".");
-    emit(t, property.property);
+// whether 'value' can go in a static initializer
+static bool isTableValue(Transpiler *t, AstExpr *value) {
+    long long index;
+
+    switch (value->type) {
+        case AST_FLOAT_LITERAL:
+        case AST_STRING_LITERAL: {
+            return true;
+        }
+        case AST_IDENTIFIER: {
+            return findEnumValue(t->ast, NULL, value->asIdentifier.name, &index);
+        }
+        default: {
+            return evaluateConstant(value).isConstant;
+        }
+    }
 }
 
-static void emitStructField(Transpiler *t, StructField field) {
-    emitTypeExpression(t, field.type);
-    emit(t, field.name);
+static int compareTableEntries(const void *a, const void *b) {
+    long long left = ((const MatchTableEntry *)a)->key;
+    long long right = ((const MatchTableEntry *)b)->key;
 
-    emitSemicolon(t);
+    return (left > right) - (left < right);
 }
 
-static void emitStructInit(Transpiler *t, StructInitializer structInit) {
-    emitLeftBrace(t);
-    emitNewline(t);
+// sorts the cases of 'match' by their constant pattern, the else case becomes the fallback
+static bool collectMatchKeys(Transpiler *t, MatchExpr match, MatchTable *table) {
+    table->entries = malloc(sizeof(MatchTableEntry) * (match.caseCount + 1));
+    table->count = 0;
+    table->fallback = NULL;
 
-    for (int i = 0; i < structInit.fieldCount; i++) {
-        emit(t, ".");
-        emit(t, structInit.fields[i].name);
-        
-        emitSpace(t);
-        emit(t, "=");
-        emitSpace(t);
-        emitExpr(t, structInit.fields[i].value);
-        emitComma(t);
-        emitNewline(t);
+    for (int i = 0; i < match.caseCount; i++) {
+        MatchCaseExpr matchCase = match.cases[i];
+
+        if (matchCase.isElseCase) {
+            table->fallback = matchCase.expression;
+            continue;
+        }
+
+        MatchTableEntry entry = { 0, matchCase.expression };
+        if (!matchKey(t, match, matchCase.pattern, &entry.key)) goto fail;
+
+        table->entries[table->count++] = entry;
     }
 
-    emitRightBrace(t);
-}
+    if (table->count == 0) goto fail;
 
-static void emitDeferStatement(Transpiler *t, DeferStatement defer) {
-    emitExpr(t, defer.statement);
-}
+    qsort(table->entries, table->count, sizeof(MatchTableEntry), compareTableEntries);
 
-static void emitEmbed(Transpiler *t, EmbedStatement embed) {
-    emit(t, embed.embedSource);
+    // duplicate cases would not compile as a switch either, leave the error to the C compiler
+    for (int i = 1; i < table->count; i++) {
+        if (table->entries[i].key == table->entries[i - 1].key) goto fail;
+    }
+
+    table->min = table->entries[0].key;
+
+    unsigned long long range = (unsigned long long)table->entries[table->count - 1].key - (unsigned long long)table->min + 1;
+    table->isDense = range <= MATCH_TABLE_MAX_RANGE && range <= (unsigned long long)table->count * 2;
+    table->range = table->isDense ? (long long)range : table->count;
+
+    return true;
+
+fail:
+    free(table->entries);
+    return false;
 }
 
-static void emitExpr(Transpiler *t, AstExpr *expr) {
+// a match can become a table lookup when every pattern and every result is a constant
+static bool buildMatchTable(Transpiler *t, MatchExpr match, MatchTable *table) {
+    // the switch keeps the '__builtin_expect' hint on the first case
+    if (hasTag(match.tags, TAG_LIKELY)) return false;
+
+    for (int i = 0; i < match.caseCount; i++) {
+        if (!isTableValue(t, match.cases[i].expression)) return false;
+    }
+
+    if (!collectMatchKeys(t, match, table)) return false;
+
+    if (table->count < MATCH_TABLE_MIN_CASES) {
+        free(table->entries);
+        return false;
+    }
+
+    return true;
+}
+
+static void emitTableValue(Transpiler *t, AstExpr *value) {
+    if (value) {
+        emitValue(t, value);
+    } else {
+        emit(t, "0");
+    }
+}
+
+static void emitTableKey(Transpiler *t, long long key) {
+    char buffer[32];
+
+    // LLONG_MIN has no literal of its own
+    if (key == LLONG_MIN) {
+        emit(t, "(-9223372036854775807LL - 1)");
+        return;
+    }
+
+    snprintf(buffer, sizeof(buffer), "%lldLL", key);
+    emit(t, buffer);
+}
+
+// emits the lookup for 'match' as a block which overwrites 'result' when the subject has an entry,
+// 'result' must already hold the fallback value
+//
+// dense keys index a table directly, sparse keys are binary searched in a sorted table
+static void emitMatchTableLookup(Transpiler *t, MatchExpr match, MatchTable table, TypeExpr type, char *result) {
+    char name[32];
+    snprintf(name, sizeof(name), "__match%d", t->uniqueCount++);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    // 'const' after the type so a pointer table is itself read only without changing what it points to
+    emit(t, "static ");
+    emitTypeExpression(t, type);
+    fprintf(t->fptr, "const %s_values[%lld] = {", name, table.range);
+
+    int entry = 0;
+    for (long long i = 0; i < table.range; i++) {
+        if (!table.isDense || table.entries[entry].key == table.min + i) {
+            emitTableValue(t, table.entries[entry++].value);
+        } else {
+            emitTableValue(t, table.fallback);
+        }
+        emitComma(t);
+    }
+
+    emit(t, "};");
+    emitNewline(t);
+
+    fprintf(t->fptr, "long long %s_key = (long long)(", name);
+    emitValue(t, match.expression);
+    emit(t, ");");
+    emitNewline(t);
+
+    if (table.isDense) {
+        fprintf(t->fptr, "unsigned long long %s_index = (unsigned long long)%s_key - (unsigned long long)", name, name);
+        emitTableKey(t, table.min);
+        emitSemicolon(t);
+        emitNewline(t);
+
+        fprintf(t->fptr, "if (%s_index < %lld) %s = %s_values[%s_index];", name, table.range, result, name, name);
+        emitNewline(t);
+    } else {
+        fprintf(t->fptr, "static const long long %s_keys[%lld] = {", name, table.range);
+        for (int i = 0; i < table.count; i++) {
+            emitTableKey(t, table.entries[i].key);
+            emitComma(t);
+        }
+        emit(t, "};");
+        emitNewline(t);
+
+        fprintf(t->fptr, "int %s_low = 0, %s_high = %lld;", name, name, table.range);
+        emitNewline(t);
+
+        fprintf(t->fptr, "while (%s_low < %s_high) {", name, name);
+        emitNewline(t);
+        fprintf(t->fptr, "int %s_middle = %s_low + (%s_high - %s_low) / 2;", name, name, name, name);
+        emitNewline(t);
+        fprintf(t->fptr, "if (%s_keys[%s_middle] < %s_key) %s_low = %s_middle + 1; else %s_high = %s_middle;",
+            name, name, name, name, name, name, name);
+        emitNewline(t);
+        emitRightBrace(t);
+        emitNewline(t);
+
+        fprintf(t->fptr, "if (%s_low < %lld && %s_keys[%s_low] == %s_key) %s = %s_values[%s_low];",
+            name, table.range, name, name, name, result, name, name);
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+// stores the result and jumps to the epilogue, running the defers of the blocks being left on the way
+static void emitDeferredReturn(Transpiler *t, AstExpr *value, char *name) {
+    AstExpr *callee = value && value->type == AST_CALL_EXPR ? findFunction(t->ast, value->asCallExpr.name) : NULL;
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    if (t->isReturningByReference && callee && returnsByReference(t, callee->asFunction)) {
+        emitCallInto(t, value->asCallExpr, callee, "*__ret");
+    } else {
+        emit(t, t->isReturningByReference ? "*__ret = " : "__return_value = ");
+        if (value) emitValue(t, value);
+        else emit(t, name);
+    }
+    emitSemicolon(t);
+    emitNewline(t);
+
+    // the tasks may still be writing to the function's variables
+    if (t->hasSpawns) emitTaskWait(t);
+
+    emitScopeExit(t, t->functionScope + 1);
+
+    fprintf(t->fptr, "goto __defer%d;", t->deferScopes[t->functionScope].count);
+    emitNewline(t);
+    emitRightBrace(t);
+}
+
+static bool emitReturnMatchTable(Transpiler *t, MatchExpr match) {
+    if (!t->currentFunction) return false;
+
+    MatchTable table;
+    if (!buildMatchTable(t, match, &table)) return false;
+
+    TypeExpr type = t->currentFunction->returnType;
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    emitTypeExpression(t, type);
+    emit(t, "__result = ");
+    emitTableValue(t, table.fallback);
+    emitSemicolon(t);
+    emitNewline(t);
+
+    emitMatchTableLookup(t, match, table, type, "__result");
+
+    if (t->hasDefers) {
+        emitDeferredReturn(t, NULL, "__result");
+    } else {
+        emit(t, "return __result;");
+    }
+    emitNewline(t);
+
+    emitRightBrace(t);
+    emitNewline(t);
+
+    free(table.entries);
+    return true;
+}
+
+// a struct returned by reference is written to the caller's variable
+static void emitReturnValue(Transpiler *t, AstExpr *value) {
+    if (t->hasDefers) {
+        emitDeferredReturn(t, value, NULL);
+        return;
+    }
+
+    AstExpr *callee = value->type == AST_CALL_EXPR ? findFunction(t->ast, value->asCallExpr.name) : NULL;
+
+    // returning what another function returns by reference passes it the same '__ret'
+    if (t->isReturningByReference && callee && returnsByReference(t, callee->asFunction)) {
+        emit(t, "{ ");
+        emitCallInto(t, value->asCallExpr, callee, "*__ret");
+        emit(t, "; return; }");
+        return;
+    }
+
+    if (t->isReturningByReference) {
+        emit(t, "{ *__ret = ");
+        emitValue(t, value);
+        emit(t, "; return; }");
+        return;
+    }
+
+    emit(t, "return");
+    emitSpace(t);
+    emitValue(t, value);
+    emitSemicolon(t);
+}
+
+static void emitReturnMatch(Transpiler *t, MatchExpr match) {
+    if (emitReturnMatchTable(t, match)) return;
+
+    emit(t, "switch");
+    emitSpace(t);
+
+    emitLeftParen(t);
+    emitMatchSubject(t, match);
+    emitRightParen(t);
+    emitSpace(t);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    for (int i = 0; i < match.caseCount; i++) {
+        if (match.cases[i].isElseCase) {
+            emit(t, "default");
+            emit(t, ":");
+            emitNewline(t);
+
+            emitReturnValue(t, match.cases[i].expression);
+            continue;
+        }
+
+        emit(t, "case");
+        emitSpace(t);
+        emitExpr(t, match.cases[i].pattern);
+
+        emit(t, ":");
+        emitNewline(t);
+
+        emitReturnValue(t, match.cases[i].expression);
+
+        emitNewline(t);
+        emit(t, "break");
+        emitSemicolon(t);
+
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitReturnStatement(Transpiler *t, ReturnStatement returnStatement) {
+    if (returnStatement.value->type == AST_MATCH) {
+        emitReturnMatch(t, returnStatement.value->asMatch);
+        return;
+    }
+
+    emitReturnValue(t, returnStatement.value);
+    emitNewline(t);
+}
+
+static bool containsNextVisitor(AstExpr *expr, void *context) {
+    bool *found = context;
+    if (expr->type == AST_NEXT) *found = true;
+
+    // a 'next' in a nested loop belongs to that loop
+    return !*found && expr->type != AST_WHILE && expr->type != AST_FOR;
+}
+
+static bool containsNext(BlockExpr block) {
+    bool found = false;
+    for (int i = 0; i < block.count && !found; i++) {
+        walkExpr(block.body[i], containsNextVisitor, &found);
+    }
+
+    return found;
+}
+
+static void emitWhileLoop(Transpiler *t, WhileStatement whileStatement) {
+    // OpenMP only works on counted loops, a while loop can only promise GCC its iterations are independent
+    if (hasTag(whileStatement.tags, TAG_SIMD)) emit(t, "\n#pragma GCC ivdep\n");
+
+    emit(t, "while");
+    emitSpace(t);
+
+    emitLeftParen(t);
+    emitCondition(t, whileStatement.condition, whileStatement.tags);
+    emitRightParen(t);
+
+    emitSpace(t);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    int enclosingLoopScope = t->loopScope;
+    int enclosingNextLabel = t->nextLabel;
+    t->loopScope = t->deferScopeCount;
+
+    bool needsNextLabel = whileStatement.alteration && t->dispatchLoop == -1 && containsNext(whileStatement.block);
+    t->nextLabel = needsNextLabel ? t->uniqueCount++ : -1;
+
+    emitScope(t, whileStatement.block);
+
+    int nextLabel = t->nextLabel;
+    t->loopScope = enclosingLoopScope;
+    t->nextLabel = enclosingNextLabel;
+
+    // 'next' jumps here so the alteration still runs
+    if (nextLabel != -1) fprintf(t->fptr, "__next%d:;\n", nextLabel);
+    if (t->dispatchLoop != -1) fprintf(t->fptr, "__dispatch%d_next:;\n", t->dispatchLoop);
+
+    if (whileStatement.alteration) emitExpr(t, whileStatement.alteration);
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitMatchCaseBody(Transpiler *t, AstExpr *expression) {
+    if (expression->type != AST_BLOCK) {
+        emitExpr(t, expression);
+        return;
+    }
+
+    emitScope(t, expression->asBlock);
+}
+
+// checks the loop condition and jumps straight to the label of the next case
+static void emitDispatch(Transpiler *t, WhileStatement whileStatement, MatchExpr match, int loop, long long min, long long span) {
+    emit(t, "if (!(");
+    emitCondition(t, whileStatement.condition, whileStatement.tags);
+    fprintf(t->fptr, ")) goto __dispatch%d_end;", loop);
+    emitNewline(t);
+
+    fprintf(t->fptr, "__dispatch%d_index = (unsigned long long)(long long)(", loop);
+    emitValue(t, match.expression);
+    emit(t, ") - (unsigned long long)");
+    emitTableKey(t, min);
+    emitSemicolon(t);
+    emitNewline(t);
+
+    fprintf(t->fptr, "goto *(__dispatch%d_index < %lld ? __dispatch%d_labels[__dispatch%d_index] : &&__dispatch%d_else);",
+        loop, span, loop, loop, loop);
+    emitNewline(t);
+}
+
+// direct threading: every case ends with its own indirect jump to the next case, rather than all
+// of them sharing the one jump of a switch, so the branch predictor can learn which case follows which
+//
+// labels as values are a GNU extension, other compilers get the plain loop and switch
+static bool emitDispatchLoop(Transpiler *t, WhileStatement whileStatement) {
+    MatchExpr match = whileStatement.block.body[0]->asMatch;
+
+    MatchTable table;
+    if (!collectMatchKeys(t, match, &table)) return false;
+
+    unsigned long long span = (unsigned long long)table.entries[table.count - 1].key - (unsigned long long)table.min + 1;
+    if (span > MATCH_TABLE_MAX_RANGE) {
+        free(table.entries);
+        return false;
+    }
+
+    int loop = t->uniqueCount++;
+
+    int enclosingLoop = t->dispatchLoop;
+    t->dispatchLoop = loop;
+
+    emit(t, "\n#if defined(__GNUC__)\n");
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    fprintf(t->fptr, "static void *const __dispatch%d_labels[%llu] = {", loop, span);
+
+    int entry = 0;
+    for (unsigned long long i = 0; i < span; i++) {
+        if (table.entries[entry].key == table.min + (long long)i) {
+            fprintf(t->fptr, "&&__dispatch%d_case%d,", loop, entry++);
+        } else {
+            fprintf(t->fptr, "&&__dispatch%d_else,", loop);
+        }
+    }
+
+    emit(t, "};");
+    emitNewline(t);
+
+    fprintf(t->fptr, "unsigned long long __dispatch%d_index;", loop);
+    emitNewline(t);
+
+    // 'next' runs the alteration before dispatching again, the first dispatch skips it
+    if (whileStatement.alteration) {
+        fprintf(t->fptr, "goto __dispatch%d_first;", loop);
+        emitNewline(t);
+        fprintf(t->fptr, "__dispatch%d_next:", loop);
+        emitNewline(t);
+        emitExpr(t, whileStatement.alteration);
+        fprintf(t->fptr, "__dispatch%d_first:", loop);
+    } else {
+        fprintf(t->fptr, "__dispatch%d_next:", loop);
+    }
+    emitNewline(t);
+    emitDispatch(t, whileStatement, match, loop, table.min, span);
+
+    for (int i = 0; i <= table.count; i++) {
+        if (i < table.count) {
+            fprintf(t->fptr, "__dispatch%d_case%d:", loop, i);
+        } else {
+            fprintf(t->fptr, "__dispatch%d_else:", loop);
+        }
+        emitNewline(t);
+
+        emitLeftBrace(t);
+        emitNewline(t);
+
+        // a case is the loop body, 'stop' and 'next' leave through its defers
+        int enclosingLoopScope = t->loopScope;
+        t->loopScope = t->deferScopeCount;
+
+        AstExpr *expression = i < table.count ? table.entries[i].value : table.fallback;
+        if (expression) emitMatchCaseBody(t, expression);
+
+        t->loopScope = enclosingLoopScope;
+
+        emitRightBrace(t);
+        emitNewline(t);
+
+        if (whileStatement.alteration) emitExpr(t, whileStatement.alteration);
+        emitDispatch(t, whileStatement, match, loop, table.min, span);
+    }
+
+    emitRightBrace(t);
+
+    emit(t, "\n#else\n");
+    emitWhileLoop(t, whileStatement);
+    emit(t, "#endif\n");
+
+    fprintf(t->fptr, "__dispatch%d_end:;", loop);
+    emitNewline(t);
+
+    t->dispatchLoop = enclosingLoop;
+
+    free(table.entries);
+    return true;
+}
+
+static void emitWhileStatement(Transpiler *t, WhileStatement whileStatement) {
+    if (hasTag(whileStatement.tags, TAG_DISPATCH) && emitDispatchLoop(t, whileStatement)) return;
+
+    int enclosingLoop = t->dispatchLoop;
+    t->dispatchLoop = -1;
+
+    emitWhileLoop(t, whileStatement);
+
+    t->dispatchLoop = enclosingLoop;
+}
+
+// the type C gives to 'start + end', which holds both ends of the range
+static void emitRangeType(Transpiler *t, RangeExpr range) {
+    emit(t, "__typeof__((");
+    emitValue(t, range.start);
+    emit(t, ") + (");
+    emitValue(t, range.end);
+    emit(t, ")) ");
+}
+
+// without a type the loop variable takes the type of the range
+static void emitForVariableType(Transpiler *t, ForStatement forStatement) {
+    if (forStatement.type.name) {
+        emitTypeExpression(t, forStatement.type);
+        return;
+    }
+
+    emitRangeType(t, forStatement.iterator->asRange);
+}
+
+static void emitOpenMPPragma(Transpiler *t, ForStatement forStatement) {
+    bool isParallel = hasTag(forStatement.tags, TAG_PARALLEL);
+    bool isSimd = hasTag(forStatement.tags, TAG_SIMD);
+
+    emit(t, "#pragma omp");
+    if (isParallel) emit(t, " parallel for");
+    if (isSimd) emit(t, " simd");
+
+    for (int i = 0; i < forStatement.reductionCount; i++) {
+        LoopReduction reduction = forStatement.reductions[i];
+        fprintf(t->fptr, " reduction(%s:%s)", mapOperatorType(reduction.operator), reduction.name);
+    }
+    emitNewline(t);
+
+    if (isParallel) t->usesOpenMP = true;
+    else t->usesOpenMPSimd = true;
+}
+
+// the iterations left from 'start' to 'end' moving by 'magnitude' each time, or none when the range is empty
+//
+// the distance is taken in unsigned long long so neither overflow nor the sign of the variable's type matters
+static void emitRangeDistance(Transpiler *t, int loop, RangeExpr range, bool isDescending, char *magnitude) {
+    char *from = isDescending ? "end" : "start";
+    char *to = isDescending ? "start" : "end";
+
+    fprintf(t->fptr, "(__for%d_%s %s __for%d_%s ? ", loop, from, range.isInclusive ? "<=" : "<", loop, to);
+    fprintf(t->fptr, "((unsigned long long)__for%d_%s - (unsigned long long)__for%d_%s", loop, to, loop, from);
+    fprintf(t->fptr, "%s) / %s + 1 : 0)", range.isInclusive ? "" : " - 1", magnitude);
+}
+
+static void emitRangeTripCount(Transpiler *t, int loop, RangeExpr range, ConstValue step) {
+    fprintf(t->fptr, "unsigned long long __for%d_count = ", loop);
+
+    char magnitude[64];
+    if (!range.step) {
+        emitRangeDistance(t, loop, range, false, "1");
+    } else if (step.isConstant) {
+        int64_t value = constantAsSigned(step);
+        snprintf(magnitude, sizeof(magnitude), "%lluULL", value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value);
+        emitRangeDistance(t, loop, range, value < 0, magnitude);
+    } else {
+        // the direction is only known once the step has been evaluated
+        fprintf(t->fptr, "__for%d_step > 0 ? ", loop);
+        snprintf(magnitude, sizeof(magnitude), "(unsigned long long)__for%d_step", loop);
+        emitRangeDistance(t, loop, range, false, magnitude);
+
+        emit(t, " : ");
+        snprintf(magnitude, sizeof(magnitude), "(0ULL - (unsigned long long)__for%d_step)", loop);
+        emitRangeDistance(t, loop, range, true, magnitude);
+    }
+
+    emitSemicolon(t);
+    emitNewline(t);
+}
+
+// an exclusive range moving by one can never step past its end, so when the variable has the type of the
+// range it is compared against the end directly, which is the shape gcc's vectorizer and unroller look for
+//
+// any other range counts its iterations up front and works out the variable from the count,
+// so an inclusive end at the limit of the type, a step past the end or an end the variable's
+// own type cannot hold cannot wrap around
+// the end and step are evaluated once before the loop starts, and the step is kept signed
+// so its direction can be chosen at runtime
+static void emitForStatement(Transpiler *t, ForStatement forStatement) {
+    RangeExpr range = forStatement.iterator->asRange;
+    int loop = t->uniqueCount++;
+
+    ConstValue step = range.step ? evaluateConstant(range.step) : (ConstValue){ 0 };
+    bool isUnitStep = !range.step || (step.isConstant && (constantAsSigned(step) == 1 || constantAsSigned(step) == -1));
+    bool isDescending = step.isConstant && constantAsSigned(step) < 0;
+    bool isCounted = range.isInclusive || !isUnitStep || forStatement.type.name;
+
+    // OpenMP wants the loop in canonical form, declaring only the loop variable,
+    // so anything else is declared in a block around it
+    bool isWorkshared = hasTag(forStatement.tags, TAG_SIMD | TAG_PARALLEL);
+    bool hasPrelude = isWorkshared || isCounted;
+
+    if (hasPrelude) {
+        emitLeftBrace(t);
+        emitNewline(t);
+    }
+
+    if (isCounted) {
+        emitRangeType(t, range);
+        fprintf(t->fptr, "__for%d_start = ", loop);
+        emitValue(t, range.start);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    if (isCounted || isWorkshared) {
+        emitRangeType(t, range);
+        fprintf(t->fptr, "__for%d_end = ", loop);
+        emitValue(t, range.end);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    if (isCounted && range.step && !step.isConstant) {
+        fprintf(t->fptr, "long long __for%d_step = ", loop);
+        emitValue(t, range.step);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    if (isCounted) emitRangeTripCount(t, loop, range, step);
+
+    if (forStatement.unrollCount) {
+        fprintf(t->fptr, "\n#pragma GCC unroll %d\n", forStatement.unrollCount);
+    }
+
+    if (isWorkshared) emitOpenMPPragma(t, forStatement);
+
+    emit(t, "for");
+    emitSpace(t);
+    emitLeftParen(t);
+
+    if (isCounted) {
+        fprintf(t->fptr, "unsigned long long __for%d_i = 0; __for%d_i < __for%d_count; __for%d_i++", loop, loop, loop, loop);
+    } else {
+        emitForVariableType(t, forStatement);
+
+        emit(t, forStatement.variable);
+        emit(t, " = ");
+        emitValue(t, range.start);
+
+        if (!isWorkshared) {
+            fprintf(t->fptr, ", __for%d_end = ", loop);
+            emitValue(t, range.end);
+        }
+
+        emit(t, "; ");
+
+        emit(t, forStatement.variable);
+        emit(t, isDescending ? " > " : " < ");
+        fprintf(t->fptr, "__for%d_end; ", loop);
+
+        emit(t, forStatement.variable);
+        emit(t, isDescending ? "--" : "++");
+    }
+
+    emitRightParen(t);
+    emitSpace(t);
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    if (isCounted) {
+        emitForVariableType(t, forStatement);
+        emit(t, forStatement.variable);
+        fprintf(t->fptr, " = (__typeof__(__for%d_start))((unsigned long long)__for%d_start + __for%d_i * ", loop, loop, loop);
+
+        if (!range.step) {
+            emit(t, "1ULL");
+        } else if (step.isConstant) {
+            fprintf(t->fptr, "(unsigned long long)%lldLL", (long long)constantAsSigned(step));
+        } else {
+            fprintf(t->fptr, "(unsigned long long)__for%d_step", loop);
+        }
+
+        emitRightParen(t);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    int enclosingLoop = t->dispatchLoop;
+    int enclosingLoopScope = t->loopScope;
+    int enclosingNextLabel = t->nextLabel;
+    t->dispatchLoop = -1;
+    t->loopScope = t->deferScopeCount;
+    t->nextLabel = -1;
+
+    emitScope(t, forStatement.block);
+
+    t->dispatchLoop = enclosingLoop;
+    t->loopScope = enclosingLoopScope;
+    t->nextLabel = enclosingNextLabel;
+
+    emitRightBrace(t);
+    emitNewline(t);
+
+    if (hasPrelude) {
+        emitRightBrace(t);
+        emitNewline(t);
+    }
+}
+
+// block cases (x => { ... }) are not allowed for assignment, must be: x => <expr>
+static void emitLetMatchAssignment(Transpiler *t, LetDeclaration let, MatchExpr match) {
+    MatchTable table;
+    if (buildMatchTable(t, match, &table)) {
+        emitTypeExpression(t, let.type);
+        emit(t, let.name);
+        emit(t, " = ");
+        emitTableValue(t, table.fallback);
+        emitSemicolon(t);
+        emitNewline(t);
+
+        emitMatchTableLookup(t, match, table, let.type, let.name);
+
+        free(table.entries);
+        return;
+    }
+
+    emitTypeExpression(t, let.type);
+    emit(t, let.name);
+    emitSemicolon(t);
+    emitNewline(t);
+
+    emit(t, "switch");
+    emitSpace(t);
+
+    emitLeftParen(t);
+    emitMatchSubject(t, match);
+    emitRightParen(t);
+    emitSpace(t);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    for (int i = 0; i < match.caseCount; i++) {
+        if (match.cases[i].isElseCase) {
+            emit(t, "default");
+            emit(t, ":");
+            emitNewline(t); 
+
+            emit(t, let.name);
+            emit(t, "=");
+            emitExpr(t, match.cases[i].expression);
+            emitSemicolon(t);
+            emitNewline(t);
+
+            emit(t, "break");
+            emitSemicolon(t);
+
+            emitNewline(t);
+            continue;
+        }
+
+        emit(t, "case");
+        emitSpace(t);
+        emitExpr(t, match.cases[i].pattern);
+
+        emit(t, ":");
+        emitNewline(t);
+
+        emit(t, let.name);
+        emit(t, "=");
+        emitExpr(t, match.cases[i].expression);
+        emitSemicolon(t);
+
+        emitNewline(t);
+        emit(t, "break");
+        emitSemicolon(t);
+
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitSoaArrayLiteral(Transpiler *t, StructDeclaration *soa, ArrayLiteral array);
+
+static bool nameVisitor(AstExpr *expr, void *context) {
+    char **name = context;
+
+    if (*name && expr->type == AST_IDENTIFIER && strcmp(expr->asIdentifier.name, *name) == 0) *name = NULL;
+    return *name != NULL;
+}
+
+// whether 'name' is used anywhere in 'expr'
+static bool mentionsName(AstExpr *expr, char *name) {
+    walkExpr(expr, nameVisitor, &name);
+    return name == NULL;
+}
+
+static void emitLetDeclaration(Transpiler *t, LetDeclaration let) {
+    if (let.value->type == AST_CALL_EXPR && let.value->asCallExpr.isSpawned) {
+        emitTypeExpression(t, let.type);
+        emit(t, let.name);
+        emitSemicolon(t);
+        emitNewline(t);
+
+        emitSpawn(t, let.value->asCallExpr, let.name, &let.type);
+        return;
+    }
+
+    if (let.value->type == AST_MATCH) {
+        emitLetMatchAssignment(t, let, let.value->asMatch);
+        return;
+    }
+
+    StructDeclaration *soa = soaStructOf(t, let.type);
+    if (soa && let.value->type == AST_ARRAY_LITERAL) {
+        emitTypeExpression(t, let.type);
+        emit(t, let.name);
+        emit(t, " = ");
+        emitSoaArrayLiteral(t, soa, let.value->asArray);
+        emitSemicolon(t);
+        emitNewline(t);
+        return;
+    }
+
+    if (let.value->type == AST_CALL_EXPR && isLargeStruct(t, let.type) && !mentionsName(let.value, let.name)) {
+        AstExpr *callee = findFunction(t->ast, let.value->asCallExpr.name);
+
+        // the callee writes its result straight into the variable
+        if (callee && returnsByReference(t, callee->asFunction)) {
+            emitTypeExpression(t, let.type);
+            emit(t, let.name);
+            emitSemicolon(t);
+            emitNewline(t);
+
+            emitCallInto(t, let.value->asCallExpr, callee, let.name);
+            emitSemicolon(t);
+            emitNewline(t);
+            return;
+        }
+    }
+
+    emitTypeExpression(t, let.type);
+    emit(t, let.name);
+    emitArrayLength(t, let.type);
+
+    emitSpace(t);
+    emit(t, "=");
+    emitSpace(t);
+
+    emitValue(t, let.value);
+    emitSemicolon(t);
+    
+    emitNewline(t);
+}
+
+// the type itself is emitted ahead of the functions, see 'emitStructTypes'
+static void emitStructDeclaration(Transpiler *t, StructDeclaration structDeclaration) {
+    // an interface only declares signatures, its functions are emitted with 'emitInterfaceSupport'
+    if (structDeclaration.isInterface) return;
+
+    for (int i = 0; i < structDeclaration.memberCount; i++) {
+        if (structDeclaration.members[i]->type == AST_FUNCTION_DECLARATION) {
+            emitExpr(t, structDeclaration.members[i]);
+        }
+    }
+
+    emitNewline(t);
+}
+
+static void emitIfStatement(Transpiler *t, IfStatement ifStatement) {
+    emit(t, "if");
+    emitSpace(t);
+    emitLeftParen(t);
+    emitCondition(t, ifStatement.condition, ifStatement.tags);
+    emitRightParen(t);
+    emitSpace(t);
+
+    emitLeftBrace(t);
+        emitNewline(t);
+
+    emitScope(t, ifStatement.block);
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitSoaScatter(Transpiler *t, IndexExpr index, AstExpr *value);
+
+static void emitAssignExpression(Transpiler *t, AssignmentExpr assign) {
+    if (assign.value->type == AST_CALL_EXPR && assign.value->asCallExpr.isSpawned) {
+        AstExpr function = { .type = AST_FUNCTION_DECLARATION };
+        if (t->currentFunction) function.asFunction = *t->currentFunction;
+
+        TypeExpr type;
+        bool hasType = findSpawnResultType(t, t->currentFunction ? &function : NULL, assign.name, &type);
+        emitSpawn(t, assign.value->asCallExpr, assign.name, hasType ? &type : NULL);
+        return;
+    }
+
+    AstExpr *target = assign.target;
+    if (target && target->type == AST_INDEX && target->asIndex.index->type != AST_RANGE && soaStructOf(t, target->asIndex.objectType)) {
+        emitSoaScatter(t, target->asIndex, assign.value);
+        return;
+    }
+
+    for (int i = 0; i < assign.ptrDepth; i++) emitStar(t);
+
+    if (assign.target) {
+        emitValue(t, assign.target);
+    } else {
+        emit(t, assign.name);
+    }
+    emitSpace(t);
+    emit(t, "=");
+    emitSpace(t);
+
+    emitValue(t, assign.value);
+    emitSemicolon(t);
+    emitNewline(t);
+}
+
+static void emitIntegerLiteral(Transpiler *t, IntegerLiteralExpr integer) {
+    // folded values can be negative, parenthesised so they never merge with a preceding '-'
+    if (integer.value == LLONG_MIN) {
+        fprintf(t->fptr, "(-%lld-1)", LLONG_MAX);
+    } else if (integer.value < 0) {
+        fprintf(t->fptr, "(%lld)", integer.value);
+    } else {
+        fprintf(t->fptr, "%lld", integer.value);
+    }
+}
+
+static void emitFloatLiteral(Transpiler *t, FloatLiteralExpr floatLiteral) {
+    fprintf(t->fptr, "%f", floatLiteral.value);
+}
+
+static void emitStringLiteral(Transpiler *t, StringLiteralExpr string) {
+    fprintf(t->fptr, "%s", string.value);
+}
+
+static void emitCharLiteral(Transpiler *t, CharLiteralExpr charLiteral) {
+    fprintf(t->fptr, "\'%s\'", charLiteral.value);
+}
+
+static void emitBoolLiteral(Transpiler *t, BoolLiteralExpr boolLiteral) {
+    fprintf(t->fptr, "%s", boolLiteral.value ? "true" : "false");
+}
+
+static void emitIdentifier(Transpiler *t, IdentifierExpr identifier) {
+    // a parameter passed by reference is read through its pointer
+    if (t->currentFunction && t->byReference) {
+        for (int i = 0; i < t->currentFunction->paramCount; i++) {
+            if (t->byReference[i] && strcmp(t->currentFunction->parameters[i].name, identifier.name) == 0) {
+                fprintf(t->fptr, "(*%s)", identifier.name);
+                return;
+            }
+        }
+    }
+
+    emit(t, identifier.name);
+}
+
+static void emitTernary(Transpiler *t, TernaryExpression ternary) {
+    bool wasEmittingExpression = t->isEmittingExpression;
+    t->isEmittingExpression = true;
+
+    emitExpr(t, ternary.condition);
+    emit(t, " ? ");
+    emitExpr(t, ternary.trueExpr);
+    emit(t, " : ");
+    emitExpr(t, ternary.falseExpr);
+
+    t->isEmittingExpression = wasEmittingExpression;
+    if (!t->isEmittingExpression) {
+        emitSemicolon(t);
+    }
+}
+
+static void emitNext(Transpiler *t, NextStatement next) {
+    if (t->loopScope != -1) emitScopeExit(t, t->loopScope);
+
+    if (t->dispatchLoop != -1) {
+        fprintf(t->fptr, "goto __dispatch%d_next;", t->dispatchLoop);
+    } else if (t->nextLabel != -1) {
+        fprintf(t->fptr, "goto __next%d;", t->nextLabel);
+    } else {
+        emit(t, "continue;");
+    }
+    emitNewline(t);
+
+    // prevent compiler warning
+    if (next.dummy == ' ') return;
+}
+
+static void emitStop(Transpiler *t, StopStatement stop) {
+    if (t->loopScope != -1) emitScopeExit(t, t->loopScope);
+
+    // a 'break' inside the match would only leave the switch
+    if (t->dispatchLoop != -1) {
+        fprintf(t->fptr, "goto __dispatch%d_end;", t->dispatchLoop);
+    } else {
+        emit(t, "break;");
+    }
+    emitNewline(t);
+
+    // prevent compiler warning
+    if (stop.dummy == ' ') return;
+}
+
+static void emitUnary(Transpiler *t, UnaryExpr unary) {
+    if (unary.operator == OP_SIZEOF) {
+        emit(t, mapOperatorType(unary.operator));
+        emitLeftParen(t);
+        emitExpr(t, unary.right);
+        emitRightParen(t);
+    } else {
+        emit(t, mapOperatorType(unary.operator));
+        emitExpr(t, unary.right);
+    }
+}
+
+static void emitBinary(Transpiler *t, BinaryExpr binary) {
+    if (binary.operator == OP_AS_CAST) {
+        emitLeftParen(t);
+        emit(t, mapPrimitiveTypeToC(binary.right->asIdentifier.name));
+        emitRightParen(t);
+        emitExpr(t, binary.left);
+    } else {
+        emitExpr(t, binary.left);
+        emit(t, mapOperatorType(binary.operator));
+        emitExpr(t, binary.right);
+    }
+}
+
+// whether the address of a value can be taken, so it can be passed by reference without a copy
+static bool isAddressable(Transpiler *t, AstExpr *expr) {
+    switch (expr->type) {
+        case AST_IDENTIFIER: return true;
+        case AST_GROUPING: return isAddressable(t, expr->asGrouping.expression);
+        case AST_PROPERTY_ACCESS: return isAddressable(t, expr->asProperty.object);
+        case AST_UNARY: return expr->asUnary.operator == OP_DEREF;
+
+        // an element of an '@soa' array is gathered into a temporary
+        case AST_INDEX: return expr->asIndex.index->type != AST_RANGE && !soaStructOf(t, expr->asIndex.objectType);
+        default: return false;
+    }
+}
+
+// values which are not stored anywhere are passed as a one element compound literal, which lives to the end of the block
+static void emitReferenceArgument(Transpiler *t, AstExpr *argument, TypeExpr type) {
+    if (isAddressable(t, argument)) {
+        emit(t, "&(");
+        emitExpr(t, argument);
+        emit(t, ")");
+        return;
+    }
+
+    emitLeftParen(t);
+    emitTypeExpression(t, type);
+    emit(t, "[1]){ ");
+    emitExpr(t, argument);
+    emit(t, " }");
+}
+
+static void emitCallArguments(Transpiler *t, CallExpr call, AstExpr *callee) {
+    bool wasEmittingExpression = t->isEmittingExpression;
+    t->isEmittingExpression = true;
+
+    AtomicBuiltin atomic;
+    bool isAtomic = !callee && lookupAtomicBuiltin(call.name, &atomic);
+
+    for (int i = 0; i < call.argCount; i++) {
+        FunctionDeclaration *function = callee ? &callee->asFunction : NULL;
+
+        if (isAtomic && isOrderingArgument(atomic, i)) {
+            fprintf(t->fptr, "memory_order_%s", call.arguments[i]->asIdentifier.name);
+        } else if (function && i < function->paramCount && isParameterByReference(t, *function, i)) {
+            emitReferenceArgument(t, call.arguments[i], function->parameters[i].type);
+        } else {
+            emitExpr(t, call.arguments[i]);
+        }
+
+        if (i != call.argCount - 1) {
+            emitComma(t);
+            emitSpace(t);
+        }
+    }
+
+    t->isEmittingExpression = wasEmittingExpression;
+}
+
+// a call to a function returning by reference, writing its result to 'result'
+static void emitCallInto(Transpiler *t, CallExpr call, AstExpr *callee, char *result) {
+    fprintf(t->fptr, "%s(&%s", call.name, result);
+    if (call.argCount) emit(t, ", ");
+
+    emitCallArguments(t, call, callee);
+    emitRightParen(t);
+}
+
+static void emitCallExpr(Transpiler *t, CallExpr call) {
+    AstExpr *callee = findFunction(t->ast, call.name);
+
+    if (callee && returnsByReference(t, callee->asFunction)) {
+        char result[32];
+        snprintf(result, sizeof(result), "__ret%d", t->uniqueCount++);
+
+        emit(t, t->isEmittingExpression ? "({ " : "{ ");
+        emitTypeExpression(t, callee->asFunction.returnType);
+        emit(t, result);
+        emit(t, "; ");
+
+        emitCallInto(t, call, callee, result);
+
+        if (t->isEmittingExpression) {
+            fprintf(t->fptr, "; %s; })", result);
+        } else {
+            emit(t, "; }");
+        }
+        return;
+    }
+
+    AtomicBuiltin atomic;
+    emit(t, !callee && lookupAtomicBuiltin(call.name, &atomic) ? atomicBuiltinCName(atomic) : call.name);
+
+    emitLeftParen(t);
+    emitCallArguments(t, call, callee);
+    emitRightParen(t);
+
+    if (!t->isEmittingExpression) {
+        emitSemicolon(t);
+    }
+}
+
+static void emitMatchExpression(Transpiler *t, MatchExpr match) {
+    emit(t, "switch");
+    emitSpace(t);
+
+    emitLeftParen(t);
+    emitMatchSubject(t, match);
+    emitRightParen(t);
+    emitSpace(t);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    for (int i = 0; i < match.caseCount; i++) {
+        if (match.cases[i].isElseCase) {
+            emit(t, "default");
+            emit(t, ":");
+            emitNewline(t); 
+
+            if (match.cases[i].expression->type == AST_BLOCK) {
+                emitScope(t, match.cases[i].expression->asBlock);
+            } else {
+                emitExpr(t, match.cases[i].expression);
+            }
+
+            emit(t, "break");
+            emitSemicolon(t);
+
+            emitNewline(t);
+            continue;
+        }
+
+        emit(t, "case");
+        emitSpace(t);
+        emitExpr(t, match.cases[i].pattern);
+
+        emit(t, ":");
+        emitNewline(t);
+
+        if (match.cases[i].expression->type == AST_BLOCK) {
+            emitScope(t, match.cases[i].expression->asBlock);
+        } else {
+            emitExpr(t, match.cases[i].expression);
+        }
+
+        emit(t, "break");
+        emitSemicolon(t);
+
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitEnumDeclaration(Transpiler *t, EnumDeclaration enumDeclaration) {
+    if (!enumDeclaration.isReachable) return;
+
+    emit(t, "enum");
+    emitSpace(t);
+
+    emit(t, enumDeclaration.name);
+    emitSpace(t);
+
+    emitLeftBrace(t);
+    emitNewline(t);
+    
+    for (int i = 0; i < enumDeclaration.valueCount; i++) {
+        emit(t, enumDeclaration.values[i]);
+        emitComma(t);
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitSemicolon(t);
+}
+
+static void emitGrouping(Transpiler *t, GroupingExpression groupExpression) {
+    emitLeftParen(t);
+    emitExpr(t, groupExpression.expression);
+    emitRightParen(t);
+}
+
+static void emitIndexSubscript(Transpiler *t, IndexExpr index);
+
+static void emitPropertyAccess(Transpiler *t, PropertyAccessExpr property) {
+    // a field of one element of an '@soa' array is an element of that field's array
+    AstExpr *object = property.object;
+    if (object->type == AST_INDEX && object->asIndex.index->type != AST_RANGE && soaStructOf(t, object->asIndex.objectType)) {
+        emitValue(t, object->asIndex.object);
+        emit(t, ".");
+        emit(t, property.property);
+        emit(t, "[");
+        emitIndexSubscript(t, object->asIndex);
+        emit(t, "]");
+        return;
+    }
+
+    emitExpr(t, property.object);
+    emit(t, ".");
+    emit(t, property.property);
+}
+
+static void emitIndexLength(Transpiler *t, IndexExpr index) {
+    if (index.objectType.arrayLength) {
+        fprintf(t->fptr, "%d", index.objectType.arrayLength);
+        return;
+    }
+
+    emitValue(t, index.object);
+    emit(t, ".len");
+}
+
+static void emitIndexBase(Transpiler *t, IndexExpr index) {
+    emitValue(t, index.object);
+    if (index.objectType.isSlice) emit(t, ".ptr");
+}
+
+// 'object[start..end]' makes a slice over part of an array or another slice
+static void emitSliceOf(Transpiler *t, IndexExpr index, bool isChecked) {
+    RangeExpr range = index.index->asRange;
+    int slice = t->uniqueCount++;
+
+    fprintf(t->fptr, "({ long long __slice%d_start = (", slice);
+    emitValue(t, range.start);
+    fprintf(t->fptr, "), __slice%d_end = (", slice);
+    emitValue(t, range.end);
+    emit(t, range.isInclusive ? ") + 1; " : "); ");
+
+    if (isChecked) {
+        fprintf(t->fptr, "__aster_check_slice(__slice%d_start, __slice%d_end, ", slice, slice);
+        emitIndexLength(t, index);
+        emit(t, "); ");
+    }
+
+    emitLeftParen(t);
+    emitSliceTypeName(t, index.objectType);
+    emit(t, "){ ");
+
+    StructDeclaration *soa = soaStructOf(t, index.objectType);
+    if (soa) {
+        for (int i = 0; i < soa->memberCount; i++) {
+            if (soa->members[i]->type != AST_STRUCT_FIELD) continue;
+
+            emitValue(t, index.object);
+            fprintf(t->fptr, ".%s + __slice%d_start, ", soa->members[i]->asStructField.name, slice);
+        }
+    } else {
+        emitIndexBase(t, index);
+        fprintf(t->fptr, " + __slice%d_start, ", slice);
+    }
+
+    fprintf(t->fptr, "(size_t)(__slice%d_end - __slice%d_start) }; })", slice, slice);
+}
+
+// reading a whole element of an '@soa' array gathers its fields back into a struct
+static void emitSoaGather(Transpiler *t, StructDeclaration *soa, IndexExpr index) {
+    int element = t->uniqueCount++;
+
+    fprintf(t->fptr, "({ long long __soa%d = ", element);
+    emitIndexSubscript(t, index);
+    fprintf(t->fptr, "; (%s){ ", soa->name);
+
+    for (int i = 0; i < soa->memberCount; i++) {
+        if (soa->members[i]->type != AST_STRUCT_FIELD) continue;
+        char *field = soa->members[i]->asStructField.name;
+
+        fprintf(t->fptr, ".%s = ", field);
+        emitValue(t, index.object);
+        fprintf(t->fptr, ".%s[__soa%d], ", field, element);
+    }
+
+    emit(t, "}; })");
+}
+
+// and writing one scatters the struct across the field arrays
+static void emitSoaScatter(Transpiler *t, IndexExpr index, AstExpr *value) {
+    StructDeclaration *soa = soaStructOf(t, index.objectType);
+    int element = t->uniqueCount++;
+
+    fprintf(t->fptr, "{ %s __soa%d_value = ", soa->name, element);
+    emitValue(t, value);
+    fprintf(t->fptr, "; long long __soa%d = ", element);
+    emitIndexSubscript(t, index);
+    emit(t, "; ");
+
+    for (int i = 0; i < soa->memberCount; i++) {
+        if (soa->members[i]->type != AST_STRUCT_FIELD) continue;
+        char *field = soa->members[i]->asStructField.name;
+
+        emitValue(t, index.object);
+        fprintf(t->fptr, ".%s[__soa%d] = __soa%d_value.%s; ", field, element, element, field);
+    }
+
+    emit(t, "}");
+    emitNewline(t);
+}
+
+static void emitIndex(Transpiler *t, IndexExpr index) {
+    bool isChecked = !(t->isRelease && index.isProvenInBounds);
+
+    if (index.index->type == AST_RANGE) {
+        emitSliceOf(t, index, isChecked);
+        return;
+    }
+
+    StructDeclaration *soa = soaStructOf(t, index.objectType);
+    if (soa) {
+        emitSoaGather(t, soa, index);
+        return;
+    }
+
+    emitIndexBase(t, index);
+    emit(t, "[");
+    emitIndexSubscript(t, index);
+    emit(t, "]");
+}
+
+// the index itself, wrapped in a bounds check unless it was proven in bounds for a release build
+static void emitIndexSubscript(Transpiler *t, IndexExpr index) {
+    bool isChecked = !(t->isRelease && index.isProvenInBounds);
+
+    if (isChecked) {
+        emit(t, "__aster_check_index(");
+        emitValue(t, index.index);
+        emit(t, ", ");
+        emitIndexLength(t, index);
+        emit(t, ")");
+    } else {
+        emitValue(t, index.index);
+    }
+}
+
+static void emitArrayElements(Transpiler *t, ArrayLiteral array) {
+    emitLeftBrace(t);
+
+    for (int i = 0; i < array.elementCount; i++) {
+        emitValue(t, array.elements[i]);
+        if (i != array.elementCount - 1) emitComma(t);
+    }
+
+    emitRightBrace(t);
+}
+
+// a literal initialising a variable is a plain initializer, one passed as an argument is a compound literal
+// of the parameter's type, a pointer or slice parameter points into an unnamed array which lives until the
+// end of the enclosing block
+static void emitArrayLiteral(Transpiler *t, ArrayLiteral array) {
+    TypeExpr type = array.type;
+    if (!type.name) {
+        emitArrayElements(t, array);
+        return;
+    }
+
+    TypeExpr element = type;
+    element.isSlice = false;
+    if (type.ptrDepth && !type.isSlice) element.ptrDepth--;
+
+    if (type.isSlice) {
+        emitLeftParen(t);
+        emitSliceTypeName(t, element);
+        emit(t, "){ ");
+    }
+
+    emitLeftParen(t);
+    emitTypeExpression(t, element);
+    if (type.ptrDepth || type.isSlice) emit(t, "[]");
+    else emitArrayLength(t, type);
+    emitRightParen(t);
+
+    emitArrayElements(t, array);
+
+    if (type.isSlice) fprintf(t->fptr, ", %d }", array.elementCount);
+}
+
+static void emitStructField(Transpiler *t, StructField field) {
+    emitTypeExpression(t, field.type);
+    emit(t, field.name);
+    emitArrayLength(t, field.type);
+
+    emitSemicolon(t);
+}
+
+// a fixed array of an '@soa' struct is one struct holding an array per field
+static void emitSoaArrayType(Transpiler *t, StructDeclaration *soa, int length) {
+    emit(t, "struct { ");
+
+    for (int i = 0; i < soa->memberCount; i++) {
+        if (soa->members[i]->type != AST_STRUCT_FIELD) continue;
+        StructField field = soa->members[i]->asStructField;
+
+        emitTypeExpression(t, field.type);
+        fprintf(t->fptr, "%s[%d]; ", field.name, length);
+    }
+
+    emit(t, "}");
+}
+
+// '[a, b]' becomes '{ .x = { [0] = a.x, [1] = b.x }, ... }', fields a literal leaves out are zero
+static void emitSoaArrayLiteral(Transpiler *t, StructDeclaration *soa, ArrayLiteral array) {
+    emit(t, "{ ");
+
+    for (int i = 0; i < soa->memberCount; i++) {
+        if (soa->members[i]->type != AST_STRUCT_FIELD) continue;
+        char *field = soa->members[i]->asStructField.name;
+
+        fprintf(t->fptr, ".%s = { ", field);
+
+        for (int j = 0; j < array.elementCount; j++) {
+            AstExpr *element = array.elements[j];
+
+            if (element->type == AST_IDENTIFIER) {
+                fprintf(t->fptr, "[%d] = %s.%s, ", j, element->asIdentifier.name, field);
+                continue;
+            }
+
+            StructInitializer structInit = element->asStructInit;
+            for (int k = 0; k < structInit.fieldCount; k++) {
+                if (strcmp(structInit.fields[k].name, field) != 0) continue;
+
+                fprintf(t->fptr, "[%d] = ", j);
+                emitValue(t, structInit.fields[k].value);
+                emit(t, ", ");
+            }
+        }
+
+        emit(t, "}, ");
+    }
+
+    emit(t, "}");
+}
+
+static void emitStructInit(Transpiler *t, StructInitializer structInit) {
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    for (int i = 0; i < structInit.fieldCount; i++) {
+        emit(t, ".");
+        emit(t, structInit.fields[i].name);
+        
+        emitSpace(t);
+        emit(t, "=");
+        emitSpace(t);
+        emitExpr(t, structInit.fields[i].value);
+        emitComma(t);
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+}
+
+// the substituted body is cast back to the return type so the caller sees the same type as the call
+// temporaries are bound inside a gcc statement expression
+static void emitInlinedCall(Transpiler *t, InlinedCallExpr call) {
+    bool wasEmittingExpression = t->isEmittingExpression;
+    t->isEmittingExpression = true;
+
+    if (call.tempCount > 0) {
+        emit(t, "({");
+        emitNewline(t);
+
+        for (int i = 0; i < call.tempCount; i++) {
+            emitExpr(t, call.temps[i]);
+        }
+    }
+
+    emit(t, "((");
+    emitTypeExpression(t, call.returnType);
+    emit(t, ")(");
+    emitExpr(t, call.body);
+    emit(t, "))");
+
+    if (call.tempCount > 0) {
+        emitSemicolon(t);
+        emit(t, "})");
+    }
+
+    t->isEmittingExpression = wasEmittingExpression;
+    if (!t->isEmittingExpression) {
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+}
+
+// a block on its own, left behind when a match on a constant is collapsed
+static void emitBlock(Transpiler *t, BlockExpr block) {
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    emitScope(t, block);
+
+    emitRightBrace(t);
+    emitNewline(t);
+}
+
+static void emitDeferStatement(Transpiler *t, DeferStatement defer) {
+    emitExpr(t, defer.statement);
+}
+
+static void emitEmbed(Transpiler *t, EmbedStatement embed) {
+    emit(t, embed.embedSource);
+}
+
+static void emitExpr(Transpiler *t, AstExpr *expr) {
     switch (expr->type) {
         case AST_FUNCTION_DECLARATION: {
             emitFunctionDeclaration(t, expr->asFunction);
@@ -643,136 +2471,1160 @@ static void emitExpr(Transpiler *t, AstExpr *expr) {
             emitAssignExpression(t, expr->asAssign);
             break;
         }
-        case AST_DEFER_STATEMENT: {
-            emitDeferStatement(t, expr->asDefer);
-            break;
+        case AST_DEFER_STATEMENT: {
+            emitDeferStatement(t, expr->asDefer);
+            break;
+        }
+        case AST_IF: {
+            emitIfStatement(t, expr->asIf);
+            break;
+        }
+        case AST_NEXT: {
+            emitNext(t, expr->asNext);
+            break;
+        }
+        case AST_STOP: {
+            emitStop(t, expr->asStop);
+            break;
+        }
+        case AST_UNARY: {
+            emitUnary(t, expr->asUnary);
+            break;
+        }
+        case AST_BINARY: {
+            bool wasEmittingExpression = t->isEmittingExpression;
+
+            t->isEmittingExpression = true;
+            emitBinary(t, expr->asBinary);
+            t->isEmittingExpression = wasEmittingExpression;
+            break;
+        }
+        case AST_CALL_EXPR: {
+            if (expr->asCallExpr.isSpawned) {
+                emitSpawn(t, expr->asCallExpr, NULL, NULL);
+                break;
+            }
+
+            emitCallExpr(t, expr->asCallExpr);
+            break;
+        }
+        case AST_SYNC: {
+            emitTaskWait(t);
+            break;
+        }
+        case AST_INTEGER_LITERAL: {
+            emitIntegerLiteral(t, expr->asInteger);
+            break;
+        }
+        case AST_FLOAT_LITERAL: {
+            emitFloatLiteral(t, expr->asFloat);
+            break;
+        }
+        case AST_STRING_LITERAL: {
+            emitStringLiteral(t, expr->asString);
+            break;
+        }
+        case AST_CHAR_LITERAL: {
+            emitCharLiteral(t, expr->asChar);
+            break;
+        }
+        case AST_IDENTIFIER: {
+            emitIdentifier(t, expr->asIdentifier);
+            break;
+        }
+        case AST_BOOL_LITERAL: {
+            emitBoolLiteral(t, expr->asBool);
+            break;
+        }
+        case AST_TERNARY: {
+            emitTernary(t, expr->asTernary);
+            break;
+        }
+        case AST_GROUPING: {
+            emitGrouping(t, expr->asGrouping);
+            break;
+        }
+        case AST_PROPERTY_ACCESS: {
+            emitPropertyAccess(t, expr->asProperty);
+            break;
+        }
+        case AST_STRUCT_INITIALIZER: {
+            emitStructInit(t, expr->asStructInit);
+            break;
+        }
+        case AST_EMBED: {
+            emitEmbed(t, expr->asEmbed);
+            break;
+        }
+        case AST_INLINED_CALL: {
+            emitInlinedCall(t, expr->asInlinedCall);
+            break;
+        }
+        case AST_BLOCK: {
+            emitBlock(t, expr->asBlock);
+            break;
+        }
+        case AST_INDEX: {
+            emitIndex(t, expr->asIndex);
+            break;
+        }
+        case AST_ARRAY_LITERAL: {
+            emitArrayLiteral(t, expr->asArray);
+            break;
+        }
+        default: {
+            exitWithInternalCompilerError("unknown expression type in 'emitExpr'");
+        }
+    }
+}
+
+static void emitFunctionForwardDeclaration(Transpiler *t, FunctionDeclaration function) {
+    if (!isEmittedFunction(function)) return;
+
+    emitNewline(t);
+
+    emitFunctionSpecifiers(t, function, false);
+    emitSignature(t, function);
+    emitSemicolon(t);
+}
+
+static bool isVoidType(TypeExpr type) {
+    return type.ptrDepth == 0 && !type.arrayLength && !type.isSlice && strcmp(mapPrimitiveTypeToC(type.name), "void") == 0;
+}
+
+// the parameters of an interface function with 'self' as an untyped pointer, ', i32 a'
+static void emitInterfaceParameters(Transpiler *t, FunctionDeclaration function, bool withNames) {
+    emit(t, "void *self");
+
+    for (int i = 1; i < function.paramCount; i++) {
+        emitComma(t);
+        emitSpace(t);
+        emitTypeExpression(t, function.parameters[i].type);
+        if (withNames) emit(t, function.parameters[i].name);
+        emitArrayLength(t, function.parameters[i].type);
+    }
+}
+
+// an interface value is a pointer to the struct implementing it along with that struct's vtable
+static void emitInterfaceType(Transpiler *t, StructDeclaration interface) {
+    emit(t, "typedef struct {\n");
+
+    for (int i = 0; i < interface.memberCount; i++) {
+        if (interface.members[i]->type != AST_FUNCTION_DECLARATION) continue;
+        FunctionDeclaration function = interface.members[i]->asFunction;
+
+        emitTypeExpression(t, function.returnType);
+        fprintf(t->fptr, "(*%s)(", function.name);
+        emitInterfaceParameters(t, function, false);
+        emit(t, ");\n");
+    }
+
+    if (interface.memberCount == 0) emit(t, "char dummy;\n");
+
+    fprintf(t->fptr, "} __%s_vtable;\n", interface.name);
+    fprintf(t->fptr, "struct %s {\nvoid *self;\nconst __%s_vtable *vtable;\n};\n", interface.name, interface.name);
+}
+
+static void emitStructType(Transpiler *t, StructDeclaration structDeclaration) {
+    if (structDeclaration.isInterface) {
+        emitInterfaceType(t, structDeclaration);
+        return;
+    }
+
+    StructLayout layout = layoutStruct(t->ast, structDeclaration);
+
+    emit(t, "struct");
+    emitSpace(t);
+
+    int alignment = structDeclaration.alignment;
+    if (hasTag(structDeclaration.tags, TAG_CACHELINE) && alignment < CACHE_LINE_SIZE) alignment = CACHE_LINE_SIZE;
+
+    if (hasTag(structDeclaration.tags, TAG_PACKED) && alignment) {
+        fprintf(t->fptr, "__attribute__((packed, aligned(%d))) ", alignment);
+    } else if (hasTag(structDeclaration.tags, TAG_PACKED)) {
+        emit(t, "__attribute__((packed)) ");
+    } else if (alignment) {
+        fprintf(t->fptr, "__attribute__((aligned(%d))) ", alignment);
+    }
+
+    emit(t, structDeclaration.name);
+    emitSpace(t);
+    emitLeftBrace(t);
+    emitNewline(t);
+
+    if (layout.fieldCount == 0) {
+        emit(t, "char dummy;");
+        emitNewline(t);
+    }
+
+    for (int i = 0; i < layout.fieldCount; i++) {
+        if (layout.fields[i].explicitAlignment) {
+            fprintf(t->fptr, "_Alignas(%d) ", layout.fields[i].explicitAlignment);
+        }
+
+        emitStructField(t, *layout.fields[i].field);
+        emitNewline(t);
+    }
+
+    emitRightBrace(t);
+    emitSemicolon(t);
+    emitNewline(t);
+
+    freeStructLayout(layout);
+}
+
+static AstExpr *findStructDeclaration(Transpiler *t, char *name) {
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type == AST_STRUCT_DECLARATION && strcmp(expr->asStruct.name, name) == 0) return expr;
+    }
+
+    return NULL;
+}
+
+typedef enum {
+    STRUCT_NOT_EMITTED,
+    STRUCT_EMITTING,
+    STRUCT_EMITTED,
+} StructEmitState;
+
+// a struct is emitted after the structs it holds by value, which C needs to be complete first
+static void emitStructTypeInOrder(Transpiler *t, int index, StructEmitState *states) {
+    if (states[index] != STRUCT_NOT_EMITTED) return;
+    states[index] = STRUCT_EMITTING;
+
+    StructDeclaration structDeclaration = t->ast.exprs[index]->asStruct;
+
+    for (int i = 0; i < structDeclaration.memberCount; i++) {
+        if (structDeclaration.members[i]->type != AST_STRUCT_FIELD) continue;
+
+        TypeExpr type = structDeclaration.members[i]->asStructField.type;
+        if (type.ptrDepth || type.isSlice) continue;
+
+        AstExpr *dependency = findStructDeclaration(t, type.name);
+        if (!dependency) continue;
+
+        for (int j = 0; j < t->ast.exprCount; j++) {
+            if (t->ast.exprs[j] == dependency) emitStructTypeInOrder(t, j, states);
+        }
+    }
+
+    emitNewline(t);
+    emitStructType(t, structDeclaration);
+
+    states[index] = STRUCT_EMITTED;
+}
+
+// struct names are declared first so pointers and slices can refer to any of them
+static void emitStructNames(Transpiler *t) {
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+
+        // member functions can still be reachable when the type itself is never used
+        if (expr->type != AST_STRUCT_DECLARATION || !expr->asStruct.isReachable) continue;
+
+        fprintf(t->fptr, "\ntypedef struct %s %s;", expr->asStruct.name, expr->asStruct.name);
+    }
+
+    emitNewline(t);
+}
+
+static void emitStructTypes(Transpiler *t) {
+    StructEmitState *states = calloc(t->ast.exprCount + 1, sizeof(StructEmitState));
+
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type != AST_STRUCT_DECLARATION || !expr->asStruct.isReachable) continue;
+
+        emitStructTypeInOrder(t, i, states);
+    }
+
+    free(states);
+}
+
+void emitForwardDeclarations(Transpiler *t) {
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        if (t->ast.exprs[i]->type == AST_FUNCTION_DECLARATION) {
+            emitFunctionForwardDeclaration(t, t->ast.exprs[i]->asFunction);
+        }
+
+        if (t->ast.exprs[i]->type == AST_STRUCT_DECLARATION) {
+            StructDeclaration structDeclaration = t->ast.exprs[i]->asStruct;
+            if (structDeclaration.isInterface) continue;
+
+            for (int j = 0; j < structDeclaration.memberCount; j++) {
+                if (structDeclaration.members[j]->type == AST_FUNCTION_DECLARATION) {
+                    emitFunctionForwardDeclaration(t, structDeclaration.members[j]->asFunction);
+                }
+            }
+        }
+    }
+}
+
+// a thunk per function taking 'self' as 'void *', the vtable of them and the conversion to the interface
+static void emitImplementation(Transpiler *t, StructDeclaration implementor, StructDeclaration interface) {
+    for (int i = 0; i < interface.memberCount; i++) {
+        if (interface.members[i]->type != AST_FUNCTION_DECLARATION) continue;
+        FunctionDeclaration function = interface.members[i]->asFunction;
+
+        emit(t, "\nstatic inline ");
+        emitTypeExpression(t, function.returnType);
+        fprintf(t->fptr, "__%s_%s_%s(", implementor.name, interface.name, function.name);
+        emitInterfaceParameters(t, function, true);
+        emit(t, ") {\n");
+
+        if (!isVoidType(function.returnType)) emit(t, "return ");
+
+        char *name = methodName(implementor.name, function.name);
+        fprintf(t->fptr, "%s(self", name);
+        free(name);
+
+        for (int j = 1; j < function.paramCount; j++) {
+            fprintf(t->fptr, ", %s", function.parameters[j].name);
+        }
+        emit(t, ");\n}\n");
+    }
+
+    fprintf(t->fptr, "\nstatic const __%s_vtable __%s_%s_vtable = { ", interface.name, implementor.name, interface.name);
+    for (int i = 0; i < interface.memberCount; i++) {
+        if (interface.members[i]->type != AST_FUNCTION_DECLARATION) continue;
+        char *name = interface.members[i]->asFunction.name;
+
+        fprintf(t->fptr, ".%s = __%s_%s_%s, ", name, implementor.name, interface.name, name);
+    }
+    emit(t, "};\n");
+
+    char *conversion = conversionName(interface.name, implementor.name);
+    fprintf(t->fptr, "\nstatic inline %s %s(%s *self) {\n", interface.name, conversion, implementor.name);
+    fprintf(t->fptr, "return (%s){ self, &__%s_%s_vtable };\n}\n", interface.name, implementor.name, interface.name);
+    free(conversion);
+}
+
+// calls on an interface with several implementors load the function from the vtable
+static void emitDispatchers(Transpiler *t, StructDeclaration interface) {
+    for (int i = 0; i < interface.memberCount; i++) {
+        if (interface.members[i]->type != AST_FUNCTION_DECLARATION) continue;
+        FunctionDeclaration function = interface.members[i]->asFunction;
+
+        emit(t, "\nstatic inline ");
+        emitTypeExpression(t, function.returnType);
+
+        char *name = methodName(interface.name, function.name);
+        fprintf(t->fptr, "%s(%s self", name, interface.name);
+        free(name);
+
+        for (int j = 1; j < function.paramCount; j++) {
+            emitComma(t);
+            emitSpace(t);
+            emitTypeExpression(t, function.parameters[j].type);
+            emit(t, function.parameters[j].name);
+            emitArrayLength(t, function.parameters[j].type);
+        }
+        emit(t, ") {\n");
+
+        if (!isVoidType(function.returnType)) emit(t, "return ");
+
+        fprintf(t->fptr, "self.vtable->%s(self.self", function.name);
+        for (int j = 1; j < function.paramCount; j++) {
+            fprintf(t->fptr, ", %s", function.parameters[j].name);
+        }
+        emit(t, ");\n}\n");
+    }
+}
+
+static void emitInterfaceSupport(Transpiler *t) {
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type != AST_STRUCT_DECLARATION || !expr->asStruct.isReachable) continue;
+
+        if (expr->asStruct.isInterface) {
+            emitDispatchers(t, expr->asStruct);
+            continue;
+        }
+
+        for (int j = 0; j < expr->asStruct.interfaceCount; j++) {
+            StructDeclaration *interface = lookupStruct(t->ast, expr->asStruct.interfaces[j]);
+            emitImplementation(t, expr->asStruct, *interface);
         }
-        case AST_IF: {
-            emitIfStatement(t, expr->asIf);
+    }
+}
+
+typedef struct {
+    TypeExpr *elements;
+    int       count;
+    int       capacity;
+
+    bool      hasIndexing;
+} SliceTypes;
+
+static void addSliceType(SliceTypes *types, TypeExpr type) {
+    if (!type.isSlice && !type.arrayLength) return;
+    types->hasIndexing = true;
+
+    if (!type.isSlice) return;
+
+    for (int i = 0; i < types->count; i++) {
+        TypeExpr existing = types->elements[i];
+        if (existing.ptrDepth == type.ptrDepth && strcmp(existing.name, type.name) == 0) return;
+    }
+
+    if (types->count >= types->capacity) {
+        types->capacity *= 2;
+        types->elements = realloc(types->elements, sizeof(TypeExpr) * types->capacity);
+    }
+    types->elements[types->count++] = type;
+}
+
+static bool sliceTypeVisitor(AstExpr *expr, void *context) {
+    SliceTypes *types = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            addSliceType(types, expr->asLet.type);
             break;
         }
-        case AST_NEXT: {
-            emitNext(t, expr->asNext);
+        case AST_STRUCT_FIELD: {
+            addSliceType(types, expr->asStructField.type);
             break;
         }
-        case AST_STOP: {
-            emitStop(t, expr->asStop);
+        case AST_FUNCTION_DECLARATION: {
+            addSliceType(types, expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                addSliceType(types, expr->asFunction.parameters[i].type);
+            }
             break;
         }
-        case AST_UNARY: {
-            emitUnary(t, expr->asUnary);
+        case AST_INDEX: {
+            types->hasIndexing = true;
+
+            // slicing makes a slice of the element type
+            if (expr->asIndex.index->type == AST_RANGE) {
+                TypeExpr element = expr->asIndex.objectType;
+                element.arrayLength = 0;
+                element.isSlice = true;
+
+                addSliceType(types, element);
+            }
             break;
         }
-        case AST_BINARY: {
-            t->isEmittingExpression = true;
-            emitBinary(t, expr->asBinary);
-            t->isEmittingExpression = false;
+        default: {
             break;
         }
-        case AST_CALL_EXPR: {
-            emitCallExpr(t, expr->asCallExpr);
-            break;
+    }
+
+    return true;
+}
+
+// the slice structs and bounds checks used by the program
+static void emitArraySupport(Transpiler *t) {
+    SliceTypes types = { malloc(sizeof(TypeExpr)), 0, 1, false };
+
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        walkExpr(t->ast.exprs[i], sliceTypeVisitor, &types);
+    }
+
+    if (types.hasIndexing) {
+        emit(t, "#include <stdlib.h>\n\n");
+
+        emit(t, "static inline long long __aster_check_index(long long index, size_t length) {\n");
+        emit(t, "if (index < 0 || (unsigned long long)index >= length) {\n");
+        emit(t, "fprintf(stderr, \"index %lld is out of bounds for length %zu\\n\", index, length);\n");
+        emit(t, "abort();\n");
+        emit(t, "}\n");
+        emit(t, "return index;\n");
+        emit(t, "}\n\n");
+
+        emit(t, "static inline void __aster_check_slice(long long start, long long end, size_t length) {\n");
+        emit(t, "if (start < 0 || start > end || (unsigned long long)end > length) {\n");
+        emit(t, "fprintf(stderr, \"slice %lld..%lld is out of bounds for length %zu\\n\", start, end, length);\n");
+        emit(t, "abort();\n");
+        emit(t, "}\n");
+        emit(t, "}\n");
+    }
+
+    for (int i = 0; i < types.count; i++) {
+        TypeExpr element = types.elements[i];
+        if (soaStructOf(t, element)) continue;
+
+        element.isSlice = false;
+
+        emitNewline(t);
+        emit(t, "typedef struct { ");
+        emitTypeExpression(t, element);
+        emit(t, "*ptr; size_t len; } ");
+        emitSliceTypeName(t, element);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    // these come last as their fields may be slices themselves
+    for (int i = 0; i < types.count; i++) {
+        StructDeclaration *soa = soaStructOf(t, types.elements[i]);
+        if (!soa) continue;
+
+        emitNewline(t);
+        emit(t, "typedef struct { ");
+
+        for (int j = 0; j < soa->memberCount; j++) {
+            if (soa->members[j]->type != AST_STRUCT_FIELD) continue;
+            StructField field = soa->members[j]->asStructField;
+
+            emitTypeExpression(t, field.type);
+            fprintf(t->fptr, "*%s; ", field.name);
         }
-        case AST_INTEGER_LITERAL: {
-            emitIntegerLiteral(t, expr->asInteger);
+
+        emit(t, "size_t len; } ");
+        emitSliceTypeName(t, types.elements[i]);
+        emitSemicolon(t);
+        emitNewline(t);
+    }
+
+    free(types.elements);
+}
+
+typedef struct {
+    VectorType *elements;
+    int         count;
+    int         capacity;
+} VectorTypes;
+
+static void addVectorType(VectorTypes *types, VectorType vector) {
+    for (int i = 0; i < types->count; i++) {
+        VectorType existing = types->elements[i];
+        if (existing.lanes == vector.lanes && existing.element == vector.element) return;
+    }
+
+    if (types->count >= types->capacity) {
+        types->capacity *= 2;
+        types->elements = realloc(types->elements, sizeof(VectorType) * types->capacity);
+    }
+    types->elements[types->count++] = vector;
+}
+
+static void addVectorTypeNamed(VectorTypes *types, char *name) {
+    VectorType vector;
+    if (!name || !lookupVectorType(name, &vector)) return;
+
+    addVectorType(types, vector);
+    addVectorType(types, vectorMaskType(vector));
+}
+
+static bool vectorTypeVisitor(AstExpr *expr, void *context) {
+    VectorTypes *types = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            addVectorTypeNamed(types, expr->asLet.type.name);
             break;
         }
-        case AST_FLOAT_LITERAL: {
-            emitFloatLiteral(t, expr->asFloat);
+        case AST_STRUCT_FIELD: {
+            addVectorTypeNamed(types, expr->asStructField.type.name);
             break;
         }
-        case AST_STRING_LITERAL: {
-            emitStringLiteral(t, expr->asString);
+        case AST_FOR: {
+            addVectorTypeNamed(types, expr->asFor.type.name);
             break;
         }
-        case AST_CHAR_LITERAL: {
-            emitCharLiteral(t, expr->asChar);
+        case AST_FUNCTION_DECLARATION: {
+            addVectorTypeNamed(types, expr->asFunction.returnType.name);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                addVectorTypeNamed(types, expr->asFunction.parameters[i].type.name);
+            }
             break;
         }
-        case AST_IDENTIFIER: {
-            emitIdentifier(t, expr->asIdentifier);
+        case AST_BINARY: {
+            AstExpr *right = expr->asBinary.right;
+            if (expr->asBinary.operator == OP_AS_CAST && right->type == AST_IDENTIFIER) {
+                addVectorTypeNamed(types, right->asIdentifier.name);
+            }
             break;
         }
-        case AST_BOOL_LITERAL: {
-            emitBoolLiteral(t, expr->asBool);
+        case AST_CALL_EXPR: {
+            VectorType vector;
+            VectorBuiltin builtin;
+            if (!lookupVectorBuiltin(expr->asCallExpr.name, &vector, &builtin)) break;
+
+            addVectorType(types, vector);
+            addVectorType(types, vectorMaskType(vector));
             break;
         }
-        case AST_TERNARY: {
-            emitTernary(t, expr->asTernary);
+        default: {
             break;
         }
-        case AST_GROUPING: {
-            emitGrouping(t, expr->asGrouping);
+    }
+
+    return true;
+}
+
+// the builtins of one vector type, each is a thin wrapper over a GCC vector extension or builtin
+static void emitVectorBuiltins(Transpiler *t, VectorType vector) {
+    VectorType mask = vectorMaskType(vector);
+
+    char v[16];
+    char m[16];
+    snprintf(v, sizeof(v), "v%d%s", vector.lanes, vector.element);
+    snprintf(m, sizeof(m), "v%d%s", mask.lanes, mask.element);
+
+    char *e = mapPrimitiveTypeToC(vector.element);
+    FILE *f = t->fptr;
+
+    fprintf(f, "\n");
+    fprintf(f, "static inline %s %sLoad(%s const *p) { %s v; __builtin_memcpy(&v, p, sizeof(v)); return v; }\n", v, v, e, v);
+    fprintf(f, "static inline %s %sLoadAligned(%s const *p) { return *(%s const *)__builtin_assume_aligned(p, sizeof(%s)); }\n", v, v, e, v, v);
+    fprintf(f, "static inline void %sStore(%s *p, %s v) { __builtin_memcpy(p, &v, sizeof(v)); }\n", v, e, v);
+    fprintf(f, "static inline void %sStoreAligned(%s *p, %s v) { *(%s *)__builtin_assume_aligned(p, sizeof(%s)) = v; }\n", v, e, v, v, v);
+    fprintf(f, "static inline %s %sSplat(%s x) { return (%s){0} + x; }\n", v, v, e, v);
+    fprintf(f, "static inline %s %sShuffle(%s v, %s mask) { return __builtin_shuffle(v, mask); }\n", v, v, v, m);
+    fprintf(f, "static inline %s %sSelect(%s mask, %s a, %s b) { return (%s)((mask & (%s)a) | (~mask & (%s)b)); }\n", v, v, m, v, v, v, m, m);
+    fprintf(f, "static inline %s %sMin(%s a, %s b) { return %sSelect(a < b, a, b); }\n", v, v, v, v, v);
+    fprintf(f, "static inline %s %sMax(%s a, %s b) { return %sSelect(a > b, a, b); }\n", v, v, v, v, v);
+    fprintf(f, "static inline %s %sReduceAdd(%s v) { %s r = v[0]; for (int i = 1; i < %d; i++) r += v[i]; return r; }\n", e, v, v, e, vector.lanes);
+    fprintf(f, "static inline %s %sReduceMin(%s v) { %s r = v[0]; for (int i = 1; i < %d; i++) r = v[i] < r ? v[i] : r; return r; }\n", e, v, v, e, vector.lanes);
+    fprintf(f, "static inline %s %sReduceMax(%s v) { %s r = v[0]; for (int i = 1; i < %d; i++) r = v[i] > r ? v[i] : r; return r; }\n", e, v, v, e, vector.lanes);
+    fprintf(f, "static inline unsigned long %sBitmask(%s mask) { unsigned long bits = 0; for (int i = 0; i < %d; i++) bits |= (unsigned long)(mask[i] != 0) << i; return bits; }\n", v, m, vector.lanes);
+}
+
+// vector types map to GCC vector extension typedefs of the same name
+static void emitVectorSupport(Transpiler *t) {
+    VectorTypes types = { malloc(sizeof(VectorType)), 0, 1 };
+
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        walkExpr(t->ast.exprs[i], vectorTypeVisitor, &types);
+    }
+
+    if (types.count) emitNewline(t);
+
+    for (int i = 0; i < types.count; i++) {
+        VectorType vector = types.elements[i];
+
+        fprintf(t->fptr, "typedef %s v%d%s __attribute__((vector_size(%d)));\n",
+            mapPrimitiveTypeToC(vector.element), vector.lanes, vector.element, vector.lanes * vector.elementSize
+        );
+    }
+
+    for (int i = 0; i < types.count; i++) {
+        emitVectorBuiltins(t, types.elements[i]);
+    }
+
+    free(types.elements);
+}
+
+// types the transpiler provides, such as 'Arena', and whether the program uses them or their builtins
+typedef struct {
+    bool (*isType)(char *name);
+    bool (*isBuiltin)(char *name);
+    bool   isUsed;
+} RuntimeTypeUse;
+
+static bool isRuntimeTypeName(RuntimeTypeUse *use, char *name) {
+    return name && use->isType(name);
+}
+
+static bool runtimeTypeVisitor(AstExpr *expr, void *context) {
+    RuntimeTypeUse *use = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            use->isUsed |= isRuntimeTypeName(use, expr->asLet.type.name);
             break;
         }
-        case AST_PROPERTY_ACCESS: {
-            emitPropertyAccess(t, expr->asProperty);
+        case AST_STRUCT_FIELD: {
+            use->isUsed |= isRuntimeTypeName(use, expr->asStructField.type.name);
             break;
         }
-        case AST_STRUCT_INITIALIZER: {
-            emitStructInit(t, expr->asStructInit);
+        case AST_FUNCTION_DECLARATION: {
+            use->isUsed |= isRuntimeTypeName(use, expr->asFunction.returnType.name);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                use->isUsed |= isRuntimeTypeName(use, expr->asFunction.parameters[i].type.name);
+            }
             break;
         }
-        case AST_EMBED: {
-            emitEmbed(t, expr->asEmbed);
+        case AST_CALL_EXPR: {
+            use->isUsed |= use->isBuiltin(expr->asCallExpr.name);
             break;
         }
         default: {
-            exitWithInternalCompilerError("unknown expression type in 'emitExpr'");
+            break;
         }
     }
+
+    return !use->isUsed;
 }
 
-static void emitFunctionForwardDeclaration(Transpiler *t, FunctionDeclaration function) {
+static bool isRuntimeTypeUsed(Transpiler *t, bool (*isType)(char *name), bool (*isBuiltin)(char *name)) {
+    RuntimeTypeUse use = { isType, isBuiltin, false };
+    for (int i = 0; i < t->ast.exprCount && !use.isUsed; i++) {
+        walkExpr(t->ast.exprs[i], runtimeTypeVisitor, &use);
+    }
+
+    return use.isUsed;
+}
+
+static bool isArenaType(char *name) {
+    return strcmp(name, "Arena") == 0;
+}
+
+static bool isArenaBuiltin(char *name) {
+    ArenaBuiltin builtin;
+    return lookupArenaBuiltin(name, &builtin);
+}
+
+// 'Arena' is a chain of chunks that memory is bumped out of, it is only emitted when the program uses it
+// and not at all when the program declares its own 'Arena'
+static void emitArenaSupport(Transpiler *t) {
+    if (findStructDeclaration(t, "Arena") || !isRuntimeTypeUsed(t, isArenaType, isArenaBuiltin)) return;
+
     emitNewline(t);
+    emit(t, "#include <stdlib.h>\n");
+    emit(t, "#include <stdint.h>\n\n");
+
+    emit(t, "typedef struct __ArenaChunk {\n");
+    emit(t, "struct __ArenaChunk *next;\n");
+    emit(t, "size_t capacity;\n");
+    emit(t, "_Alignas(16) char data[];\n");
+    emit(t, "} __ArenaChunk;\n\n");
+
+    emit(t, "typedef struct {\n");
+    emit(t, "__ArenaChunk *first;\n");
+    emit(t, "__ArenaChunk *current;\n");
+    emit(t, "char *cursor;\n");
+    emit(t, "char *end;\n");
+    emit(t, "size_t chunkSize;\n");
+    emit(t, "} Arena;\n\n");
+
+    fprintf(t->fptr, "static inline Arena arenaNew(size_t chunkSize) {\n");
+    fprintf(t->fptr, "return (Arena){ NULL, NULL, NULL, NULL, chunkSize ? chunkSize : %d };\n", ARENA_DEFAULT_CHUNK_SIZE);
+    fprintf(t->fptr, "}\n\n");
+
+    // moves to the chunk after the current one, reusing it after a reset when it is large enough
+    // and otherwise linking in a new chunk at least large enough for this allocation
+    emit(t, "static void *__aster_arena_grow(Arena *a, size_t size, size_t align) {\n");
+    emit(t, "__ArenaChunk *next = a->current ? a->current->next : a->first;\n");
+    emit(t, "if (!next || next->capacity < size + align) {\n");
+    emit(t, "size_t capacity = a->chunkSize > size + align ? a->chunkSize : size + align;\n");
+    emit(t, "__ArenaChunk *chunk = malloc(sizeof(__ArenaChunk) + capacity);\n");
+    emit(t, "if (!chunk) {\n");
+    emit(t, "fprintf(stderr, \"arena could not allocate %zu bytes\\n\", size);\n");
+    emit(t, "abort();\n");
+    emit(t, "}\n");
+    emit(t, "chunk->capacity = capacity;\n");
+    emit(t, "chunk->next = next;\n");
+    emit(t, "if (a->current) a->current->next = chunk;\n");
+    emit(t, "else a->first = chunk;\n");
+    emit(t, "next = chunk;\n");
+    emit(t, "}\n");
+    emit(t, "a->current = next;\n");
+    emit(t, "a->end = next->data + next->capacity;\n");
+    emit(t, "uintptr_t p = ((uintptr_t)next->data + align - 1) & ~(uintptr_t)(align - 1);\n");
+    emit(t, "a->cursor = (char *)(p + size);\n");
+    emit(t, "return (void *)p;\n");
+    emit(t, "}\n\n");
+
+    // the fast path is a bump of the cursor and is inlined at every allocation
+    emit(t, "__attribute__((malloc, alloc_size(2), alloc_align(3)))\n");
+    emit(t, "static inline void *arenaAllocAligned(Arena *a, size_t size, size_t align) {\n");
+    emit(t, "uintptr_t p = ((uintptr_t)a->cursor + align - 1) & ~(uintptr_t)(align - 1);\n");
+    emit(t, "if (__builtin_expect(a->cursor != NULL && p + size <= (uintptr_t)a->end, 1)) {\n");
+    emit(t, "a->cursor = (char *)(p + size);\n");
+    emit(t, "return (void *)p;\n");
+    emit(t, "}\n");
+    emit(t, "return __aster_arena_grow(a, size, align);\n");
+    emit(t, "}\n\n");
+
+    emit(t, "__attribute__((malloc, alloc_size(2), assume_aligned(16)))\n");
+    emit(t, "static inline void *arenaAlloc(Arena *a, size_t size) {\n");
+    emit(t, "return arenaAllocAligned(a, size, 16);\n");
+    emit(t, "}\n\n");
+
+    // everything allocated is released at once but the chunks are kept to be filled again
+    emit(t, "static inline void arenaReset(Arena *a) {\n");
+    emit(t, "a->current = a->first;\n");
+    emit(t, "a->cursor = a->first ? a->first->data : NULL;\n");
+    emit(t, "a->end = a->first ? a->first->data + a->first->capacity : NULL;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static inline void arenaFree(Arena *a) {\n");
+    emit(t, "for (__ArenaChunk *chunk = a->first, *next; chunk; chunk = next) {\n");
+    emit(t, "next = chunk->next;\n");
+    emit(t, "free(chunk);\n");
+    emit(t, "}\n");
+    emit(t, "*a = arenaNew(a->chunkSize);\n");
+    emit(t, "}\n");
+}
 
-    if (function.isInline) {
-        emit(t, "inline");
-        emitSpace(t);
-    }
+static bool isPoolType(char *name) {
+    TypeExpr element;
+    if (!lookupPoolType(name, &element)) return strcmp(name, "Pool") == 0;
 
-    emitTypeExpression(t, function.returnType);
-    emit(t, function.name);
+    free(element.name);
+    return true;
+}
 
-    emitLeftParen(t);
+static bool isPoolBuiltin(char *name) {
+    PoolBuiltin builtin;
+    return lookupPoolBuiltin(name, &builtin);
+}
 
-    for (int i = 0; i < function.paramCount; i++) {
-        emitTypeExpression(t, function.parameters[i].type);
-        emit(t, function.parameters[i].name);
+// outside of release builds each slab ends in a bitmap with a bit per slot that is set while the
+// slot is handed out, freeing a slot whose bit is clear or a pointer that is not a slot of the pool
+// aborts, a freed slot is filled with 'POOL_POISON' past its free list link, and it is checked to
+// still be filled, with a link to another free slot, when it is handed out again
+static void emitPoolChecks(Transpiler *t) {
+    emit(t, "static void __aster_pool_fail(void *slot, const char *problem) {\n");
+    emit(t, "fprintf(stderr, \"pool slot %p %s\\n\", slot, problem);\n");
+    emit(t, "abort();\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static unsigned char *__aster_pool_live_bit(Pool *p, void *slot, unsigned char *mask) {\n");
+    emit(t, "for (__PoolSlab *slab = p->slabs; slab; slab = slab->next) {\n");
+    emit(t, "uintptr_t start = (uintptr_t)slab->data;\n");
+    emit(t, "uintptr_t end = start + p->slotSize * p->slabSlots;\n");
+    emit(t, "if ((uintptr_t)slot < start || (uintptr_t)slot >= end) continue;\n");
+    emit(t, "size_t offset = (uintptr_t)slot - start;\n");
+    emit(t, "if (offset % p->slotSize != 0) return NULL;\n");
+    emit(t, "size_t index = offset / p->slotSize;\n");
+    emit(t, "*mask = (unsigned char)(1u << (index % 8));\n");
+    emit(t, "return (unsigned char *)slab->data + p->slotSize * p->slabSlots + index / 8;\n");
+    emit(t, "}\n");
+    emit(t, "return NULL;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static void __aster_pool_set_live(Pool *p, void *slot, bool isLive) {\n");
+    emit(t, "unsigned char mask;\n");
+    emit(t, "unsigned char *bits = __aster_pool_live_bit(p, slot, &mask);\n");
+    emit(t, "if (!bits) __aster_pool_fail(slot, \"is not a slot of this pool\");\n");
+    emit(t, "if (((*bits & mask) != 0) == isLive) __aster_pool_fail(slot, isLive ? \"is already handed out\" : \"was freed twice or never allocated\");\n");
+    emit(t, "*bits ^= mask;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static void __aster_pool_check_freed(Pool *p, void *slot) {\n");
+    emit(t, "unsigned char *bytes = slot;\n");
+    emit(t, "for (size_t i = sizeof(void *); i < p->slotSize; i++) {\n");
+    fprintf(t->fptr, "if (bytes[i] != 0x%x) __aster_pool_fail(slot, \"was written to after it was freed\");\n", POOL_POISON);
+    emit(t, "}\n");
+    emit(t, "void *next;\n");
+    emit(t, "__builtin_memcpy(&next, slot, sizeof(void *));\n");
+    emit(t, "unsigned char mask;\n");
+    emit(t, "unsigned char *bits = next ? __aster_pool_live_bit(p, next, &mask) : NULL;\n");
+    emit(t, "if (next && (!bits || (*bits & mask))) __aster_pool_fail(slot, \"was written to after it was freed\");\n");
+    emit(t, "}\n\n");
+}
 
-        if (i != function.paramCount - 1) {
-            emitComma(t);
-            emitSpace(t);
-        }
+// 'Pool' hands out slots of one size from slabs, freed slots are linked through their first bytes
+// and handed out again first, it is only emitted when the program uses it
+static void emitPoolSupport(Transpiler *t) {
+    if (findStructDeclaration(t, "Pool") || !isRuntimeTypeUsed(t, isPoolType, isPoolBuiltin)) return;
+
+    emitNewline(t);
+    emit(t, "#include <stdlib.h>\n");
+    if (!t->isRelease) emit(t, "#include <stdint.h>\n");
+    emitNewline(t);
+
+    emit(t, "typedef struct __PoolSlab {\n");
+    emit(t, "struct __PoolSlab *next;\n");
+    emit(t, "_Alignas(16) char data[];\n");
+    emit(t, "} __PoolSlab;\n\n");
+
+    emit(t, "typedef struct {\n");
+    emit(t, "void *freeList;\n");
+    emit(t, "__PoolSlab *slabs;\n");
+    emit(t, "char *cursor;\n");
+    emit(t, "char *end;\n");
+    emit(t, "size_t slotSize;\n");
+    emit(t, "size_t slabSlots;\n");
+    emit(t, "} Pool;\n\n");
+
+    // slots are rounded up to a multiple of 8 so each keeps the alignment of the type stored in it,
+    // outside of release builds they also keep room for poison past the free list link
+    emit(t, "static inline Pool poolNew(size_t size, size_t slabSlots) {\n");
+    emit(t, "size_t slotSize = size < sizeof(void *) ? sizeof(void *) : (size + 7) & ~(size_t)7;\n");
+    if (!t->isRelease) {
+        emit(t, "if (slotSize < 2 * sizeof(void *)) slotSize = 2 * sizeof(void *);\n");
     }
+    fprintf(t->fptr, "return (Pool){ NULL, NULL, NULL, NULL, slotSize, slabSlots ? slabSlots : %d };\n", POOL_DEFAULT_SLAB_SLOTS);
+    emit(t, "}\n\n");
 
-    emitRightParen(t);
-    emitSemicolon(t);
+    emit(t, "static void *__aster_pool_grow(Pool *p) {\n");
+    if (t->isRelease) {
+        emit(t, "__PoolSlab *slab = malloc(sizeof(__PoolSlab) + p->slotSize * p->slabSlots);\n");
+    } else {
+        emit(t, "size_t liveBytes = (p->slabSlots + 7) / 8;\n");
+        emit(t, "__PoolSlab *slab = malloc(sizeof(__PoolSlab) + p->slotSize * p->slabSlots + liveBytes);\n");
+    }
+    emit(t, "if (!slab) {\n");
+    emit(t, "fprintf(stderr, \"pool could not allocate a slab of %zu slots\\n\", p->slabSlots);\n");
+    emit(t, "abort();\n");
+    emit(t, "}\n");
+    if (!t->isRelease) {
+        emit(t, "__builtin_memset(slab->data + p->slotSize * p->slabSlots, 0, liveBytes);\n");
+    }
+    emit(t, "slab->next = p->slabs;\n");
+    emit(t, "p->slabs = slab;\n");
+    emit(t, "p->cursor = slab->data + p->slotSize;\n");
+    emit(t, "p->end = slab->data + p->slotSize * p->slabSlots;\n");
+    emit(t, "return slab->data;\n");
+    emit(t, "}\n\n");
+
+    if (!t->isRelease) emitPoolChecks(t);
+
+    emit(t, "__attribute__((malloc))\n");
+    emit(t, "static inline void *poolAlloc(Pool *p) {\n");
+    emit(t, "void *slot = p->freeList;\n");
+    emit(t, "if (slot) {\n");
+    if (!t->isRelease) emit(t, "__aster_pool_check_freed(p, slot);\n");
+    emit(t, "__builtin_memcpy(&p->freeList, slot, sizeof(void *));\n");
+    if (!t->isRelease) {
+        fprintf(t->fptr, "__builtin_memset(slot, 0x%x, p->slotSize);\n", POOL_UNINITIALIZED);
+    }
+    emit(t, "} else if (__builtin_expect(p->cursor != p->end, 1)) {\n");
+    emit(t, "slot = p->cursor;\n");
+    emit(t, "p->cursor += p->slotSize;\n");
+    emit(t, "} else {\n");
+    emit(t, "slot = __aster_pool_grow(p);\n");
+    emit(t, "}\n");
+    if (!t->isRelease) emit(t, "__aster_pool_set_live(p, slot, true);\n");
+    emit(t, "return slot;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static inline void poolFree(Pool *p, void *slot) {\n");
+    if (!t->isRelease) {
+        emit(t, "__aster_pool_set_live(p, slot, false);\n");
+        fprintf(t->fptr, "__builtin_memset(slot, 0x%x, p->slotSize);\n", POOL_POISON);
+    }
+    emit(t, "__builtin_memcpy(slot, &p->freeList, sizeof(void *));\n");
+    emit(t, "p->freeList = slot;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static inline void poolDestroy(Pool *p) {\n");
+    emit(t, "for (__PoolSlab *slab = p->slabs, *next; slab; slab = next) {\n");
+    emit(t, "next = slab->next;\n");
+    emit(t, "free(slab);\n");
+    emit(t, "}\n");
+    emit(t, "*p = (Pool){ NULL, NULL, NULL, NULL, p->slotSize, p->slabSlots };\n");
+    emit(t, "}\n");
 }
 
-void emitForwardDeclarations(Transpiler *t) {
-    for (int i = 0; i < t->ast.exprCount; i++) {
-        if (t->ast.exprs[i]->type == AST_FUNCTION_DECLARATION) {
-            emitFunctionForwardDeclaration(t, t->ast.exprs[i]->asFunction);
-        }
+static bool isAtomicType(char *name) {
+    TypeExpr element;
+    if (!lookupAtomicType(name, &element)) return false;
 
-        if (t->ast.exprs[i]->type == AST_STRUCT_DECLARATION) {
-            StructDeclaration structDeclaration = t->ast.exprs[i]->asStruct;
+    free(element.name);
+    return true;
+}
 
-            for (int j = 0; j < structDeclaration.memberCount; j++) {
-                if (structDeclaration.members[j]->type == AST_FUNCTION_DECLARATION) {
-                    emitFunctionForwardDeclaration(t, structDeclaration.members[j]->asFunction);
-                }
-            }
-        }
+static bool isAtomicBuiltin(char *name) {
+    AtomicBuiltin builtin;
+    return lookupAtomicBuiltin(name, &builtin);
+}
+
+// the tasks a worker's deque can hold, a task spawned onto a full deque runs where it is spawned
+#define TASK_DEQUE_SLOTS 4096
+
+// the Chase-Lev deque of each worker, with the orderings of Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", except that a push releases 'bottom' itself rather than
+// through a fence, which is as strong and which thread sanitizers understand
+//
+// the owner pushes and takes at the bottom and thieves steal from the top, only taking or stealing
+// the last task contends on 'top'
+static void emitTaskDeque(Transpiler *t) {
+    emit(t, "typedef struct __AsterTask {\n");
+    emit(t, "void (*run)(struct __AsterTask *task);\n");
+    emit(t, "atomic_size_t *pending;\n");
+    emit(t, "} __AsterTask;\n\n");
+
+    emit(t, "typedef struct {\n");
+    emit(t, "_Alignas(64) atomic_long top;\n");
+    emit(t, "_Alignas(64) atomic_long bottom;\n");
+    fprintf(t->fptr, "_Atomic(__AsterTask *) slots[%d];\n", TASK_DEQUE_SLOTS);
+    emit(t, "} __AsterDeque;\n\n");
+
+    emit(t, "static bool __aster_deque_push(__AsterDeque *d, __AsterTask *task) {\n");
+    emit(t, "long bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed);\n");
+    emit(t, "long top = atomic_load_explicit(&d->top, memory_order_acquire);\n");
+    fprintf(t->fptr, "if (bottom - top >= %d) return false;\n", TASK_DEQUE_SLOTS);
+    fprintf(t->fptr, "atomic_store_explicit(&d->slots[bottom & %d], task, memory_order_relaxed);\n", TASK_DEQUE_SLOTS - 1);
+    emit(t, "atomic_store_explicit(&d->bottom, bottom + 1, memory_order_release);\n");
+    emit(t, "return true;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static __AsterTask *__aster_deque_take(__AsterDeque *d) {\n");
+    emit(t, "long bottom = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;\n");
+    emit(t, "atomic_store_explicit(&d->bottom, bottom, memory_order_relaxed);\n");
+    emit(t, "atomic_thread_fence(memory_order_seq_cst);\n");
+    emit(t, "long top = atomic_load_explicit(&d->top, memory_order_relaxed);\n");
+    emit(t, "if (top > bottom) {\n");
+    emit(t, "atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);\n");
+    emit(t, "return NULL;\n");
+    emit(t, "}\n");
+    fprintf(t->fptr, "__AsterTask *task = atomic_load_explicit(&d->slots[bottom & %d], memory_order_relaxed);\n", TASK_DEQUE_SLOTS - 1);
+    emit(t, "if (top == bottom) {\n");
+    emit(t, "if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) task = NULL;\n");
+    emit(t, "atomic_store_explicit(&d->bottom, bottom + 1, memory_order_relaxed);\n");
+    emit(t, "}\n");
+    emit(t, "return task;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static __AsterTask *__aster_deque_steal(__AsterDeque *d) {\n");
+    emit(t, "long top = atomic_load_explicit(&d->top, memory_order_acquire);\n");
+    emit(t, "atomic_thread_fence(memory_order_seq_cst);\n");
+    emit(t, "long bottom = atomic_load_explicit(&d->bottom, memory_order_acquire);\n");
+    emit(t, "if (top >= bottom) return NULL;\n");
+    fprintf(t->fptr, "__AsterTask *task = atomic_load_explicit(&d->slots[top & %d], memory_order_relaxed);\n", TASK_DEQUE_SLOTS - 1);
+    emit(t, "if (!atomic_compare_exchange_strong_explicit(&d->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) return NULL;\n");
+    emit(t, "return task;\n");
+    emit(t, "}\n");
+}
+
+// one worker thread per core, or 'ASTER_THREADS', started by the first spawn, the thread spawning
+// becomes worker 0 and threads which are not workers run what they spawn where they spawn it
+static void emitTaskWorkers(Transpiler *t) {
+    emit(t, "static __AsterDeque *__aster_deques;\n");
+    emit(t, "static int __aster_worker_count;\n");
+    emit(t, "static pthread_once_t __aster_workers_started = PTHREAD_ONCE_INIT;\n");
+    emit(t, "static _Thread_local int __aster_worker = -1;\n");
+    emit(t, "static _Thread_local unsigned __aster_seed;\n\n");
+
+    emit(t, "static void __aster_task_run(__AsterTask *task) {\n");
+    emit(t, "atomic_size_t *pending = task->pending;\n");
+    emit(t, "task->run(task);\n");
+    emit(t, "free(task);\n");
+    emit(t, "atomic_fetch_sub_explicit(pending, 1, memory_order_release);\n");
+    emit(t, "}\n\n");
+
+    // the worker's own deque first, then the others from a random one on
+    emit(t, "static __AsterTask *__aster_find_task(void) {\n");
+    emit(t, "__AsterTask *task = __aster_deque_take(&__aster_deques[__aster_worker]);\n");
+    emit(t, "if (task) return task;\n");
+    emit(t, "__aster_seed ^= __aster_seed << 13;\n");
+    emit(t, "__aster_seed ^= __aster_seed >> 17;\n");
+    emit(t, "__aster_seed ^= __aster_seed << 5;\n");
+    emit(t, "for (int i = 0; i < __aster_worker_count; i++) {\n");
+    emit(t, "int victim = (__aster_seed + i) % __aster_worker_count;\n");
+    emit(t, "if (victim == __aster_worker) continue;\n");
+    emit(t, "task = __aster_deque_steal(&__aster_deques[victim]);\n");
+    emit(t, "if (task) return task;\n");
+    emit(t, "}\n");
+    emit(t, "return NULL;\n");
+    emit(t, "}\n\n");
+
+    // an idle worker yields for a while, then sleeps for longer and longer up to a millisecond
+    emit(t, "static void *__aster_worker_main(void *index) {\n");
+    emit(t, "__aster_worker = (int)(intptr_t)index;\n");
+    emit(t, "__aster_seed = __aster_worker + 1;\n");
+    emit(t, "for (long idle = 0;;) {\n");
+    emit(t, "__AsterTask *task = __aster_find_task();\n");
+    emit(t, "if (task) {\n");
+    emit(t, "__aster_task_run(task);\n");
+    emit(t, "idle = 0;\n");
+    emit(t, "} else if (++idle < 64) {\n");
+    emit(t, "sched_yield();\n");
+    emit(t, "} else {\n");
+    emit(t, "struct timespec pause = { 0, idle < 1000 ? idle * 1000 : 1000000 };\n");
+    emit(t, "nanosleep(&pause, NULL);\n");
+    emit(t, "}\n");
+    emit(t, "}\n");
+    emit(t, "return NULL;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static void __aster_start_workers(void) {\n");
+    emit(t, "char *threads = getenv(\"ASTER_THREADS\");\n");
+    emit(t, "long count = threads ? strtol(threads, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);\n");
+    emit(t, "if (count < 1) count = 1;\n");
+    emit(t, "__aster_deques = aligned_alloc(_Alignof(__AsterDeque), sizeof(__AsterDeque) * count);\n");
+    emit(t, "if (!__aster_deques) {\n");
+    emit(t, "fprintf(stderr, \"could not allocate the deques of %ld workers\\n\", count);\n");
+    emit(t, "abort();\n");
+    emit(t, "}\n");
+    emit(t, "for (long i = 0; i < count; i++) {\n");
+    emit(t, "atomic_init(&__aster_deques[i].top, 0);\n");
+    emit(t, "atomic_init(&__aster_deques[i].bottom, 0);\n");
+    emit(t, "}\n");
+    emit(t, "__aster_worker_count = count;\n");
+    emit(t, "__aster_worker = 0;\n");
+    emit(t, "__aster_seed = 1;\n");
+    emit(t, "for (long i = 1; i < count; i++) {\n");
+    emit(t, "pthread_t thread;\n");
+    emit(t, "if (pthread_create(&thread, NULL, __aster_worker_main, (void *)(intptr_t)i) == 0) pthread_detach(thread);\n");
+    emit(t, "}\n");
+    emit(t, "}\n");
+}
+
+// a spawned call is allocated as a record by '__aster_task_new', the spawning function counts it in its
+// '__spawned' and '__aster_sync' runs tasks from its own deque or stolen ones until the count is zero
+static void emitTaskSupport(Transpiler *t) {
+    bool hasSpawns = false;
+    for (int i = 0; i < t->ast.exprCount && !hasSpawns; i++) {
+        walkExpr(t->ast.exprs[i], spawnVisitor, &hasSpawns);
     }
+
+    if (!hasSpawns) return;
+
+    emitNewline(t);
+    emit(t, "#include <pthread.h>\n");
+    emit(t, "#include <sched.h>\n");
+    emit(t, "#include <stdatomic.h>\n");
+    emit(t, "#include <stdint.h>\n");
+    emit(t, "#include <stdlib.h>\n");
+    emit(t, "#include <time.h>\n");
+    emit(t, "#include <unistd.h>\n\n");
+
+    emitTaskDeque(t);
+    emitNewline(t);
+    emitTaskWorkers(t);
+    emitNewline(t);
+
+    emit(t, "static void *__aster_task_new(size_t size, void (*run)(__AsterTask *task), atomic_size_t *pending) {\n");
+    emit(t, "__AsterTask *task = malloc(size);\n");
+    emit(t, "if (!task) {\n");
+    emit(t, "fprintf(stderr, \"could not allocate a task\\n\");\n");
+    emit(t, "abort();\n");
+    emit(t, "}\n");
+    emit(t, "task->run = run;\n");
+    emit(t, "task->pending = pending;\n");
+    emit(t, "return task;\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static void __aster_spawn(__AsterTask *task) {\n");
+    emit(t, "pthread_once(&__aster_workers_started, __aster_start_workers);\n");
+    emit(t, "atomic_fetch_add_explicit(task->pending, 1, memory_order_relaxed);\n");
+    emit(t, "if (__aster_worker < 0 || !__aster_deque_push(&__aster_deques[__aster_worker], task)) __aster_task_run(task);\n");
+    emit(t, "}\n\n");
+
+    emit(t, "static void __aster_sync(atomic_size_t *pending) {\n");
+    emit(t, "while (atomic_load_explicit(pending, memory_order_acquire)) {\n");
+    emit(t, "__AsterTask *task = __aster_find_task();\n");
+    emit(t, "if (task) __aster_task_run(task);\n");
+    emit(t, "else sched_yield();\n");
+    emit(t, "}\n");
+    emit(t, "}\n");
+
+    t->usesThreads = true;
+}
+
+// 'atomic<T>' is a C11 '_Atomic' and its builtins are the '_explicit' functions of <stdatomic.h>
+static void emitAtomicSupport(Transpiler *t) {
+    if (!isRuntimeTypeUsed(t, isAtomicType, isAtomicBuiltin)) return;
+
+    emitNewline(t);
+    emit(t, "#include <stdatomic.h>\n");
 }
 
 void transpile(Transpiler *t) {
     fprintf(t->fptr, "#include <stdbool.h>\n");
     fprintf(t->fptr, "#include <stdio.h>\n");
 
+    emitVectorSupport(t);
+    emitAtomicSupport(t);
+    emitTaskSupport(t);
+    emitArenaSupport(t);
+    emitPoolSupport(t);
+    emitStructNames(t);
+    emitArraySupport(t);
+    emitStructTypes(t);
+
     emitForwardDeclarations(t);
+    emitTaskRecords(t);
+    emitInterfaceSupport(t);
 
     emitNewline(t);
     emitNewline(t);
@@ -780,4 +3632,124 @@ void transpile(Transpiler *t) {
     for (int i = 0; i < t->ast.exprCount; i++) {
         emitExpr(t, t->ast.exprs[i]);
     }
+}
+typedef struct {
+    char *name;
+    bool  isFound;
+} ArrayElementSearch;
+
+static void findArrayElementType(ArrayElementSearch *search, TypeExpr type) {
+    if ((type.arrayLength || type.isSlice) && !type.ptrDepth && strcmp(type.name, search->name) == 0) {
+        search->isFound = true;
+    }
+}
+
+static bool arrayElementVisitor(AstExpr *expr, void *context) {
+    ArrayElementSearch *search = context;
+
+    switch (expr->type) {
+        case AST_LET: {
+            findArrayElementType(search, expr->asLet.type);
+            break;
+        }
+        case AST_STRUCT_FIELD: {
+            findArrayElementType(search, expr->asStructField.type);
+            break;
+        }
+        case AST_FUNCTION_DECLARATION: {
+            findArrayElementType(search, expr->asFunction.returnType);
+            for (int i = 0; i < expr->asFunction.paramCount; i++) {
+                findArrayElementType(search, expr->asFunction.parameters[i].type);
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    return !search->isFound;
+}
+
+// whether the program keeps a struct in arrays or slices, where its size decides how elements meet cache lines
+static bool isArrayElementType(Transpiler *t, char *name) {
+    ArrayElementSearch search = { name, false };
+
+    for (int i = 0; i < t->ast.exprCount && !search.isFound; i++) {
+        walkExpr(t->ast.exprs[i], arrayElementVisitor, &search);
+    }
+
+    return search.isFound;
+}
+
+static void emitStructLayoutReport(Transpiler *t, StructDeclaration structDeclaration) {
+    StructLayout layout = layoutStruct(t->ast, structDeclaration);
+    char *name = structDeclaration.name;
+
+    fprintf(t->fptr, "printf(\"\\nstruct %s: %%zu bytes, aligned to %%zu%s\\n\", sizeof(%s), _Alignof(%s));\n",
+        name, layout.isReordered ? ", fields reordered" : "", name, name
+    );
+    emit(t, "printf(\"  offset   size  lines      field\\n\");\n");
+
+    emit(t, "used = 0;\n");
+    for (int i = 0; i < layout.fieldCount; i++) {
+        char *field = layout.fields[i].field->name;
+
+        fprintf(t->fptr, "used += __aster_layout_field(\"%s\", offsetof(%s, %s), sizeof(((%s *)0)->%s));\n",
+            field, name, field, name, field
+        );
+    }
+
+    // the elements of an '@soa' array are never stored whole, so their size does not matter
+    bool isArrayElement = !hasTag(structDeclaration.tags, TAG_SOA) && isArrayElementType(t, name);
+    fprintf(t->fptr, "__aster_layout_end(\"%s\", sizeof(%s), used, %s);\n", name, name, isArrayElement ? "true" : "false");
+
+    freeStructLayout(layout);
+}
+
+void transpileLayoutReport(Transpiler *t) {
+    fprintf(t->fptr, "#include <stdbool.h>\n");
+    fprintf(t->fptr, "#include <stdio.h>\n");
+    fprintf(t->fptr, "#include <stddef.h>\n");
+
+    emitVectorSupport(t);
+    emitAtomicSupport(t);
+    emitTaskSupport(t);
+    emitArenaSupport(t);
+    emitPoolSupport(t);
+    emitStructNames(t);
+    emitArraySupport(t);
+    emitStructTypes(t);
+
+    // lines are counted from the start of the struct, as if it were aligned to a cache line
+    fprintf(t->fptr, "\nstatic size_t __aster_layout_field(const char *name, size_t offset, size_t size) {\n");
+    fprintf(t->fptr, "size_t first = offset / %d;\n", CACHE_LINE_SIZE);
+    fprintf(t->fptr, "size_t last = (offset + (size ? size - 1 : 0)) / %d;\n", CACHE_LINE_SIZE);
+    emit(t, "if (first == last) printf(\"  %6zu %6zu  %5zu      %s\\n\", offset, size, first, name);\n");
+    emit(t, "else printf(\"  %6zu %6zu  %5zu-%-4zu %s\\n\", offset, size, first, last, name);\n");
+    emit(t, "return size;\n");
+    emit(t, "}\n");
+
+    emit(t, "\nstatic void __aster_layout_end(const char *name, size_t size, size_t used, bool isArrayElement) {\n");
+    emit(t, "printf(\"  padding: %zu bytes\\n\", size - used);\n");
+    fprintf(t->fptr, "if (isArrayElement && size %% %d != 0 && %d %% size != 0) {\n", CACHE_LINE_SIZE, CACHE_LINE_SIZE);
+    fprintf(t->fptr, "printf(\"warning: '%%s' is kept in arrays and its %%zu bytes do not divide evenly into %d byte cache lines, so some elements straddle two lines\\n\", name, size);\n", CACHE_LINE_SIZE);
+    emit(t, "}\n");
+    emit(t, "}\n");
+
+    emit(t, "\nint main(void) {\n");
+    emit(t, "size_t used;\n");
+
+    for (int i = 0; i < t->ast.exprCount; i++) {
+        AstExpr *expr = t->ast.exprs[i];
+        if (expr->type != AST_STRUCT_DECLARATION || !expr->asStruct.isReachable) continue;
+
+        // an interface value is always a pointer and a vtable, there is nothing to lay out
+        if (expr->asStruct.isInterface) continue;
+
+        emitStructLayoutReport(t, expr->asStruct);
+    }
+
+    emit(t, "return 0;\n");
+    emit(t, "}\n");
 }
\ No newline at end of file
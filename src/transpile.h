@@ -3,14 +3,65 @@
 
 #include "parse.h"
 
+// the defers registered so far in a block being emitted, they run in reverse when it is left
+typedef struct {
+    AstExpr **defers;
+    int       count;
+    int       capacity;
+} DeferScope;
+
 typedef struct {
     Ast   ast;
     FILE *fptr;
 
     bool isEmittingExpression;
+
+    // bounds checks the analyzer proved redundant are only left out of release builds
+    bool isRelease;
+
+    // the function whose body is being emitted, null at the top level
+    FunctionDeclaration *currentFunction;
+
+    // which parameters of that function are passed by pointer, and whether it returns through '__ret'
+    bool *byReference;
+    bool  isReturningByReference;
+
+    // the blocks being emitted, innermost last, see 'emitScope'
+    DeferScope *deferScopes;
+    int         deferScopeCount;
+    int         deferScopeCapacity;
+
+    // the scopes of the current function's body and of the innermost loop body, -1 when there is none
+    int  functionScope;
+    int  loopScope;
+
+    // set when the current function defers anything, its returns then leave through its epilogue
+    bool hasDefers;
+
+    // set when the current function spawns tasks, it waits for them in its epilogue so it also has one
+    bool hasSpawns;
+
+    // numbers the tables, labels and variables introduced by the transpiler so their names are unique
+    int  uniqueCount;
+
+    // the '@dispatch' loop which 'stop' and 'next' leave by label, or -1 inside any other loop
+    int  dispatchLoop;
+
+    // the label 'next' jumps to in a while loop with an alteration, which 'continue' would skip, or -1
+    int  nextLabel;
+
+    // set when OpenMP pragmas were emitted, the C compiler needs '-fopenmp' or '-fopenmp-simd'
+    bool usesOpenMP;
+    bool usesOpenMPSimd;
+
+    // set when spawned calls are run by the task runtime's worker threads, the C compiler needs '-pthread'
+    bool usesThreads;
 } Transpiler;
 
-Transpiler newTranspiler(FILE *fptr, Ast ast);
+Transpiler newTranspiler(FILE *fptr, Ast ast, bool isRelease);
 void transpile(Transpiler *transpiler);
 
+// writes a program which prints the size, alignment and field offsets of each struct as the C compiler lays them out
+void transpileLayoutReport(Transpiler *transpiler);
+
 #endif
\ No newline at end of file
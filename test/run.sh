@@ -0,0 +1,50 @@
+#!/bin/sh
+# runs every program in test/cases through 'aster --path'
+#
+# a case describes what it expects in its own comments:
+#   // args: <flags>      extra compiler flags, such as '--release'
+#   // expect: <line>     a line the program prints, in order, at the end of its output
+#   // error: <text>      a diagnostic the compiler must report
+
+aster="$(pwd)/build/aster"
+cases="$(pwd)/test/cases"
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+passed=0
+failed=0
+
+for path in "$cases"/*.ast; do
+    name=$(basename "$path" .ast)
+
+    args=$(sed -n 's|^// args: ||p' "$path")
+    sed -n 's|^// expect: ||p' "$path" > "$work/expected"
+    errors=$(sed -n 's|^// error: ||p' "$path")
+
+    (cd "$work" && "$aster" --path "$path" $args > "$work/stdout" 2> "$work/stderr")
+
+    ok=true
+    if [ -n "$errors" ]; then
+        echo "$errors" | while read -r text; do
+            cat "$work/stdout" "$work/stderr" | grep -qF -- "$text" || exit 1
+        done || ok=false
+    else
+        grep -q "failed" "$work/stderr" && ok=false
+        lines=$(wc -l < "$work/expected")
+        tail -n "$lines" "$work/stdout" | diff -u "$work/expected" - > "$work/diff" || ok=false
+    fi
+
+    if $ok; then
+        passed=$((passed + 1))
+    else
+        failed=$((failed + 1))
+        echo "FAIL: $name"
+        [ -s "$work/diff" ] && cat "$work/diff"
+        sed 's/^/  /' "$work/stderr"
+    fi
+    rm -f "$work/diff"
+done
+
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]